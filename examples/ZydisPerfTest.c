@@ -37,7 +37,14 @@
 #   include <windows.h>
 #elif defined(ZYAN_APPLE)
 #   include <mach/mach_time.h>
-#elif defined(ZYAN_LINUX) || defined(ZYAN_SOLARIS) || defined(ZYAN_HAIKU)
+#elif defined(ZYAN_LINUX)
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <sys/time.h>
+#   include <linux/perf_event.h>
+#   include <pthread.h>
+#   include <unistd.h>
+#elif defined(ZYAN_SOLARIS) || defined(ZYAN_HAIKU)
 #   include <sys/time.h>
 #   include <pthread.h>
 #elif defined(ZYAN_FREEBSD)
@@ -169,6 +176,86 @@ static double GetCounter(void)
 
 #endif
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Cache counters                                                                                 */
+/* ---------------------------------------------------------------------------------------------- */
+
+#if defined(ZYAN_LINUX)
+
+static int cache_counters[2] = { -1, -1 };
+
+static int OpenCacheCounter(ZyanU64 result, int group)
+{
+    struct perf_event_attr attr;
+    ZYAN_MEMSET(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (result << 16);
+    attr.disabled       = (group == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+/**
+ * Starts counting L1d read accesses and misses of the current thread.
+ *
+ * @return  `ZYAN_TRUE`, if the hardware counters are available or `ZYAN_FALSE`, if not (e.g. due
+ *          to `perf_event_paranoid` or when running in a VM).
+ */
+static ZyanBool StartCacheCounters(void)
+{
+    if (cache_counters[0] == -1)
+    {
+        cache_counters[0] = OpenCacheCounter(PERF_COUNT_HW_CACHE_RESULT_ACCESS, -1);
+        if (cache_counters[0] == -1)
+        {
+            return ZYAN_FALSE;
+        }
+        cache_counters[1] = OpenCacheCounter(PERF_COUNT_HW_CACHE_RESULT_MISS, cache_counters[0]);
+        if (cache_counters[1] == -1)
+        {
+            close(cache_counters[0]);
+            cache_counters[0] = -1;
+            return ZYAN_FALSE;
+        }
+    }
+
+    ioctl(cache_counters[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(cache_counters[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return ZYAN_TRUE;
+}
+
+static void GetCacheCounters(ZyanU64* accesses, ZyanU64* misses)
+{
+    ioctl(cache_counters[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    *accesses = 0;
+    *misses = 0;
+    if ((read(cache_counters[0], accesses, sizeof(*accesses)) != sizeof(*accesses)) ||
+        (read(cache_counters[1], misses, sizeof(*misses)) != sizeof(*misses)))
+    {
+        *accesses = 0;
+        *misses = 0;
+    }
+}
+
+#else
+
+static ZyanBool StartCacheCounters(void)
+{
+    return ZYAN_FALSE;
+}
+
+static void GetCacheCounters(ZyanU64* accesses, ZyanU64* misses)
+{
+    *accesses = 0;
+    *misses = 0;
+}
+
+#endif
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Process & Thread Priority                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
@@ -306,7 +393,7 @@ static ZyanU64 ProcessBuffer(const ZydisDecoder* decoder, const ZydisFormatter*
     return count;
 }
 
-static void TestPerformance(const ZyanU8* buffer, ZyanUSize length, ZyanBool minimal_mode,
+static double TestPerformance(const ZyanU8* buffer, ZyanUSize length, ZyanBool minimal_mode,
     ZyanBool format, ZyanBool tokenize, ZyanBool use_cache)
 {
     ZydisDecoder decoder;
@@ -356,12 +443,21 @@ static void TestPerformance(const ZyanU8* buffer, ZyanUSize length, ZyanBool min
     ProcessBuffer(&decoder, &formatter, &context, buffer, length);
 
     // Testing
+    ZydisDecoderResetStats();
     ZyanU64 count = 0;
+    const ZyanBool has_cache_counters = StartCacheCounters();
     StartCounter();
     for (ZyanU8 j = 0; j < 100; ++j)
     {
         count += ProcessBuffer(&decoder, &formatter, &context, buffer, length);
     }
+    const double time = GetCounter();
+    ZyanU64 l1d_accesses = 0;
+    ZyanU64 l1d_misses = 0;
+    if (has_cache_counters)
+    {
+        GetCacheCounters(&l1d_accesses, &l1d_misses);
+    }
     const char* color[4];
     color[0] = minimal_mode ? CVT100_OUT(COLOR_VALUE_G) : CVT100_OUT(COLOR_VALUE_B);
     color[1] = format       ? CVT100_OUT(COLOR_VALUE_G) : CVT100_OUT(COLOR_VALUE_B);
@@ -374,7 +470,131 @@ static void TestPerformance(const ZyanU8* buffer, ZyanUSize length, ZyanBool min
         color[2], tokenize, CVT100_OUT(COLOR_DEFAULT),
         color[3], use_cache, CVT100_OUT(COLOR_DEFAULT),
         CVT100_OUT(COLOR_VALUE_B), (double)count / 1000000, CVT100_OUT(COLOR_DEFAULT),
-        CVT100_OUT(COLOR_VALUE_G), GetCounter(), CVT100_OUT(COLOR_DEFAULT));
+        CVT100_OUT(COLOR_VALUE_G), time, CVT100_OUT(COLOR_DEFAULT));
+    if (has_cache_counters && count)
+    {
+        // Misses per 1000 decoded instructions. Compare this value across builds to evaluate the
+        // cache footprint of the decoder tables
+        ZYAN_PRINTF("    L1d accesses: %s%8.2fM%s, L1d misses: %s%8.2fK%s, MPKI: %s%6.3f%s\n",
+            CVT100_OUT(COLOR_VALUE_B), (double)l1d_accesses / 1000000, CVT100_OUT(COLOR_DEFAULT),
+            CVT100_OUT(COLOR_VALUE_B), (double)l1d_misses / 1000, CVT100_OUT(COLOR_DEFAULT),
+            CVT100_OUT(COLOR_VALUE_G), (double)l1d_misses * 1000 / count,
+            CVT100_OUT(COLOR_DEFAULT));
+    }
+
+    return time;
+}
+
+/**
+ * Prints the decoder statistics, if the library was built with `ZYDIS_DECODER_STATS`.
+ *
+ * Node types and errors that were never encountered are omitted.
+ */
+static void PrintDecoderStats(void)
+{
+    static const char* encoding_strings[] =
+    {
+        "LEGACY",
+        "3DNOW",
+        "XOP",
+        "VEX",
+        "EVEX",
+        "MVEX",
+        "REX2"
+    };
+    ZYAN_STATIC_ASSERT(
+        ZYAN_ARRAY_LENGTH(encoding_strings) == ZYDIS_INSTRUCTION_ENCODING_MAX_VALUE + 1);
+    static const char* error_strings[ZYDIS_DECODER_STATS_STATUS_CODE_COUNT] =
+    {
+        "NO_MORE_DATA",
+        "DECODING_ERROR",
+        "INSTRUCTION_TOO_LONG",
+        "BAD_REGISTER",
+        "ILLEGAL_LOCK",
+        "ILLEGAL_LEGACY_PFX",
+        "ILLEGAL_REX",
+        "ILLEGAL_REX2",
+        "INVALID_MAP",
+        "MALFORMED_EVEX",
+        "MALFORMED_MVEX",
+        "INVALID_MASK",
+        "SKIP_TOKEN",
+        "IMPOSSIBLE_INSTRUCTION"
+    };
+
+    ZydisDecoderStats stats;
+    if (!ZYAN_SUCCESS(ZydisDecoderGetStats(&stats)))
+    {
+        return;
+    }
+
+    ZyanU64 attempts = 0;
+    ZyanU64 path_length = 0;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.path_length_count); ++i)
+    {
+        attempts += stats.path_length_count[i];
+        path_length += stats.path_length_count[i] * i;
+    }
+    if (!attempts)
+    {
+        return;
+    }
+    ZyanU64 nodes = 0;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.node_count); ++i)
+    {
+        nodes += stats.node_count[i];
+    }
+
+    ZYAN_PRINTF("    Decode attempts: %s%" PRIu64 "%s, Nodes: %s%" PRIu64 "%s, " \
+        "Avg. path length: %s%5.2f%s\n",
+        CVT100_OUT(COLOR_VALUE_B), attempts, CVT100_OUT(COLOR_DEFAULT),
+        CVT100_OUT(COLOR_VALUE_B), nodes, CVT100_OUT(COLOR_DEFAULT),
+        CVT100_OUT(COLOR_VALUE_G), (double)path_length / attempts, CVT100_OUT(COLOR_DEFAULT));
+
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.node_count); ++i)
+    {
+        const char* name = ZydisDecoderStatsGetNodeTypeString((ZyanU8)i);
+        if (!stats.node_count[i] || !name)
+        {
+            continue;
+        }
+        ZYAN_PRINTF("    Node %-20s %14" PRIu64 " %7.3f%%\n", name, stats.node_count[i],
+            (double)stats.node_count[i] * 100 / nodes);
+    }
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.path_length_count); ++i)
+    {
+        if (!stats.path_length_count[i])
+        {
+            continue;
+        }
+        ZYAN_PRINTF("    Path length %2d%-11s %14" PRIu64 " %7.3f%%\n", (int)i,
+            (i == ZYAN_ARRAY_LENGTH(stats.path_length_count) - 1) ? "+" : "",
+            stats.path_length_count[i], (double)stats.path_length_count[i] * 100 / attempts);
+    }
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.encoding_count); ++i)
+    {
+        if (!stats.encoding_count[i])
+        {
+            continue;
+        }
+        ZYAN_PRINTF("    Encoding %-16s %14" PRIu64 " %7.3f%%\n", encoding_strings[i],
+            stats.encoding_count[i], (double)stats.encoding_count[i] * 100 / attempts);
+    }
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(stats.error_count); ++i)
+    {
+        if (!stats.error_count[i])
+        {
+            continue;
+        }
+        ZYAN_PRINTF("    Error %-19s %14" PRIu64 " %7.3f%%\n",
+            error_strings[i] ? error_strings[i] : "UNKNOWN", stats.error_count[i],
+            (double)stats.error_count[i] * 100 / attempts);
+    }
+    if (stats.other_error_count)
+    {
+        ZYAN_PRINTF("    Error %-19s %14" PRIu64 " %7.3f%%\n", "OTHER",
+            stats.other_error_count, (double)stats.other_error_count * 100 / attempts);
+    }
 }
 
 static void GenerateTestData(FILE* file, TestEncoding encoding)
@@ -478,6 +698,66 @@ static void GenerateTestData(FILE* file, TestEncoding encoding)
     }
 }
 
+/**
+ * Prints the instruction frequency profile of the given raw code buffer.
+ *
+ * The buffer is linearly decoded in 64-bit mode. Undecodable bytes are skipped. The output lists
+ * all encountered mnemonics ordered by frequency. The counts are per mnemonic, not per instruction
+ * definition, so all encodings of a mnemonic (e.g. the `MOV` forms) are summed up.
+ */
+static void ProfileBuffer(const ZyanU8* buffer, ZyanUSize length)
+{
+    ZydisDecoder decoder;
+    if (!ZYAN_SUCCESS(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_FPRINTF(ZYAN_STDERR, "%sFailed to initialize decoder%s\n",
+            CVT100_ERR(COLOR_ERROR), CVT100_ERR(ZYAN_VT100SGR_RESET));
+        exit(EXIT_FAILURE);
+    }
+
+    static ZyanU64 counts[ZYDIS_MNEMONIC_MAX_VALUE + 1];
+    ZyanU64 total = 0;
+
+    ZydisDecodedInstruction instruction;
+    ZyanUSize offset = 0;
+    while (offset < length)
+    {
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(&decoder, ZYAN_NULL, buffer + offset,
+            length - offset, &instruction)))
+        {
+            ++offset;
+            continue;
+        }
+        ++counts[instruction.mnemonic];
+        ++total;
+        offset += instruction.length;
+    }
+
+    ZYAN_PRINTF("%-20s %12s %8s %8s\n", "Mnemonic", "Count", "Share", "Total");
+    ZyanU64 cumulative = 0;
+    while (total)
+    {
+        ZydisMnemonic best = ZYDIS_MNEMONIC_INVALID;
+        for (ZyanUSize i = 1; i < ZYAN_ARRAY_LENGTH(counts); ++i)
+        {
+            if (counts[i] > counts[best])
+            {
+                best = (ZydisMnemonic)i;
+            }
+        }
+        if (!counts[best])
+        {
+            break;
+        }
+
+        cumulative += counts[best];
+        ZYAN_PRINTF("%-20s %12" PRIu64 " %7.3f%% %7.3f%%\n", ZydisMnemonicGetString(best),
+            counts[best], (double)counts[best] * 100 / total, (double)cumulative * 100 / total);
+        counts[best] = 0;
+    }
+}
+
 /* ============================================================================================== */
 /* Entry point                                                                                    */
 /* ============================================================================================== */
@@ -497,14 +777,47 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    if (argc < 3 || (ZYAN_STRCMP(argv[1], "-test") && ZYAN_STRCMP(argv[1], "-generate")))
+    if (argc < 3 || (ZYAN_STRCMP(argv[1], "-test") && ZYAN_STRCMP(argv[1], "-generate") &&
+        ZYAN_STRCMP(argv[1], "-profile")))
     {
-        ZYAN_FPRINTF(ZYAN_STDERR, "%sUsage: %s -[test|generate] [directory]%s\n",
+        ZYAN_FPRINTF(ZYAN_STDERR, "%sUsage: %s -[test|generate] [directory]\n"
+            "       %s -profile [file]%s\n",
             CVT100_ERR(COLOR_ERROR), (argc > 0 ? argv[0] : "PerfTest"),
-            CVT100_ERR(ZYAN_VT100SGR_RESET));
+            (argc > 0 ? argv[0] : "PerfTest"), CVT100_ERR(ZYAN_VT100SGR_RESET));
         return EXIT_FAILURE;
     }
 
+    if (!ZYAN_STRCMP(argv[1], "-profile"))
+    {
+        FILE* file = fopen(argv[2], "rb");
+        if (!file)
+        {
+            ZYAN_FPRINTF(ZYAN_STDERR, "%sCould not open file \"%s\": %s%s\n",
+                CVT100_ERR(COLOR_ERROR), argv[2], strerror(ZYAN_ERRNO),
+                CVT100_ERR(ZYAN_VT100SGR_RESET));
+            return EXIT_FAILURE;
+        }
+        fseek(file, 0L, SEEK_END);
+        const long length = ftell(file);
+        void* buffer = (length > 0) ? malloc(length) : ZYAN_NULL;
+        rewind(file);
+        if (!buffer || (fread(buffer, 1, length, file) != (ZyanUSize)length))
+        {
+            ZYAN_FPRINTF(ZYAN_STDERR, "%sCould not read file \"%s\"%s\n",
+                CVT100_ERR(COLOR_ERROR), argv[2], CVT100_ERR(ZYAN_VT100SGR_RESET));
+            free(buffer);
+            fclose(file);
+            return EXIT_FAILURE;
+        }
+        fclose(file);
+
+        ZydisDecoderResetStats();
+        ProfileBuffer(buffer, length);
+        PrintDecoderStats();
+        free(buffer);
+        return 0;
+    }
+
     ZyanBool generate = ZYAN_FALSE;
     if (!ZYAN_STRCMP(argv[1], "-generate"))
     {
@@ -535,6 +848,16 @@ int main(int argc, char** argv)
     } else
     {
         AdjustProcessAndThreadPriority();
+
+        // Compare the output of builds with and without `ZYDIS_FEATURE_LEGACY_MODES` to measure
+        // the benefit of the 64-bit specialized decoder
+        ZYAN_PRINTF("Machine modes: %s%s%s\n\n", CVT100_OUT(COLOR_VALUE_B),
+#ifdef ZYDIS_DISABLE_LEGACY_MODES
+            "LONG_64 only (specialized)",
+#else
+            "all",
+#endif
+            CVT100_OUT(COLOR_DEFAULT));
     }
 
     for (ZyanU8 i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
@@ -590,8 +913,14 @@ int main(int argc, char** argv)
             ZYAN_PRINTF("%sTesting %s%s%s ...\n", CVT100_OUT(ZYAN_VT100SGR_FG_MAGENTA),
                 CVT100_OUT(ZYAN_VT100SGR_FG_BRIGHT_MAGENTA), tests[i].encoding_name,
                 CVT100_OUT(COLOR_DEFAULT));
-            TestPerformance(buffer, length, ZYAN_TRUE , ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE);
-            TestPerformance(buffer, length, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE);
+            const double time_minimal =
+                TestPerformance(buffer, length, ZYAN_TRUE , ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE);
+            const double time_full =
+                TestPerformance(buffer, length, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE);
+            PrintDecoderStats();
+            // The difference between both runs is dominated by `ZydisDecoderDecodeOperands`
+            ZYAN_PRINTF("Operand decoding: %s%8.2f%s msec\n",
+                CVT100_OUT(COLOR_VALUE_G), time_full - time_minimal, CVT100_OUT(COLOR_DEFAULT));
             // TestPerformance(buffer, length, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE, ZYAN_TRUE);
             TestPerformance(buffer, length, ZYAN_FALSE, ZYAN_TRUE , ZYAN_FALSE, ZYAN_FALSE);
             // TestPerformance(buffer, length, ZYAN_FALSE, ZYAN_TRUE , ZYAN_FALSE, ZYAN_TRUE);
@@ -0,0 +1,323 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for recursive-descent disassembly and control-flow graph recovery.
+ */
+
+#ifndef ZYDIS_CONTROL_FLOW_H
+#define ZYDIS_CONTROL_FLOW_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup control_flow Control flow
+ * Functions for recursive-descent disassembly and control-flow graph recovery.
+ *
+ * Recovery works in two phases. `ZydisCfgExplore` follows all statically known branch targets
+ * starting at the registered entry points and records instruction starts and block leaders in two
+ * bitmaps. `ZydisCfgBuild` then performs a single pass over the bitmaps, emitting basic blocks in
+ * ascending address order together with their outgoing edges.
+ *
+ * All memory is provided by the caller: the bitmaps require `ZydisCfgGetWorkspaceSize` bytes
+ * (a quarter of the size of the analyzed code) and blocks and edges are written to flat arrays.
+ * No global state is used, so independent functions (or code regions) can be explored by separate
+ * `ZydisCfg` instances on multiple threads concurrently, sharing the same `ZydisDecoder`.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The number of entries in the internal worklist. Targets not fitting into the worklist are
+ * rediscovered from the leader bitmap, so this only affects performance, not correctness.
+ */
+#define ZYDIS_CFG_WORKLIST_SIZE 256
+
+/**
+ * Marks an edge without a target block (e.g. indirect branches, returns or targets outside of the
+ * analyzed code).
+ */
+#define ZYDIS_CFG_BLOCK_NONE 0xFFFFFFFF
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisCfgEdgeType` enum.
+ */
+typedef enum ZydisCfgEdgeType_
+{
+    /**
+     * Execution continues with the next instruction.
+     */
+    ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH,
+    /**
+     * A conditional or unconditional jump.
+     */
+    ZYDIS_CFG_EDGE_TYPE_JUMP,
+    /**
+     * A call. Blocks ending with a call additionally have a `FALLTHROUGH` edge to the return
+     * address.
+     */
+    ZYDIS_CFG_EDGE_TYPE_CALL,
+    /**
+     * A return.
+     */
+    ZYDIS_CFG_EDGE_TYPE_RETURN,
+
+    /**
+     * Maximum value of this enum.
+     */
+    ZYDIS_CFG_EDGE_TYPE_MAX_VALUE = ZYDIS_CFG_EDGE_TYPE_RETURN,
+    /**
+     * The minimum number of bits required to represent all values of this enum.
+     */
+    ZYDIS_CFG_EDGE_TYPE_REQUIRED_BITS = ZYAN_BITS_TO_REPRESENT(ZYDIS_CFG_EDGE_TYPE_MAX_VALUE)
+} ZydisCfgEdgeType;
+
+/**
+ * Defines the `ZydisCfgEdge` struct.
+ */
+typedef struct ZydisCfgEdge_
+{
+    /**
+     * The runtime address of the target. Only valid, if `is_indirect` is `ZYAN_FALSE` and the
+     * edge is not a `RETURN` edge.
+     */
+    ZyanU64 target_address;
+    /**
+     * The index of the target block or `ZYDIS_CFG_BLOCK_NONE`.
+     */
+    ZyanU32 target;
+    /**
+     * The edge type.
+     */
+    ZydisCfgEdgeType type;
+    /**
+     * `ZYAN_TRUE`, if the target is not statically known.
+     */
+    ZyanBool is_indirect;
+    /**
+     * `ZYAN_TRUE`, if the edge is only taken conditionally.
+     */
+    ZyanBool is_conditional;
+} ZydisCfgEdge;
+
+/**
+ * Defines the `ZydisCfgBlock` struct.
+ */
+typedef struct ZydisCfgBlock_
+{
+    /**
+     * The runtime address of the first instruction.
+     */
+    ZyanU64 address;
+    /**
+     * The length of the block, in bytes.
+     */
+    ZyanU32 length;
+    /**
+     * The number of instructions in the block.
+     */
+    ZyanU32 instruction_count;
+    /**
+     * The index of the first outgoing edge. The edges of a block are stored consecutively.
+     */
+    ZyanU32 first_edge;
+    /**
+     * The number of outgoing edges.
+     */
+    ZyanU32 edge_count;
+} ZydisCfgBlock;
+
+/**
+ * Defines the `ZydisCfg` struct.
+ *
+ * All fields in this struct should be considered as "private". Any changes may lead to unexpected
+ * behavior.
+ */
+typedef struct ZydisCfg_
+{
+    /**
+     * A pointer to the `ZydisDecoder` instance.
+     */
+    const ZydisDecoder* decoder;
+    /**
+     * A pointer to the analyzed code.
+     */
+    const ZyanU8* buffer;
+    /**
+     * The length of the analyzed code.
+     */
+    ZyanUSize length;
+    /**
+     * The runtime address of the first byte of the analyzed code.
+     */
+    ZyanU64 runtime_address;
+    /**
+     * A bitmap with one bit per byte marking the start of a basic block.
+     */
+    ZyanU8* leaders;
+    /**
+     * A bitmap with one bit per byte marking explored instruction starts.
+     */
+    ZyanU8* visited;
+    /**
+     * Signals whether call targets should be explored as well.
+     */
+    ZyanBool follow_calls;
+    /**
+     * Signals that leaders were dropped due to the worklist being full.
+     */
+    ZyanBool has_pending;
+    /**
+     * The lowest offset of a dropped leader.
+     */
+    ZyanUSize pending_offset;
+    /**
+     * The number of entries in the worklist.
+     */
+    ZyanUSize worklist_count;
+    /**
+     * The offsets of leaders that remain to be explored.
+     */
+    ZyanUSize worklist[ZYDIS_CFG_WORKLIST_SIZE];
+} ZydisCfg;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns the size of the workspace required to analyze code of the given length.
+ *
+ * @param   length  The length of the code to analyze.
+ *
+ * @return  The workspace size, in bytes.
+ */
+ZYDIS_EXPORT ZyanUSize ZydisCfgGetWorkspaceSize(ZyanUSize length);
+
+/**
+ * Initializes the given `ZydisCfg` instance.
+ *
+ * @param   cfg             A pointer to the `ZydisCfg` instance.
+ * @param   decoder         A pointer to the `ZydisDecoder` instance. Must stay valid for the
+ *                          lifetime of the `ZydisCfg` instance.
+ * @param   buffer          A pointer to the code to analyze.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   follow_calls    `ZYAN_TRUE` to explore call targets as well.
+ * @param   workspace       A pointer to a buffer of at least `ZydisCfgGetWorkspaceSize(length)`
+ *                          bytes.
+ * @param   workspace_size  The size of the workspace buffer.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCfgInit(ZydisCfg* cfg, const ZydisDecoder* decoder,
+    const void* buffer, ZyanUSize length, ZyanU64 runtime_address, ZyanBool follow_calls,
+    void* workspace, ZyanUSize workspace_size);
+
+/**
+ * Registers an entry point to start exploration at.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   address The runtime address of the entry point.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCfgAddEntryPoint(ZydisCfg* cfg, ZyanU64 address);
+
+/**
+ * Explores all code reachable from the registered entry points.
+ *
+ * @param   cfg A pointer to the `ZydisCfg` instance.
+ *
+ * @return  A zyan status code.
+ *
+ * Entry points can be added and this function can be called again at any time to extend the
+ * explored code (e.g. after resolving indirect branches).
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCfgExplore(ZydisCfg* cfg);
+
+/**
+ * Emits basic blocks and edges for the explored code.
+ *
+ * @param   cfg         A pointer to the `ZydisCfg` instance.
+ * @param   blocks      A pointer to the array receiving the basic blocks, sorted by address.
+ * @param   block_count A pointer to the variable containing the capacity of the `blocks` array.
+ *                      Receives the number of blocks.
+ * @param   edges       A pointer to the array receiving the edges.
+ * @param   edge_count  A pointer to the variable containing the capacity of the `edges` array.
+ *                      Receives the number of edges.
+ *
+ * @return  A zyan status code. If any of the arrays is too small,
+ *          `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE` is returned and `block_count` and `edge_count`
+ *          receive the required capacities.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCfgBuild(const ZydisCfg* cfg, ZydisCfgBlock* blocks,
+    ZyanUSize* block_count, ZydisCfgEdge* edges, ZyanUSize* edge_count);
+
+/**
+ * Finds the basic block containing the given address.
+ *
+ * @param   blocks      A pointer to the array of blocks emitted by `ZydisCfgBuild`.
+ * @param   block_count The number of blocks.
+ * @param   address     The runtime address.
+ * @param   index       Receives the index of the block.
+ *
+ * @return  A zyan status code. `ZYAN_STATUS_NOT_FOUND` is returned, if no block contains the
+ *          given address.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCfgFindBlock(const ZydisCfgBlock* blocks, ZyanUSize block_count,
+    ZyanU64 address, ZyanUSize* index);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_CONTROL_FLOW_H */
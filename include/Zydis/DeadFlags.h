@@ -0,0 +1,178 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for quickly determining whether CPU flags are dead at a given address.
+ */
+
+#ifndef ZYDIS_DEAD_FLAGS_H
+#define ZYDIS_DEAD_FLAGS_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup dead_flags Dead flags
+ * Functions for quickly determining whether CPU flags are dead at a given address.
+ *
+ * This is intended for instrumentation: if all flags clobbered by the inserted code are dead at
+ * the insertion point, saving and restoring them (e.g. using the very slow `PUSHF`/`POPF`
+ * sequence) can be omitted.
+ *
+ * The analysis scans forward over straight-line code, starting at the given address, using the
+ * accessed flags information of each instruction. A flag is dead, if it is overwritten before
+ * being tested. Shifts and rotates by `CL` (or by an immediate count of zero) are not treated as
+ * overwriting any flags, as they leave all flags unchanged for a count of zero. The scan stops at
+ * the first branch, call, return or interrupt, at undecodable instructions, after a configurable
+ * number of instructions or as soon as the state of every flag is known. Flags whose state is still unknown at that point are conservatively reported as live.
+ *
+ * Results are cached per address in a small direct-mapped cache. A scan reaching an address with
+ * a cached result stops early and merges the cached result.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The number of entries in the result cache. Must be a power of two.
+ */
+#define ZYDIS_DEAD_FLAGS_CACHE_SIZE 256
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisDeadFlagsCacheEntry` struct.
+ */
+typedef struct ZydisDeadFlagsCacheEntry_
+{
+    /**
+     * The runtime address.
+     */
+    ZyanU64 address;
+    /**
+     * The dead CPU flags at the address.
+     */
+    ZydisAccessedFlagsMask dead;
+    /**
+     * Signals whether the entry is valid.
+     */
+    ZyanBool is_valid;
+} ZydisDeadFlagsCacheEntry;
+
+/**
+ * Defines the `ZydisDeadFlagsAnalyzer` struct.
+ *
+ * All fields in this struct should be considered as "private". Any changes may lead to unexpected
+ * behavior.
+ */
+typedef struct ZydisDeadFlagsAnalyzer_
+{
+    /**
+     * A pointer to the `ZydisDecoder` instance.
+     */
+    const ZydisDecoder* decoder;
+    /**
+     * The maximum number of instructions to scan.
+     */
+    ZyanUSize window;
+    /**
+     * The result cache.
+     */
+    ZydisDeadFlagsCacheEntry cache[ZYDIS_DEAD_FLAGS_CACHE_SIZE];
+} ZydisDeadFlagsAnalyzer;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Initializes the given `ZydisDeadFlagsAnalyzer` instance.
+ *
+ * @param   analyzer    A pointer to the `ZydisDeadFlagsAnalyzer` instance.
+ * @param   decoder     A pointer to the `ZydisDecoder` instance. Must stay valid for the lifetime
+ *                      of the `ZydisDeadFlagsAnalyzer` instance.
+ * @param   window      The maximum number of instructions to scan per query.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDeadFlagsAnalyzerInit(ZydisDeadFlagsAnalyzer* analyzer,
+    const ZydisDecoder* decoder, ZyanUSize window);
+
+/**
+ * Invalidates all cached results.
+ *
+ * @param   analyzer    A pointer to the `ZydisDeadFlagsAnalyzer` instance.
+ *
+ * @return  A zyan status code.
+ *
+ * This function must be called after modifying code that was previously analyzed.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDeadFlagsAnalyzerReset(ZydisDeadFlagsAnalyzer* analyzer);
+
+/**
+ * Determines the CPU flags that are dead at the given address.
+ *
+ * @param   analyzer        A pointer to the `ZydisDeadFlagsAnalyzer` instance.
+ * @param   buffer          A pointer to the code starting at `runtime_address`.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   dead_flags      Receives the dead CPU flags (a combination of `ZYDIS_CPUFLAG_*`
+ *                          values).
+ *
+ * @return  A zyan status code.
+ *
+ * To check whether a set of flags can be clobbered, test `(*dead_flags & mask) == mask`.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDeadFlagsQuery(ZydisDeadFlagsAnalyzer* analyzer,
+    const void* buffer, ZyanUSize length, ZyanU64 runtime_address,
+    ZydisAccessedFlagsMask* dead_flags);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_DEAD_FLAGS_H */
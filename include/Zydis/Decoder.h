@@ -41,6 +41,42 @@
 extern "C" {
 #endif
 
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The minimum input length that enables the padded fast paths of the decoder.
+ *
+ * This covers an 8-byte load at any position inside of an instruction of maximum length, as well
+ * as the 16-byte vector load used to classify the prefixes. Callers decoding from large buffers
+ * can pad the end of the buffer with this many bytes, so that every instruction is decoded without
+ * per-byte end-of-input handling.
+ */
+#define ZYDIS_DECODER_PADDED_LENGTH 24
+
+/**
+ * The number of decoder tree node types tracked by `ZydisDecoderStats`.
+ */
+#define ZYDIS_DECODER_STATS_NODE_TYPE_COUNT     40
+
+/**
+ * The number of decoder tree path lengths tracked by `ZydisDecoderStats`. Longer paths are
+ * accumulated in the last entry.
+ */
+#define ZYDIS_DECODER_STATS_PATH_LENGTH_COUNT   32
+
+/**
+ * The number of `ZYAN_MODULE_ZYDIS` status codes tracked by `ZydisDecoderStats`.
+ */
+#define ZYDIS_DECODER_STATS_STATUS_CODE_COUNT   16
+
+/* ---------------------------------------------------------------------------------------------- */
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
@@ -177,6 +213,50 @@ typedef enum ZydisDecoderMode_
     ZYDIS_DECODER_MODE_REQUIRED_BITS = ZYAN_BITS_TO_REPRESENT(ZYDIS_DECODER_MODE_MAX_VALUE)
 } ZydisDecoderMode;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Operand match                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Defines the `ZydisOperandMatch` data-type.
+ *
+ * Used by `ZydisDecoderFindOperand` to select operands by type, without decoding the other
+ * operands of the instruction.
+ */
+typedef ZyanU8 ZydisOperandMatch;
+
+/**
+ * Matches register operands.
+ */
+#define ZYDIS_OPERAND_MATCH_REGISTER    (1 <<  0)
+/**
+ * Matches memory operands (including `AGEN`, `MIB` and `VSIB` operands).
+ */
+#define ZYDIS_OPERAND_MATCH_MEMORY      (1 <<  1)
+/**
+ * Matches far pointer operands.
+ */
+#define ZYDIS_OPERAND_MATCH_POINTER     (1 <<  2)
+/**
+ * Matches immediate operands that are not relative to the instruction pointer.
+ */
+#define ZYDIS_OPERAND_MATCH_IMMEDIATE   (1 <<  3)
+/**
+ * Matches relative immediate operands (e.g. branch targets).
+ */
+#define ZYDIS_OPERAND_MATCH_RELATIVE    (1 <<  4)
+/**
+ * Only matches explicit operands.
+ */
+#define ZYDIS_OPERAND_MATCH_EXPLICIT    (1 <<  5)
+
+/**
+ * Matches all operand types.
+ */
+#define ZYDIS_OPERAND_MATCH_ANY \
+    (ZYDIS_OPERAND_MATCH_REGISTER | ZYDIS_OPERAND_MATCH_MEMORY | ZYDIS_OPERAND_MATCH_POINTER | \
+     ZYDIS_OPERAND_MATCH_IMMEDIATE | ZYDIS_OPERAND_MATCH_RELATIVE)
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Decoder struct                                                                                 */
 /* ---------------------------------------------------------------------------------------------- */
@@ -203,6 +283,43 @@ typedef struct ZydisDecoder_
     ZyanU32 decoder_mode;
 } ZydisDecoder;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Decoder statistics                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Defines the `ZydisDecoderStats` struct.
+ *
+ * The counters are only collected, if the library was built with `ZYDIS_DECODER_STATS`. They are
+ * global to the process and not synchronized, so concurrent decoding leads to inexact results.
+ */
+typedef struct ZydisDecoderStats_
+{
+    /**
+     * The number of visited decoder tree nodes, indexed by the (internal) node type. Use
+     * `ZydisDecoderStatsGetNodeTypeString` to obtain the name of a node type.
+     */
+    ZyanU64 node_count[ZYDIS_DECODER_STATS_NODE_TYPE_COUNT];
+    /**
+     * The number of decode attempts, indexed by the number of decoder tree nodes visited while
+     * decoding the instruction.
+     */
+    ZyanU64 path_length_count[ZYDIS_DECODER_STATS_PATH_LENGTH_COUNT];
+    /**
+     * The number of successfully decoded instructions, indexed by `ZydisInstructionEncoding`.
+     */
+    ZyanU64 encoding_count[ZYDIS_INSTRUCTION_ENCODING_MAX_VALUE + 1];
+    /**
+     * The number of failed decode attempts, indexed by the code of the `ZYAN_MODULE_ZYDIS`
+     * status (e.g. `ZYAN_STATUS_CODE(ZYDIS_STATUS_DECODING_ERROR)`).
+     */
+    ZyanU64 error_count[ZYDIS_DECODER_STATS_STATUS_CODE_COUNT];
+    /**
+     * The number of failed decode attempts with a status from a different module.
+     */
+    ZyanU64 other_error_count;
+} ZydisDecoderStats;
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -286,6 +403,10 @@ ZYDIS_EXPORT ZyanStatus ZydisDecoderDecodeFull(const ZydisDecoder* decoder,
  * @param   instruction A pointer to the `ZydisDecodedInstruction` struct, that receives the
  *                      details about the decoded instruction.
  *
+ * If at least `ZYDIS_DECODER_PADDED_LENGTH` bytes are available, the prefixes are classified with
+ * a single unaligned vector load (on supported hosts) and displacement and immediate values are
+ * read with single unaligned 8-byte loads. Shorter buffer tails are decoded with checked reads.
+ *
  * @return  A zyan status code.
  */
 ZYDIS_EXPORT ZyanStatus ZydisDecoderDecodeInstruction(const ZydisDecoder* decoder,
@@ -322,6 +443,80 @@ ZYDIS_EXPORT ZyanStatus ZydisDecoderDecodeOperands(const ZydisDecoder* decoder,
     const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction,
     ZydisDecodedOperand* operands, ZyanU8 operand_count);
 
+/**
+ * Decodes a single instruction operand.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   index       The index of the operand to decode.
+ * @param   operand     A pointer to the `ZydisDecodedOperand` struct that receives the operand.
+ *
+ * The result is identical to the `index`th operand returned by `ZydisDecoderDecodeOperands`, but
+ * none of the other operands are decoded.
+ *
+ * This function fails, if `index` is not smaller than `instruction.operand_count`.
+ *
+ * This function is not available in MINIMAL_MODE.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDecoderDecodeOperand(const ZydisDecoder* decoder,
+    const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction, ZyanU8 index,
+    ZydisDecodedOperand* operand);
+
+/**
+ * Decodes the first instruction operand that matches the given operand types.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   match       A combination of `ZYDIS_OPERAND_MATCH_*` flags.
+ * @param   operand     A pointer to the `ZydisDecodedOperand` struct that receives the operand.
+ *                      The index of the operand is stored in the `id` field.
+ *
+ * Operand types are determined from the instruction definition, so operands that don't match are
+ * skipped without being decoded.
+ *
+ * This function is not available in MINIMAL_MODE.
+ *
+ * @return  A zyan status code. `ZYAN_STATUS_NOT_FOUND` is returned, if no operand matches.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDecoderFindOperand(const ZydisDecoder* decoder,
+    const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction,
+    ZydisOperandMatch match, ZydisDecodedOperand* operand);
+
+/**
+ * Returns the decoder statistics collected since the last call to `ZydisDecoderResetStats`.
+ *
+ * @param   stats   A pointer to the `ZydisDecoderStats` struct that receives the statistics.
+ *
+ * This function is only available, if the library was built with `ZYDIS_DECODER_STATS`.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDecoderGetStats(ZydisDecoderStats* stats);
+
+/**
+ * Resets all decoder statistics to zero.
+ *
+ * This function is only available, if the library was built with `ZYDIS_DECODER_STATS`.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisDecoderResetStats(void);
+
+/**
+ * Returns the name of the given decoder tree node type.
+ *
+ * @param   node_type   The node type (an index into `ZydisDecoderStats.node_count`).
+ *
+ * This function is only available, if the library was built with `ZYDIS_DECODER_STATS`.
+ *
+ * @return  The name of the node type or `ZYAN_NULL`, if an invalid value was passed.
+ */
+ZYDIS_EXPORT const char* ZydisDecoderStatsGetNodeTypeString(ZyanU8 node_type);
+
 /** @} */
 
 /* ============================================================================================== */
@@ -79,6 +79,30 @@ ZYAN_STATIC_ASSERT(ZYAN_BITS_TO_REPRESENT(ZYDIS_ENCODER_MAX_OPERANDS) == 3);
                                     ZYDIS_ATTRIB_HAS_SEGMENT_FS | \
                                     ZYDIS_ATTRIB_HAS_SEGMENT_GS)
 
+/**
+ * Maximum number of legacy prefixes an instruction may have after being lengthened by
+ * `ZydisEncoderLengthenInstruction`. Some microarchitectures decode instructions with more
+ * prefixes significantly slower.
+ */
+#define ZYDIS_ENCODER_MAX_PADDING_PREFIXES 4
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Re-encoding patch flags                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Replaces the displacement of the memory operand.
+ */
+#define ZYDIS_ENCODER_PATCH_DISPLACEMENT    0x01
+/**
+ * Replaces the value of the first non-relative immediate operand.
+ */
+#define ZYDIS_ENCODER_PATCH_IMMEDIATE       0x02
+/**
+ * Replaces the absolute target of the relative branch or `EIP`/`RIP`-relative memory operand.
+ */
+#define ZYDIS_ENCODER_PATCH_RELATIVE_TARGET 0x04
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -178,6 +202,37 @@ typedef enum ZydisOperandSizeHint_
         ZYAN_BITS_TO_REPRESENT(ZYDIS_OPERAND_SIZE_HINT_MAX_VALUE)
 } ZydisOperandSizeHint;
 
+/**
+ * Defines strategies used to pick one of multiple compatible instruction definitions.
+ */
+typedef enum ZydisEncoderSearchMode_
+{
+    /**
+     * Use the first compatible definition (in order of the encoder tables).
+     */
+    ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH,
+    /**
+     * Evaluate all compatible definitions and pick the one with the shortest encoding (e.g. by
+     * using compressed `disp8*N` displacements, `VEX` over `EVEX` or `REX2` over `EVEX`).
+     */
+    ZYDIS_ENCODER_SEARCH_MODE_SHORTEST,
+    /**
+     * Evaluate all compatible definitions and pick the one with the fewest prefix bytes (legacy,
+     * `REX`, `REX2`, `XOP`, `VEX`, `EVEX` and `MVEX`). Ties are resolved by encoded length.
+     */
+    ZYDIS_ENCODER_SEARCH_MODE_FEWEST_PREFIXES,
+
+    /**
+     * Maximum value of this enum.
+     */
+    ZYDIS_ENCODER_SEARCH_MODE_MAX_VALUE = ZYDIS_ENCODER_SEARCH_MODE_FEWEST_PREFIXES,
+    /**
+     * The minimum number of bits required to represent all values of this enum.
+     */
+    ZYDIS_ENCODER_SEARCH_MODE_REQUIRED_BITS =
+        ZYAN_BITS_TO_REPRESENT(ZYDIS_ENCODER_SEARCH_MODE_MAX_VALUE)
+} ZydisEncoderSearchMode;
+
 /**
  * Describes explicit or implicit instruction operand.
  */
@@ -396,8 +451,47 @@ typedef struct ZydisEncoderRequest_
          */
         ZyanBool eviction_hint;
     } mvex;
+    /**
+     * Optional strategy used to pick between multiple compatible instruction definitions. Use
+     * `ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH` for the (fastest) default behavior.
+     */
+    ZydisEncoderSearchMode search_mode;
 } ZydisEncoderRequest;
 
+/**
+ * Defines the `ZydisEncoderPatchFlags` data-type (combination of `ZYDIS_ENCODER_PATCH_*` flags).
+ */
+typedef ZyanU8 ZydisEncoderPatchFlags;
+
+/**
+ * Describes modifications applied by `ZydisEncoderReEncodeInstruction`.
+ */
+typedef struct ZydisEncoderPatch_
+{
+    /**
+     * A combination of `ZYDIS_ENCODER_PATCH_*` flags selecting the fields that should be applied.
+     */
+    ZydisEncoderPatchFlags flags;
+    /**
+     * The runtime address of the re-encoded instruction. Relative operands that are not replaced
+     * keep pointing to their original target, assuming the instruction was decoded at this
+     * address as well.
+     */
+    ZyanU64 runtime_address;
+    /**
+     * The new displacement value (as it appears in `ZydisDecodedOperandMem.disp.value`).
+     */
+    ZyanI64 displacement;
+    /**
+     * The new immediate value (as it appears in `ZydisDecodedOperandImm.value`).
+     */
+    ZyanI64 immediate;
+    /**
+     * The new absolute target address.
+     */
+    ZyanU64 target;
+} ZydisEncoderPatch;
+
 /* ============================================================================================== */
 /* Exported functions                                                                             */
 /* ============================================================================================== */
@@ -460,6 +554,37 @@ ZYDIS_EXPORT ZyanStatus ZydisEncoderDecodedInstructionToEncoderRequest(
     const ZydisDecodedInstruction* instruction, const ZydisDecodedOperand* operands,
     ZyanU8 operand_count_visible, ZydisEncoderRequest* request);
 
+/**
+ * Re-encodes a previously decoded instruction, optionally replacing its displacement, immediate
+ * or relative target.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct filled by
+ *                      `ZydisDecoderDecodeInstruction`.
+ * @param   patch       A pointer to the `ZydisEncoderPatch` struct or `ZYAN_NULL`, if the
+ *                      instruction should be re-encoded unmodified.
+ * @param   buffer      A pointer to the output buffer receiving encoded instruction.
+ * @param   length      A pointer to the variable containing length of the output buffer. Upon
+ *                      successful return this variable receives length of the encoded instruction.
+ *
+ * The instruction bytes are rebuilt from the `raw` fields of the decoded instruction and patched
+ * in place whenever the new values fit into the existing fields. Only if that's not possible (e.g.
+ * a branch target is out of range for `rel8`), the operands are decoded and the instruction is
+ * passed through the regular encoder, which might change its length.
+ *
+ * `EIP`/`RIP`-relative memory operands can only be modified by using
+ * `ZYDIS_ENCODER_PATCH_RELATIVE_TARGET`.
+ *
+ * `ZYDIS_ENCODER_PATCH_IMMEDIATE` never modifies the upper half of an immediate that encodes an
+ * `IS4` register operand. It fails for instructions without any other immediate (e.g.
+ * `VBLENDVPS`) and only replaces the lower 4 bits otherwise (e.g. `VPERMIL2PS`).
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisEncoderReEncodeInstruction(
+    const ZydisDecodedInstruction *instruction, const ZydisDecoderContext *context,
+    const ZydisEncoderPatch *patch, void *buffer, ZyanUSize *length);
+
 /**
  * Fills provided buffer with `NOP` instructions using longest possible multi-byte instructions.
  *
@@ -470,6 +595,64 @@ ZYDIS_EXPORT ZyanStatus ZydisEncoderDecodedInstructionToEncoderRequest(
  */
 ZYDIS_EXPORT ZyanStatus ZydisEncoderNopFill(void *buffer, ZyanUSize length);
 
+/**
+ * Fills provided buffer with `NOP` instructions using longest possible multi-byte instructions
+ * that do not cross the given boundary.
+ *
+ * @param   buffer          A pointer to the output buffer receiving encoded instructions.
+ * @param   length          Size of the output buffer.
+ * @param   runtime_address The runtime address of the first byte of the buffer.
+ * @param   boundary        The boundary no single `NOP` instruction should cross (e.g. `32` for
+ *                          the decoded ICache line size) or `0` to disable this restriction.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisEncoderNopFillEx(void *buffer, ZyanUSize length,
+    ZyanU64 runtime_address, ZyanU64 boundary);
+
+/**
+ * Emits `NOP` padding advancing the given address to the next multiple of `alignment`.
+ *
+ * @param   buffer          A pointer to the output buffer receiving encoded instructions.
+ * @param   length          A pointer to the variable containing length of the output buffer. Upon
+ *                          successful return this variable receives the number of padding bytes.
+ * @param   runtime_address The runtime address the padding starts at.
+ * @param   alignment       The requested alignment. Must be a power of two.
+ * @param   boundary        Passed to `ZydisEncoderNopFillEx`.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisEncoderNopAlign(void *buffer, ZyanUSize *length,
+    ZyanU64 runtime_address, ZyanU64 alignment, ZyanU64 boundary);
+
+/**
+ * Encodes a longer but semantically identical form of a previously decoded instruction. This can
+ * be used to align subsequent code by growing preceding instructions instead of inserting `NOP`s.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context         A pointer to the `ZydisDecoderContext` struct filled by
+ *                          `ZydisDecoderDecodeInstruction`.
+ * @param   extra_length    The exact number of bytes to add to the instruction.
+ * @param   buffer          A pointer to the output buffer receiving encoded instruction.
+ * @param   length          A pointer to the variable containing length of the output buffer. Upon
+ *                          successful return this variable receives length of the encoded
+ *                          instruction.
+ *
+ * The instruction is lengthened by widening its displacement (`disp8` to `disp32` or adding a
+ * zero displacement) and by adding redundant segment prefixes (up to a total of
+ * `ZYDIS_ENCODER_MAX_PADDING_PREFIXES` legacy prefixes). Branch instructions never receive
+ * additional prefixes, as segment prefixes have a special meaning for them. Immediates are never
+ * widened, as this would require a different opcode. The displacement of `RIP`-relative memory
+ * operands is reduced by `extra_length`, so the effective address stays the same. Instructions
+ * with relative immediates are never lengthened.
+ *
+ * @return  A zyan status code. `ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION` is returned, if the
+ *          instruction can't be lengthened by exactly `extra_length` bytes.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisEncoderLengthenInstruction(
+    const ZydisDecodedInstruction *instruction, const ZydisDecoderContext *context,
+    ZyanU8 extra_length, void *buffer, ZyanUSize *length);
+
 /** @} */
 
 /* ============================================================================================== */
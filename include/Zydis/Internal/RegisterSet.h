@@ -0,0 +1,193 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Provides internal, inlined and vectorized helper functions for the `ZydisRegisterSet`
+ * data-type.
+ *
+ * `SSE2` (or `AVX2`, if enabled at compile time) is used on x86 hosts. Other hosts and builds
+ * without libc (e.g. kernel-mode drivers, where vector registers must not be touched) fall back
+ * to scalar code.
+ */
+
+#ifndef ZYDIS_INTERNAL_REGISTER_SET_H
+#define ZYDIS_INTERNAL_REGISTER_SET_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Types.h>
+#include <Zydis/RegisterUsage.h>
+
+#if !defined(ZYAN_NO_LIBC) && (defined(ZYAN_X64) || defined(ZYAN_X86))
+#   if defined(__AVX2__)
+#       include <immintrin.h>
+#       define ZYDIS_REGISTER_SET_AVX2
+#   elif defined(__SSE2__) || defined(ZYAN_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#       include <emmintrin.h>
+#       define ZYDIS_REGISTER_SET_SSE2
+#   endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ZYAN_STATIC_ASSERT(ZYDIS_REGISTER_SET_BITS == 256);
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Calculates `result = a | b`.
+ *
+ * @param   result  A pointer to the `ZydisRegisterSet` receiving the result.
+ * @param   a       A pointer to the first `ZydisRegisterSet`.
+ * @param   b       A pointer to the second `ZydisRegisterSet`.
+ */
+ZYAN_INLINE void ZydisRegisterSetOr(ZydisRegisterSet* result, const ZydisRegisterSet* a,
+    const ZydisRegisterSet* b)
+{
+#if defined(ZYDIS_REGISTER_SET_AVX2)
+    _mm256_storeu_si256((__m256i*)result->bits, _mm256_or_si256(
+        _mm256_loadu_si256((const __m256i*)a->bits),
+        _mm256_loadu_si256((const __m256i*)b->bits)));
+#elif defined(ZYDIS_REGISTER_SET_SSE2)
+    _mm_storeu_si128((__m128i*)&result->bits[0], _mm_or_si128(
+        _mm_loadu_si128((const __m128i*)&a->bits[0]),
+        _mm_loadu_si128((const __m128i*)&b->bits[0])));
+    _mm_storeu_si128((__m128i*)&result->bits[2], _mm_or_si128(
+        _mm_loadu_si128((const __m128i*)&a->bits[2]),
+        _mm_loadu_si128((const __m128i*)&b->bits[2])));
+#else
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        result->bits[i] = a->bits[i] | b->bits[i];
+    }
+#endif
+}
+
+/**
+ * Calculates `result = a & ~b`.
+ *
+ * @param   result  A pointer to the `ZydisRegisterSet` receiving the result.
+ * @param   a       A pointer to the first `ZydisRegisterSet`.
+ * @param   b       A pointer to the second `ZydisRegisterSet`.
+ */
+ZYAN_INLINE void ZydisRegisterSetAndNot(ZydisRegisterSet* result, const ZydisRegisterSet* a,
+    const ZydisRegisterSet* b)
+{
+#if defined(ZYDIS_REGISTER_SET_AVX2)
+    _mm256_storeu_si256((__m256i*)result->bits, _mm256_andnot_si256(
+        _mm256_loadu_si256((const __m256i*)b->bits),
+        _mm256_loadu_si256((const __m256i*)a->bits)));
+#elif defined(ZYDIS_REGISTER_SET_SSE2)
+    _mm_storeu_si128((__m128i*)&result->bits[0], _mm_andnot_si128(
+        _mm_loadu_si128((const __m128i*)&b->bits[0]),
+        _mm_loadu_si128((const __m128i*)&a->bits[0])));
+    _mm_storeu_si128((__m128i*)&result->bits[2], _mm_andnot_si128(
+        _mm_loadu_si128((const __m128i*)&b->bits[2]),
+        _mm_loadu_si128((const __m128i*)&a->bits[2])));
+#else
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        result->bits[i] = a->bits[i] & ~b->bits[i];
+    }
+#endif
+}
+
+/**
+ * Calculates the liveness transfer function `result = use | (live & ~def)`.
+ *
+ * @param   result  A pointer to the `ZydisRegisterSet` receiving the result.
+ * @param   use     A pointer to the `ZydisRegisterSet` of used registers.
+ * @param   live    A pointer to the `ZydisRegisterSet` of live registers.
+ * @param   def     A pointer to the `ZydisRegisterSet` of defined registers.
+ */
+ZYAN_INLINE void ZydisRegisterSetTransfer(ZydisRegisterSet* result, const ZydisRegisterSet* use,
+    const ZydisRegisterSet* live, const ZydisRegisterSet* def)
+{
+#if defined(ZYDIS_REGISTER_SET_AVX2)
+    _mm256_storeu_si256((__m256i*)result->bits, _mm256_or_si256(
+        _mm256_loadu_si256((const __m256i*)use->bits), _mm256_andnot_si256(
+            _mm256_loadu_si256((const __m256i*)def->bits),
+            _mm256_loadu_si256((const __m256i*)live->bits))));
+#elif defined(ZYDIS_REGISTER_SET_SSE2)
+    _mm_storeu_si128((__m128i*)&result->bits[0], _mm_or_si128(
+        _mm_loadu_si128((const __m128i*)&use->bits[0]), _mm_andnot_si128(
+            _mm_loadu_si128((const __m128i*)&def->bits[0]),
+            _mm_loadu_si128((const __m128i*)&live->bits[0]))));
+    _mm_storeu_si128((__m128i*)&result->bits[2], _mm_or_si128(
+        _mm_loadu_si128((const __m128i*)&use->bits[2]), _mm_andnot_si128(
+            _mm_loadu_si128((const __m128i*)&def->bits[2]),
+            _mm_loadu_si128((const __m128i*)&live->bits[2]))));
+#else
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        result->bits[i] = use->bits[i] | (live->bits[i] & ~def->bits[i]);
+    }
+#endif
+}
+
+/**
+ * Compares two register sets.
+ *
+ * @param   a   A pointer to the first `ZydisRegisterSet`.
+ * @param   b   A pointer to the second `ZydisRegisterSet`.
+ *
+ * @return  `ZYAN_TRUE`, if both sets are equal or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZydisRegisterSetEquals(const ZydisRegisterSet* a,
+    const ZydisRegisterSet* b)
+{
+#if defined(ZYDIS_REGISTER_SET_AVX2)
+    const __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)a->bits),
+        _mm256_loadu_si256((const __m256i*)b->bits));
+    return _mm256_testz_si256(x, x) != 0;
+#elif defined(ZYDIS_REGISTER_SET_SSE2)
+    const __m128i x = _mm_or_si128(
+        _mm_xor_si128(_mm_loadu_si128((const __m128i*)&a->bits[0]),
+                      _mm_loadu_si128((const __m128i*)&b->bits[0])),
+        _mm_xor_si128(_mm_loadu_si128((const __m128i*)&a->bits[2]),
+                      _mm_loadu_si128((const __m128i*)&b->bits[2])));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) == 0xFFFF;
+#else
+    ZyanU64 x = 0;
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        x |= a->bits[i] ^ b->bits[i];
+    }
+    return x == 0;
+#endif
+}
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZYDIS_INTERNAL_REGISTER_SET_H
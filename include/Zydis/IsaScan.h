@@ -0,0 +1,292 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for collecting the ISA requirements of large code buffers.
+ */
+
+#ifndef ZYDIS_ISA_SCAN_H
+#define ZYDIS_ISA_SCAN_H
+
+#include <Zycore/Types.h>
+#include <Zydis/ControlFlow.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup isa_scan ISA scan
+ * Functions for collecting the ISA requirements of large code buffers.
+ *
+ * The scanner aggregates the ISA set, ISA extension and encoding of all instructions into a
+ * histogram that additionally records the first address each entry was encountered at. Only
+ * `ZydisDecoderDecodeInstruction` is used, so the decoder should be put into
+ * `ZYDIS_DECODER_MODE_MINIMAL` for maximum throughput.
+ *
+ * Code can be scanned linearly, either in a single call (`ZydisIsaScanLinear`) or split into
+ * chunks that are scanned concurrently (`ZydisIsaScanLinearChunk`) and merged afterwards
+ * (`ZydisIsaScanMergeChunks`). Merging produces exactly the same result as a single linear scan:
+ * instructions at the start of each chunk are logged and replayed along the instruction stream
+ * of the preceding chunk until both streams synchronize. Alternatively, only the instructions
+ * discovered by a recursive-descent exploration can be scanned (`ZydisIsaScanExplored`).
+ *
+ * This module requires the decoder to run in full mode (`ZYDIS_MINIMAL_MODE` must not be defined
+ * at compile time), as instruction meta information is not available otherwise.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The number of bytes at the start of each chunk whose instructions are logged for
+ * synchronization with the preceding chunk.
+ */
+#define ZYDIS_ISA_SCAN_SYNC_WINDOW 64
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisIsaScanEntry` struct.
+ */
+typedef struct ZydisIsaScanEntry_
+{
+    /**
+     * The number of instructions.
+     */
+    ZyanU64 count;
+    /**
+     * The runtime address of the first instruction. Only valid, if `count` is not `0`.
+     */
+    ZyanU64 first_address;
+} ZydisIsaScanEntry;
+
+/**
+ * Defines the `ZydisIsaScanReport` struct.
+ */
+typedef struct ZydisIsaScanReport_
+{
+    /**
+     * The number of decoded instructions.
+     */
+    ZyanU64 instruction_count;
+    /**
+     * The number of skipped bytes that could not be decoded.
+     */
+    ZyanU64 invalid_count;
+    /**
+     * The histogram of ISA sets.
+     */
+    ZydisIsaScanEntry isa_set[ZYDIS_ISA_SET_MAX_VALUE + 1];
+    /**
+     * The histogram of ISA extensions.
+     */
+    ZydisIsaScanEntry isa_ext[ZYDIS_ISA_EXT_MAX_VALUE + 1];
+    /**
+     * The histogram of instruction encodings.
+     */
+    ZydisIsaScanEntry encoding[ZYDIS_INSTRUCTION_ENCODING_MAX_VALUE + 1];
+} ZydisIsaScanReport;
+
+/**
+ * Defines the `ZydisIsaScanSyncEntry` struct.
+ */
+typedef struct ZydisIsaScanSyncEntry_
+{
+    /**
+     * The offset of the instruction relative to the start of the chunk.
+     */
+    ZyanU8 offset;
+    /**
+     * The length of the instruction or `0`, if the byte could not be decoded.
+     */
+    ZyanU8 length;
+    /**
+     * The instruction encoding.
+     */
+    ZyanU8 encoding;
+    /**
+     * The ISA extension.
+     */
+    ZyanU8 isa_ext;
+    /**
+     * The ISA set.
+     */
+    ZyanU16 isa_set;
+} ZydisIsaScanSyncEntry;
+
+/**
+ * Defines the `ZydisIsaScanChunk` struct.
+ *
+ * All fields except `report` should be considered as "private". Any changes may lead to
+ * unexpected behavior.
+ */
+typedef struct ZydisIsaScanChunk_
+{
+    /**
+     * The offset of the first byte of the chunk.
+     */
+    ZyanUSize start;
+    /**
+     * The offset of the first byte after the chunk.
+     */
+    ZyanUSize end;
+    /**
+     * The offset of the first logged instruction, which is not part of `report`.
+     */
+    ZyanUSize sync_end;
+    /**
+     * The offset of the first instruction following the chunk.
+     */
+    ZyanUSize exit_offset;
+    /**
+     * The number of logged instructions.
+     */
+    ZyanUSize sync_count;
+    /**
+     * The instructions decoded from the first `ZYDIS_ISA_SCAN_SYNC_WINDOW` bytes of the chunk.
+     */
+    ZydisIsaScanSyncEntry sync[ZYDIS_ISA_SCAN_SYNC_WINDOW];
+    /**
+     * The histogram of all instructions following the logged ones.
+     */
+    ZydisIsaScanReport report;
+} ZydisIsaScanChunk;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Initializes the given `ZydisIsaScanReport` struct.
+ *
+ * @param   report  A pointer to the `ZydisIsaScanReport` struct.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanReportInit(ZydisIsaScanReport* report);
+
+/**
+ * Merges the given report into another one.
+ *
+ * @param   report  A pointer to the `ZydisIsaScanReport` struct receiving the merged result.
+ * @param   other   A pointer to the `ZydisIsaScanReport` struct to merge.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanReportMerge(ZydisIsaScanReport* report,
+    const ZydisIsaScanReport* other);
+
+/**
+ * Linearly scans the given code and adds all instructions to the report.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   report          A pointer to the `ZydisIsaScanReport` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * Undecodable bytes are counted in `invalid_count` and skipped.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanLinear(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZydisIsaScanReport* report);
+
+/**
+ * Linearly scans all instructions starting in the given chunk of the code.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the complete code.
+ * @param   length          The length of the complete code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   start           The offset of the first byte of the chunk.
+ * @param   end             The offset of the first byte after the chunk.
+ * @param   chunk           A pointer to the `ZydisIsaScanChunk` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * This function may be called concurrently for different chunks of the same code. The chunks
+ * must be adjacent and cover the complete code and are combined by `ZydisIsaScanMergeChunks`.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanLinearChunk(const ZydisDecoder* decoder,
+    const void* buffer, ZyanUSize length, ZyanU64 runtime_address, ZyanUSize start, ZyanUSize end,
+    ZydisIsaScanChunk* chunk);
+
+/**
+ * Combines the results of `ZydisIsaScanLinearChunk` into a single report.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the complete code.
+ * @param   length          The length of the complete code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   chunks          A pointer to the chunks, sorted by offset.
+ * @param   chunk_count     The number of chunks.
+ * @param   report          A pointer to the `ZydisIsaScanReport` struct receiving the result.
+ *
+ * @return  A zyan status code.
+ *
+ * The result is identical to the result of `ZydisIsaScanLinear` for the complete code. If the
+ * instruction stream of a chunk does not synchronize with the one of the preceding chunk, the
+ * affected chunk is rescanned.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanMergeChunks(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, const ZydisIsaScanChunk* chunks,
+    ZyanUSize chunk_count, ZydisIsaScanReport* report);
+
+/**
+ * Adds all instructions explored by the given `ZydisCfg` instance to the report.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   report  A pointer to the `ZydisIsaScanReport` struct.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisIsaScanExplored(const ZydisCfg* cfg, ZydisIsaScanReport* report);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_ISA_SCAN_H */
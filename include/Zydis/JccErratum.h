@@ -0,0 +1,158 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for detecting branches affected by the Intel `JCC` erratum.
+ */
+
+#ifndef ZYDIS_JCC_ERRATUM_H
+#define ZYDIS_JCC_ERRATUM_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup jcc_erratum JCC erratum
+ * Functions for detecting branches affected by the Intel `JCC` erratum.
+ *
+ * On affected microarchitectures, jumps (including macro-fused `CMP`/`TEST` + `Jcc` pairs) that
+ * cross or end on a 32-byte boundary are not cached in the decoded ICache, which can cause severe
+ * slowdowns in hot loops.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The boundary affected branches must not cross or end on.
+ */
+#define ZYDIS_JCC_ERRATUM_BOUNDARY 32
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Describes a single branch (or macro-fused instruction pair) affected by the `JCC` erratum.
+ */
+typedef struct ZydisJccErratumSite_
+{
+    /**
+     * The runtime address of the first byte of the affected instruction (pair).
+     */
+    ZyanU64 runtime_address;
+    /**
+     * The offset of the affected instruction (pair) relative to the start of the buffer.
+     */
+    ZyanUSize offset;
+    /**
+     * The mnemonic of the branch instruction.
+     */
+    ZydisMnemonic mnemonic;
+    /**
+     * The total length of the affected instruction (pair), in bytes.
+     */
+    ZyanU8 length;
+    /**
+     * `ZYAN_TRUE`, if the branch is macro-fused with the preceding instruction.
+     */
+    ZyanBool is_fused;
+    /**
+     * `ZYAN_TRUE`, if the instruction (pair) crosses the boundary or `ZYAN_FALSE`, if it ends
+     * on it.
+     */
+    ZyanBool crosses_boundary;
+    /**
+     * The minimum number of bytes that have to be inserted in front of the instruction (pair) to
+     * move it out of the way of the boundary.
+     *
+     * The padding can be emitted using `ZydisEncoderNopFillEx` or, preferably, by lengthening
+     * preceding instructions using `ZydisEncoderLengthenInstruction`.
+     */
+    ZyanU8 padding;
+} ZydisJccErratumSite;
+
+/**
+ * Defines the `ZydisJccErratumCallback` function prototype.
+ *
+ * @param   site        A pointer to the `ZydisJccErratumSite` struct.
+ * @param   user_data   The user data passed to `ZydisAnalyzeJccErratum`.
+ *
+ * @return  A zyan status code. Returning a failure status code aborts the analysis and the
+ *          status is passed back to the caller of `ZydisAnalyzeJccErratum`.
+ */
+typedef ZyanStatus (*ZydisJccErratumCallback)(const ZydisJccErratumSite* site, void* user_data);
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Decodes the given buffer using a linear sweep and reports all branches and macro-fused
+ * instruction pairs that cross or end on a `ZYDIS_JCC_ERRATUM_BOUNDARY` byte boundary.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code to analyze.
+ * @param   length          The length of the buffer.
+ * @param   runtime_address The runtime address of the first byte of the buffer.
+ * @param   callback        The callback invoked for each affected site.
+ * @param   user_data       A pointer to user-defined data passed to the callback. Can be
+ *                          `ZYAN_NULL`.
+ * @param   count           Receives the number of affected sites. Can be `ZYAN_NULL`.
+ *
+ * Only operand-less instruction decoding is performed, allowing the analysis to run at full
+ * decoder speed. Undecodable bytes are skipped one at a time.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisAnalyzeJccErratum(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZydisJccErratumCallback callback,
+    void* user_data, ZyanUSize* count);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_JCC_ERRATUM_H */
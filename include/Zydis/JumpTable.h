@@ -0,0 +1,186 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for recovering jump tables (e.g. compiled `switch` statements).
+ */
+
+#ifndef ZYDIS_JUMP_TABLE_H
+#define ZYDIS_JUMP_TABLE_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup jump_table Jump tables
+ * Functions for recovering jump tables (e.g. compiled `switch` statements).
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The maximum number of instructions preceding the indirect jump considered by the backward
+ * slice.
+ */
+#define ZYDIS_JUMP_TABLE_SLICE_SIZE 16
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisMemoryView` struct.
+ *
+ * Describes a contiguous, readable copy of the target's memory (e.g. a mapped image).
+ */
+typedef struct ZydisMemoryView_
+{
+    /**
+     * The runtime address of the first byte.
+     */
+    ZyanU64 address;
+    /**
+     * A pointer to the data.
+     */
+    const void* data;
+    /**
+     * The size of the data, in bytes.
+     */
+    ZyanUSize size;
+} ZydisMemoryView;
+
+/**
+ * Defines the `ZydisJumpTable` struct.
+ *
+ * The target of entry `i` is calculated as `base_address + table[i]`, with the entry being
+ * sign- or zero-extended, and truncated to `address_width` bits.
+ */
+typedef struct ZydisJumpTable_
+{
+    /**
+     * The runtime address of the first table entry.
+     */
+    ZyanU64 table_address;
+    /**
+     * The value added to each entry (`0` for tables containing absolute addresses).
+     */
+    ZyanU64 base_address;
+    /**
+     * The number of entries.
+     */
+    ZyanU32 entry_count;
+    /**
+     * The size of each entry, in bytes.
+     */
+    ZyanU8 entry_size;
+    /**
+     * `ZYAN_TRUE`, if entries are sign-extended.
+     */
+    ZyanBool is_signed;
+    /**
+     * The address width of the jump, in bits.
+     */
+    ZyanU8 address_width;
+} ZydisJumpTable;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Recovers the jump table used by an indirect jump.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code preceding the jump (e.g. the containing
+ *                          function or the predecessor blocks), including the jump itself.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   jump_address    The runtime address of the indirect jump.
+ * @param   memory          A pointer to the `ZydisMemoryView` struct used to resolve
+ *                          `RIP`-relative base values. Can be `ZYAN_NULL`.
+ * @param   table           Receives the jump table information.
+ *
+ * The code is decoded linearly from the start up to the jump, keeping the last
+ * `ZYDIS_JUMP_TABLE_SLICE_SIZE` instructions. Operands are only decoded for the instructions that
+ * are part of the backward slice. The following patterns are recognized:
+ * - `JMP [index * scale + table]` and `JMP [base + index * scale]`
+ * - `MOV reg, [base + index * scale + disp]` followed by `JMP reg`
+ * - `MOVSXD`/`MOV reg, [base + index * scale + disp]` and `ADD reg, base` followed by `JMP reg`
+ *   (position-independent tables relative to the table itself or to the image base)
+ *
+ * Base registers are resolved from `LEA reg, [RIP + disp]`, `LEA reg, [disp]` and `MOV reg, imm`
+ * instructions. The entry count is derived from a `CMP index, imm` followed by `JA`, `JAE`, `JBE`
+ * or `JB`, or from an `AND index, imm` mask.
+ *
+ * @return  A zyan status code. `ZYAN_STATUS_NOT_FOUND` is returned, if the jump does not match
+ *          any known pattern.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisRecoverJumpTable(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanU64 jump_address,
+    const ZydisMemoryView* memory, ZydisJumpTable* table);
+
+/**
+ * Reads the targets of the given jump table.
+ *
+ * @param   table   A pointer to the `ZydisJumpTable` struct.
+ * @param   memory  A pointer to the `ZydisMemoryView` struct containing the table.
+ * @param   targets A pointer to the array receiving the target addresses.
+ * @param   count   A pointer to the variable containing the capacity of the `targets` array.
+ *                  Receives the number of targets read.
+ *
+ * Reading stops at the end of the table, at the capacity of the `targets` array or at the end
+ * of the memory view, whichever comes first.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisGetJumpTableTargets(const ZydisJumpTable* table,
+    const ZydisMemoryView* memory, ZyanU64* targets, ZyanUSize* count);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_JUMP_TABLE_H */
@@ -0,0 +1,183 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for register and flag liveness analysis.
+ */
+
+#ifndef ZYDIS_LIVENESS_H
+#define ZYDIS_LIVENESS_H
+
+#include <Zycore/Types.h>
+#include <Zydis/ControlFlow.h>
+#include <Zydis/RegisterUsage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup liveness Liveness
+ * Functions for register and flag liveness analysis.
+ *
+ * Liveness is computed backwards on `ZydisRegisterSet` bitsets using the transfer function
+ * `live_before = use | (live_after & ~def)`. A register is considered defined only if it is fully
+ * overwritten, partial and conditional writes (e.g. `AL`, `CMOVcc`, legacy `SSE` destinations)
+ * keep it live. CPU and FPU flags are tracked individually.
+ *
+ * The bitset operations are vectorized (`SSE2` or `AVX2`) on x86 hosts, so a single transfer
+ * only takes a handful of instructions and the analysis is dominated by instruction decoding.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisLivenessOptions` struct.
+ */
+typedef struct ZydisLivenessOptions_
+{
+    /**
+     * The registers assumed to be live when leaving the analyzed code (e.g. at returns, indirect
+     * branches or branches to unknown targets).
+     */
+    ZydisRegisterSet exit_live;
+    /**
+     * The registers assumed to be read by called functions (e.g. argument registers of the
+     * calling convention).
+     */
+    ZydisRegisterSet call_use;
+    /**
+     * The registers assumed to be overwritten by called functions (e.g. caller-saved registers
+     * of the calling convention).
+     */
+    ZydisRegisterSet call_def;
+} ZydisLivenessOptions;
+
+/**
+ * Defines the `ZydisLivenessBlock` struct.
+ */
+typedef struct ZydisLivenessBlock_
+{
+    /**
+     * The registers read by the block before being defined.
+     */
+    ZydisRegisterSet use;
+    /**
+     * The registers fully overwritten by the block.
+     */
+    ZydisRegisterSet def;
+    /**
+     * The registers live at the start of the block.
+     */
+    ZydisRegisterSet live_in;
+    /**
+     * The registers live at the end of the block.
+     */
+    ZydisRegisterSet live_out;
+} ZydisLivenessBlock;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Determines the liveness transfer sets of the given instruction.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands        A pointer to the operands decoded by `ZydisDecoderDecodeOperands`.
+ *                          Hidden operands must be included to get complete results.
+ * @param   operand_count   The number of operands.
+ * @param   options         A pointer to the `ZydisLivenessOptions` struct.
+ * @param   use             Receives the registers read by the instruction.
+ * @param   def             Receives the registers fully overwritten by the instruction.
+ *
+ * @return  A zyan status code.
+ *
+ * For calls, `call_use` and `call_def` of the options are added to the respective sets.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisGetLivenessTransfer(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count,
+    const ZydisLivenessOptions* options, ZydisRegisterSet* use, ZydisRegisterSet* def);
+
+/**
+ * Computes the live registers before each instruction of straight-line code.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   buffer      A pointer to the code.
+ * @param   length      The length of the code.
+ * @param   options     A pointer to the `ZydisLivenessOptions` struct.
+ * @param   live_out    A pointer to the registers live after the last instruction.
+ * @param   live_before A pointer to the array receiving the live registers before each
+ *                      instruction.
+ * @param   count       A pointer to the variable containing the capacity of the `live_before`
+ *                      array. Receives the number of instructions.
+ *
+ * @return  A zyan status code. If the array is too small, `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE`
+ *          is returned and `count` receives the required capacity.
+ *
+ * Control flow is ignored, all instructions are assumed to be executed in order. Decoding stops
+ * at the first invalid instruction.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisComputeLinearLiveness(const ZydisDecoder* decoder,
+    const void* buffer, ZyanUSize length, const ZydisLivenessOptions* options,
+    const ZydisRegisterSet* live_out, ZydisRegisterSet* live_before, ZyanUSize* count);
+
+/**
+ * Computes the live registers at the start and end of each basic block of a control-flow graph.
+ *
+ * @param   cfg         A pointer to the `ZydisCfg` instance the graph was built from.
+ * @param   blocks      A pointer to the basic blocks returned by `ZydisCfgBuild`.
+ * @param   block_count The number of basic blocks.
+ * @param   edges       A pointer to the edges returned by `ZydisCfgBuild`.
+ * @param   edge_count  The number of edges.
+ * @param   options     A pointer to the `ZydisLivenessOptions` struct.
+ * @param   liveness    A pointer to an array of `block_count` elements receiving the liveness
+ *                      information of each block.
+ *
+ * @return  A zyan status code.
+ *
+ * Successors are determined by `FALLTHROUGH` and `JUMP` edges. Returns, indirect branches,
+ * branches leaving the analyzed code and blocks without outgoing edges use `exit_live`.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisComputeCfgLiveness(const ZydisCfg* cfg, const ZydisCfgBlock* blocks,
+    ZyanUSize block_count, const ZydisCfgEdge* edges, ZyanUSize edge_count,
+    const ZydisLivenessOptions* options, ZydisLivenessBlock* liveness);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_LIVENESS_H */
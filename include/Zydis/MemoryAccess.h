@@ -0,0 +1,322 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for enumerating the memory accesses of an instruction.
+ */
+
+#ifndef ZYDIS_MEMORY_ACCESS_H
+#define ZYDIS_MEMORY_ACCESS_H
+
+#include <Zycore/Defines.h>
+#include <Zydis/DecoderTypes.h>
+#include <Zydis/Register.h>
+#include <Zydis/Status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup memory_access Memory access
+ * Functions for enumerating the memory accesses of an instruction.
+ *
+ * Every access is described by a symbolic address expression
+ * (`segment:[base + index * scale + disp]`), its width and its read/write kind. Implicit accesses
+ * (e.g. the stack traffic of `PUSH`, `POP`, `CALL` and `RET` or the `[RSI]`/`[RDI]` accesses of
+ * string instructions) are included. The summary is computed from the decoded operands and does
+ * not allocate.
+ *
+ * `ZydisCalcMemoryAddresses` additionally evaluates the expressions for a concrete register
+ * snapshot, producing one linear address per access or per active `VSIB` lane.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The maximum number of memory accesses of a single instruction.
+ */
+#define ZYDIS_MAX_MEMORY_ACCESS_COUNT 4
+
+/**
+ * The maximum number of concrete addresses accessed by a single instruction (a `VSIB` access
+ * with 16 lanes).
+ */
+#define ZYDIS_MAX_MEMORY_ADDRESS_COUNT 16
+
+/**
+ * The size of a single register in the `vectors` array of `ZydisAddressContext`, in bytes.
+ */
+#define ZYDIS_ADDRESS_CONTEXT_VECTOR_SIZE 64
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Memory access flags                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Defines the `ZydisMemoryAccessFlags` data-type.
+ */
+typedef ZyanU16 ZydisMemoryAccessFlags;
+
+/**
+ * The memory is read.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_READ        (1 << 0)
+/**
+ * The memory is written.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_WRITE       (1 << 1)
+/**
+ * The access (or individual elements of it) only happens under certain conditions (e.g.
+ * `CMOVcc`, masked `AVX` and `AVX-512` loads and stores or gathers/scatters).
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL (1 << 2)
+/**
+ * The access is not encoded in an explicit operand.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT    (1 << 3)
+/**
+ * The access targets the stack. For pushing instructions, `disp` already accounts for the
+ * pre-decrement of the stack pointer, so the address is relative to the stack pointer value
+ * before execution.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_STACK       (1 << 4)
+/**
+ * The access is performed by a string instruction. The address advances by `size` bits
+ * after every iteration, in the direction given by `DF`.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_STRING      (1 << 5)
+/**
+ * The string instruction has a `REP`, `REPE` or `REPNE` prefix. The access is repeated up to
+ * `RCX` (`ECX`, `CX`) times.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_REPEATED    (1 << 6)
+/**
+ * The access uses a vector index (`VSIB`). Every element is accessed at a separate address,
+ * computed from the corresponding lane of `index`.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_VSIB        (1 << 7)
+/**
+ * The accessed elements are broadcast to all lanes of the destination.
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_BROADCAST   (1 << 8)
+/**
+ * The address is relative to the address of the next instruction (`base` is `RIP` or `EIP`).
+ */
+#define ZYDIS_MEMORY_ACCESS_FLAG_RELATIVE    (1 << 9)
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisMemoryAccess` struct.
+ */
+typedef struct ZydisMemoryAccess_
+{
+    /**
+     * The displacement of the address expression.
+     */
+    ZyanI64 disp;
+    /**
+     * The segment register.
+     */
+    ZydisRegister segment;
+    /**
+     * The base register or `ZYDIS_REGISTER_NONE`.
+     */
+    ZydisRegister base;
+    /**
+     * The index register or `ZYDIS_REGISTER_NONE`. This is a vector register for `VSIB` accesses.
+     */
+    ZydisRegister index;
+    /**
+     * The total number of accessed bits.
+     */
+    ZyanU16 size;
+    /**
+     * The size of a single element, in bits.
+     */
+    ZyanU16 element_size;
+    /**
+     * The number of accessed elements.
+     */
+    ZyanU16 element_count;
+    /**
+     * The access flags (`ZYDIS_MEMORY_ACCESS_FLAG_*`).
+     */
+    ZydisMemoryAccessFlags flags;
+    /**
+     * The scale factor of the index register.
+     */
+    ZyanU8 scale;
+    /**
+     * The index of the corresponding operand in the decoded operands array.
+     */
+    ZyanU8 operand_index;
+} ZydisMemoryAccess;
+
+/**
+ * Defines the `ZydisMemoryAccesses` struct.
+ */
+typedef struct ZydisMemoryAccesses_
+{
+    /**
+     * The number of memory accesses.
+     */
+    ZyanU8 count;
+    /**
+     * The memory accesses, in operand order.
+     */
+    ZydisMemoryAccess accesses[ZYDIS_MAX_MEMORY_ACCESS_COUNT];
+} ZydisMemoryAccesses;
+
+/**
+ * Defines the `ZydisAddressContext` struct.
+ */
+typedef struct ZydisAddressContext_
+{
+    /**
+     * A pointer to the general purpose and mask register values. The values are looked up by the
+     * exact register used in the address expression (e.g. `EAX` and `RAX` are separate
+     * entries), just like `ZydisCalcAbsoluteAddressEx` does.
+     */
+    const ZydisRegisterContext* registers;
+    /**
+     * The segment base addresses, indexed by `segment - ZYDIS_REGISTER_ES`. Only the `FS` and
+     * `GS` bases are used in 64-bit mode.
+     */
+    ZyanU64 segment_bases[6];
+    /**
+     * A pointer to the contents of the vector registers `ZMM0` to `ZMM31` (little-endian,
+     * `ZYDIS_ADDRESS_CONTEXT_VECTOR_SIZE` bytes per register) or `ZYAN_NULL`. Only required for
+     * `VSIB` accesses.
+     */
+    const ZyanU8* vectors;
+} ZydisAddressContext;
+
+/**
+ * Defines the `ZydisMemoryAddress` struct.
+ */
+typedef struct ZydisMemoryAddress_
+{
+    /**
+     * The linear address.
+     */
+    ZyanU64 address;
+    /**
+     * The number of accessed bits at this address.
+     */
+    ZyanU16 size;
+    /**
+     * The index of the corresponding entry in the `ZydisMemoryAccesses` struct.
+     */
+    ZyanU8 access_index;
+    /**
+     * The `VSIB` lane or `0` for regular accesses.
+     */
+    ZyanU8 element_index;
+} ZydisMemoryAddress;
+
+/**
+ * Defines the `ZydisMemoryAddresses` struct.
+ */
+typedef struct ZydisMemoryAddresses_
+{
+    /**
+     * The number of addresses.
+     */
+    ZyanU8 count;
+    /**
+     * The addresses, in access order.
+     */
+    ZydisMemoryAddress addresses[ZYDIS_MAX_MEMORY_ADDRESS_COUNT];
+} ZydisMemoryAddresses;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns all memory accesses of the given instruction.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands        A pointer to the operands array, including hidden operands.
+ * @param   operand_count   The length of the `operands` array.
+ * @param   accesses        Receives the memory accesses.
+ *
+ * @return  A zyan status code.
+ *
+ * Address generation (`LEA`), `MIB` operands (`BNDLDX`/`BNDSTX`) and prefetch hints do not access
+ * memory and are not reported.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisGetMemoryAccesses(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZydisMemoryAccesses* accesses);
+
+/**
+ * Calculates the linear addresses of all memory accesses of the given instruction.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands        A pointer to the operands array, including hidden operands.
+ * @param   operand_count   The length of the `operands` array.
+ * @param   runtime_address The runtime address of the instruction.
+ * @param   context         A pointer to the `ZydisAddressContext` struct.
+ * @param   accesses        Receives the symbolic memory accesses (see `ZydisGetMemoryAccesses`).
+ * @param   addresses       Receives the linear addresses.
+ *
+ * @return  A zyan status code.
+ *
+ * `VSIB` accesses produce one address per lane. Lanes disabled by the `AVX-512` opmask or the
+ * sign bits of the `AVX2` vector mask are skipped. String instructions produce the address of
+ * the current iteration. The instruction pointer from the register context is ignored in favor
+ * of `runtime_address`.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisCalcMemoryAddresses(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZyanU64 runtime_address,
+    const ZydisAddressContext* context, ZydisMemoryAccesses* accesses,
+    ZydisMemoryAddresses* addresses);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_MEMORY_ACCESS_H */
@@ -0,0 +1,201 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for retrieving static performance characteristics of instructions.
+ */
+
+#ifndef ZYDIS_PERF_INFO_H
+#define ZYDIS_PERF_INFO_H
+
+#include <Zycore/Types.h>
+#include <Zydis/DecoderTypes.h>
+#include <Zydis/Status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup perf_info Performance info
+ * Functions for retrieving static performance characteristics of instructions.
+ *
+ * The data is intended for cheap cost estimates (e.g. code layout decisions or choosing between
+ * code generation variants), not for cycle-exact simulation. Instructions are grouped into
+ * performance classes with similar characteristics. Instructions without a dedicated entry are
+ * assigned a class based on their category and are marked with `is_estimated`.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The maximum number of execution ports of all supported microarchitectures.
+ */
+#define ZYDIS_PERF_MAX_PORTS 16
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisMicroarchitecture` enum.
+ */
+typedef enum ZydisMicroarchitecture_
+{
+    /**
+     * Intel Skylake (client). Ports `0` to `7` map to bits `0` to `7`.
+     */
+    ZYDIS_MICROARCH_SKYLAKE,
+    /**
+     * Intel Ice Lake (Sunny Cove). Ports `0` to `9` map to bits `0` to `9`.
+     */
+    ZYDIS_MICROARCH_ICELAKE,
+    /**
+     * AMD Zen 4. The integer pipes `ALU0` to `ALU3` map to bits `0` to `3`, the address
+     * generation units `AGU0` to `AGU2` to bits `4` to `6` and the floating point pipes `FP0` to
+     * `FP3` to bits `7` to `10`.
+     */
+    ZYDIS_MICROARCH_ZEN4,
+
+    /**
+     * Maximum value of this enum.
+     */
+    ZYDIS_MICROARCH_MAX_VALUE = ZYDIS_MICROARCH_ZEN4,
+    /**
+     * The minimum number of bits required to represent all values of this enum.
+     */
+    ZYDIS_MICROARCH_REQUIRED_BITS = ZYAN_BITS_TO_REPRESENT(ZYDIS_MICROARCH_MAX_VALUE)
+} ZydisMicroarchitecture;
+
+/**
+ * Defines the `ZydisInstructionPerfInfo` struct.
+ */
+typedef struct ZydisInstructionPerfInfo_
+{
+    /**
+     * The number of fused-domain uops (macro-ops on AMD) issued by the front-end.
+     */
+    ZyanU8 uops;
+    /**
+     * The number of uops dispatched to the execution ports in `ports`. This describes the
+     * occupancy of the ports, e.g. an unpipelined divider is modeled by multiple uops.
+     */
+    ZyanU8 port_uops;
+    /**
+     * The latency from the register inputs to the outputs, in cycles.
+     */
+    ZyanU8 latency;
+    /**
+     * The additional latency of memory inputs, in cycles. `0`, if the instruction does not load
+     * from memory.
+     */
+    ZyanU8 load_latency;
+    /**
+     * The execution ports the uops can be dispatched to.
+     */
+    ZyanU16 ports;
+    /**
+     * The ports executing loads.
+     */
+    ZyanU16 load_ports;
+    /**
+     * The ports executing stores.
+     */
+    ZyanU16 store_ports;
+    /**
+     * Signals whether the instruction has an explicit memory operand.
+     */
+    ZyanBool has_memory_operand;
+    /**
+     * Signals whether the instruction implicitly loads from the stack (e.g. `POP`, `RET`).
+     */
+    ZyanBool is_stack_load;
+    /**
+     * Signals whether the instruction implicitly stores to the stack (e.g. `PUSH`, `CALL`).
+     */
+    ZyanBool is_stack_store;
+    /**
+     * Signals whether the values are derived from the instruction category instead of a
+     * dedicated entry.
+     */
+    ZyanBool is_estimated;
+} ZydisInstructionPerfInfo;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns the static performance characteristics of the given instruction.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   uarch       The microarchitecture.
+ * @param   info        Receives the performance characteristics.
+ *
+ * @return  A zyan status code.
+ *
+ * The instruction must be decoded in full mode, as the instruction attributes are required to
+ * detect memory operands. For memory operands, the values describe the load form (e.g.
+ * `ADD RAX, [RBX]`). Stores are not included and have to be accounted for using `store_ports`.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisGetInstructionPerfInfo(const ZydisDecodedInstruction* instruction,
+    ZydisMicroarchitecture uarch, ZydisInstructionPerfInfo* info);
+
+/**
+ * Checks if the given instruction pair is macro-fused into a single uop.
+ *
+ * @param   first   A pointer to the `ZydisDecodedInstruction` struct of the flag-producing
+ *                  instruction.
+ * @param   second  A pointer to the `ZydisDecodedInstruction` struct of the directly following
+ *                  conditional branch.
+ * @param   uarch   The microarchitecture.
+ *
+ * @return  `ZYAN_TRUE`, if the pair is macro-fused or `ZYAN_FALSE`, if not.
+ */
+ZYDIS_EXPORT ZyanBool ZydisIsMacroFusedPair(const ZydisDecodedInstruction* first,
+    const ZydisDecodedInstruction* second, ZydisMicroarchitecture uarch);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_PERF_INFO_H */
@@ -0,0 +1,158 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for extracting code references (`RIP`-relative memory operands and branch targets).
+ */
+
+#ifndef ZYDIS_REFERENCES_H
+#define ZYDIS_REFERENCES_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup references References
+ * Functions for extracting code references (`RIP`-relative memory operands and branch targets).
+ *
+ * The scanner only inspects the raw displacement and immediate fields of each instruction and
+ * never decodes operands. The decoder should be put into `ZYDIS_DECODER_MODE_MINIMAL` for
+ * maximum throughput. The resulting addresses are identical to the ones returned by
+ * `ZydisCalcAbsoluteAddress` for the corresponding operands.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisReferenceKind` enum.
+ */
+typedef enum ZydisReferenceKind_
+{
+    ZYDIS_REFERENCE_KIND_INVALID,
+    /**
+     * A `RIP`/`EIP`-relative memory operand (e.g. `MOV RAX, [RIP+0x12345678]` or `LEA`).
+     */
+    ZYDIS_REFERENCE_KIND_MEMORY,
+    /**
+     * The target of a relative `CALL`.
+     */
+    ZYDIS_REFERENCE_KIND_CALL,
+    /**
+     * The target of any other relative branch (e.g. `JMP`, `Jcc`, `LOOP`, `XBEGIN`).
+     */
+    ZYDIS_REFERENCE_KIND_BRANCH,
+
+    /**
+     * Maximum value of this enum.
+     */
+    ZYDIS_REFERENCE_KIND_MAX_VALUE = ZYDIS_REFERENCE_KIND_BRANCH,
+    /**
+     * The minimum number of bits required to represent all values of this enum.
+     */
+    ZYDIS_REFERENCE_KIND_REQUIRED_BITS = ZYAN_BITS_TO_REPRESENT(ZYDIS_REFERENCE_KIND_MAX_VALUE)
+} ZydisReferenceKind;
+
+/**
+ * Defines the `ZydisReference` struct.
+ */
+typedef struct ZydisReference_
+{
+    /**
+     * The offset of the referencing instruction relative to the start of the buffer.
+     */
+    ZyanUSize offset;
+    /**
+     * The absolute address of the referenced code or data.
+     */
+    ZyanU64 address;
+    /**
+     * The kind of the reference.
+     */
+    ZydisReferenceKind kind;
+    /**
+     * The length of the referencing instruction.
+     */
+    ZyanU8 length;
+    /**
+     * The offset of the displacement or immediate field relative to the start of the
+     * instruction.
+     */
+    ZyanU8 field_offset;
+    /**
+     * The size of the displacement or immediate field, in bits.
+     */
+    ZyanU8 field_size;
+} ZydisReference;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Extracts all `RIP`-relative memory references and direct branch targets from the given
+ * buffer by linear decoding.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code buffer.
+ * @param   length          The length of the code buffer.
+ * @param   runtime_address The runtime address of the first byte of the buffer.
+ * @param   offset          A pointer to the variable containing the offset to start scanning
+ *                          at. Receives the offset of the first instruction that was not
+ *                          scanned.
+ * @param   references      A pointer to the array receiving the references.
+ * @param   count           A pointer to the variable containing the capacity of the
+ *                          `references` array. Receives the number of references.
+ *
+ * Bytes that can not be decoded are skipped one at a time. Scanning stops at the end of the
+ * buffer or before the first instruction whose references don't fit into the `references`
+ * array anymore, so large buffers can be processed incrementally by calling this function until
+ * `offset` reaches `length`.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisScanReferences(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanUSize* offset, ZydisReference* references,
+    ZyanUSize* count);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_REFERENCES_H */
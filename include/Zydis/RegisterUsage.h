@@ -0,0 +1,211 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for determining the registers read and written by an instruction.
+ */
+
+#ifndef ZYDIS_REGISTER_USAGE_H
+#define ZYDIS_REGISTER_USAGE_H
+
+#include <Zycore/Types.h>
+#include <Zydis/DecoderTypes.h>
+#include <Zydis/Register.h>
+#include <Zydis/Status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup register_usage Register usage
+ * Functions for determining the registers read and written by an instruction.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The number of bits in a `ZydisRegisterSet`.
+ */
+#define ZYDIS_REGISTER_SET_BITS 256
+
+/**
+ * The number of 64-bit words in a `ZydisRegisterSet`.
+ */
+#define ZYDIS_REGISTER_SET_WORDS (ZYDIS_REGISTER_SET_BITS / 64)
+
+/**
+ * The `ZydisRegisterSet` bit index of the first CPU flag. CPU flags are tracked individually,
+ * bit `n` of the `ZYDIS_CPUFLAG_*` mask maps to bit `ZYDIS_REGISTER_SET_CPUFLAGS + n`.
+ */
+#define ZYDIS_REGISTER_SET_CPUFLAGS 96
+
+/**
+ * The `ZydisRegisterSet` bit index of the first FPU flag. FPU flags are tracked individually,
+ * bit `n` of the `ZYDIS_FPUFLAG_*` mask maps to bit `ZYDIS_REGISTER_SET_FPUFLAGS + n`.
+ */
+#define ZYDIS_REGISTER_SET_FPUFLAGS 120
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisRegisterSet` struct.
+ *
+ * A bitset of registers, normalized to their largest enclosing register. Use
+ * `ZydisRegisterGetSetIndex` to obtain the bit index of a register. General purpose registers,
+ * vector registers, mask registers and the individual CPU and FPU flags occupy the first 128 bits.
+ */
+typedef struct ZydisRegisterSet_
+{
+    /**
+     * The bits.
+     */
+    ZyanU64 bits[ZYDIS_REGISTER_SET_WORDS];
+} ZydisRegisterSet;
+
+/**
+ * Defines the `ZydisRegisterUsage` struct.
+ */
+typedef struct ZydisRegisterUsage_
+{
+    /**
+     * The registers (partially or conditionally) read by the instruction.
+     */
+    ZydisRegisterSet read;
+    /**
+     * The registers unconditionally overwritten as a whole by the instruction.
+     */
+    ZydisRegisterSet write;
+    /**
+     * The registers conditionally or partially written by the instruction (e.g. `AL`, `CMOVcc`
+     * destinations, legacy `SSE` destinations or the flags register as a whole). Their previous
+     * value might survive.
+     */
+    ZydisRegisterSet cond_write;
+} ZydisRegisterUsage;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns the `ZydisRegisterSet` bit index of the given register.
+ *
+ * @param   reg The register.
+ *
+ * @return  The bit index of the largest enclosing register or `-1`, if the register is invalid.
+ *
+ * The index does not depend on the machine mode, e.g. `AL`, `EAX` and `RAX` all map to the same
+ * index.
+ */
+ZYDIS_EXPORT ZyanI16 ZydisRegisterGetSetIndex(ZydisRegister reg);
+
+/**
+ * Adds the given register to the given register set.
+ *
+ * @param   set A pointer to the `ZydisRegisterSet` struct.
+ * @param   reg The register.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisRegisterSetAdd(ZydisRegisterSet* set, ZydisRegister reg);
+
+/**
+ * Checks if the given register set contains the given register.
+ *
+ * @param   set A pointer to the `ZydisRegisterSet` struct.
+ * @param   reg The register.
+ *
+ * @return  `ZYAN_TRUE`, if the set contains the register or `ZYAN_FALSE`, if not.
+ */
+ZYDIS_EXPORT ZyanBool ZydisRegisterSetContains(const ZydisRegisterSet* set, ZydisRegister reg);
+
+/**
+ * Calculates the union of two register sets.
+ *
+ * @param   result  A pointer to the `ZydisRegisterSet` struct receiving the result.
+ * @param   a       A pointer to the first `ZydisRegisterSet` struct.
+ * @param   b       A pointer to the second `ZydisRegisterSet` struct.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisRegisterSetUnion(ZydisRegisterSet* result,
+    const ZydisRegisterSet* a, const ZydisRegisterSet* b);
+
+/**
+ * Calculates the difference of two register sets (`a` without `b`).
+ *
+ * @param   result  A pointer to the `ZydisRegisterSet` struct receiving the result.
+ * @param   a       A pointer to the first `ZydisRegisterSet` struct.
+ * @param   b       A pointer to the second `ZydisRegisterSet` struct.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisRegisterSetDifference(ZydisRegisterSet* result,
+    const ZydisRegisterSet* a, const ZydisRegisterSet* b);
+
+/**
+ * Determines the registers read and written by the given instruction.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands        A pointer to the operands decoded by `ZydisDecoderDecodeOperands`.
+ *                          Hidden operands must be included to get complete results.
+ * @param   operand_count   The number of operands.
+ * @param   usage           Receives the register usage.
+ *
+ * Base, index and segment registers of memory operands are reported as read (segment registers
+ * in 64-bit mode only for `FS` and `GS`). Individual CPU and FPU flags are derived from
+ * `cpu_flags` and `fpu_flags`: tested flags are read, modified, set, cleared and undefined flags
+ * are written.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisGetRegisterUsage(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZydisRegisterUsage* usage);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_REGISTER_USAGE_H */
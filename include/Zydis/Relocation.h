@@ -0,0 +1,157 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for relocating blocks of machine code to a different runtime address.
+ */
+
+#ifndef ZYDIS_RELOCATION_H
+#define ZYDIS_RELOCATION_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+#include <Zydis/Encoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup relocation Relocation
+ * Functions for relocating blocks of machine code to a different runtime address.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Maps an instruction of the source code block to its location in the relocated code.
+ */
+typedef struct ZydisRelocationMapEntry_
+{
+    /**
+     * The offset of the instruction relative to the start of the source code block.
+     */
+    ZyanU32 source_offset;
+    /**
+     * The offset of the instruction relative to the start of the relocated code.
+     */
+    ZyanU32 destination_offset;
+} ZydisRelocationMapEntry;
+
+/**
+ * Holds a decoded instruction with relative operands of the source code block.
+ *
+ * `ZydisRelocateCode` decodes the source code block only once and re-encodes these instructions
+ * from the cached state in every layout pass.
+ */
+typedef struct ZydisRelocationInstruction_
+{
+    /**
+     * The index of the `ZydisRelocationMapEntry` describing the instruction.
+     */
+    ZyanU32 index;
+    /**
+     * The decoder context of the instruction.
+     */
+    ZydisDecoderContext context;
+    /**
+     * The decoded instruction.
+     */
+    ZydisDecodedInstruction instruction;
+    /**
+     * The visible operands of the instruction.
+     */
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT_VISIBLE];
+} ZydisRelocationInstruction;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Relocates a block of machine code to a different runtime address.
+ *
+ * @param   decoder             A pointer to the `ZydisDecoder` instance.
+ * @param   source              A pointer to the code that should be relocated.
+ * @param   source_length       The length of the source code block. The block must end on an
+ *                              instruction boundary.
+ * @param   source_address      The runtime address of the source code block.
+ * @param   destination_address The runtime address of the relocated code.
+ * @param   buffer              A pointer to the output buffer receiving the relocated code.
+ * @param   length              A pointer to the variable containing length of the output buffer.
+ *                              Upon successful return this variable receives length of the
+ *                              relocated code.
+ * @param   map                 A pointer to an array receiving one `ZydisRelocationMapEntry` for
+ *                              each instruction of the source code block.
+ * @param   map_length          A pointer to the variable containing the number of elements in the
+ *                              `map` array. Upon return this variable receives the number of
+ *                              instructions in the source code block (also if the function fails
+ *                              with `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE` due to a small `map`).
+ * @param   instructions        A pointer to an array receiving one `ZydisRelocationInstruction`
+ *                              for each instruction with relative operands.
+ * @param   instruction_count   A pointer to the variable containing the number of elements in the
+ *                              `instructions` array. Upon return this variable receives the
+ *                              number of instructions with relative operands (also if the
+ *                              function fails with `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE`).
+ *
+ * Instructions without relative operands are copied unmodified. Relative branches and
+ * `EIP`/`RIP`-relative memory operands are re-encoded using `ZydisEncoderReEncodeInstruction`,
+ * so that they keep referencing their original targets. Targets inside of the source code block
+ * are redirected to the relocated copy of the referenced instruction instead.
+ *
+ * Branches that are out of range at the new location (e.g. `jcc rel8`) are promoted to larger
+ * encodings. Instructions that turn out shorter than a previously reserved slot are padded with
+ * `NOP` instructions, which guarantees that the layout converges.
+ *
+ * Instructions without a sufficiently large alternative encoding (`JCXZ`/`JECXZ`/`JRCXZ`,
+ * `LOOP`, `LOOPE` and `LOOPNE` only exist with a `rel8` offset) cause the function to fail with
+ * `ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION`, if their target is out of range at the new location.
+ * This also applies to targets inside of the source code block, which may move out of range
+ * because branches in between were promoted. Such instructions have to be rewritten by the
+ * caller (e.g. `LOOP` as `DEC RCX` + `JNZ`) before relocating the code.
+ *
+ * @return  A zyan status code.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisRelocateCode(const ZydisDecoder* decoder, const void* source,
+    ZyanUSize source_length, ZyanU64 source_address, ZyanU64 destination_address, void* buffer,
+    ZyanUSize* length, ZydisRelocationMapEntry* map, ZyanUSize* map_length,
+    ZydisRelocationInstruction* instructions, ZyanUSize* instruction_count);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_RELOCATION_H */
@@ -0,0 +1,188 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Functions for estimating the steady-state throughput of basic blocks.
+ */
+
+#ifndef ZYDIS_THROUGHPUT_H
+#define ZYDIS_THROUGHPUT_H
+
+#include <Zycore/Types.h>
+#include <Zydis/Decoder.h>
+#include <Zydis/PerfInfo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup throughput Throughput
+ * Functions for estimating the steady-state throughput of basic blocks.
+ *
+ * The block is treated as the body of a loop that is executed over and over again. The estimate
+ * is the maximum of three independent bounds:
+ * - The front-end bound: the number of fused-domain uops divided by the issue width, taking
+ *   macro-fusion of `CMP`/`TEST`-like instructions with a directly following `Jcc` into account.
+ * - The port bound: the uops of all instructions (including loads and stores) are distributed
+ *   onto the execution ports, always choosing the least loaded eligible port.
+ * - The dependency bound: the length of the loop-carried dependency chains through registers and
+ *   individual CPU flags. Zero idioms (e.g. `XOR EAX, EAX`) break dependency chains. Dependencies
+ *   through memory are not tracked.
+ *
+ * The model is based on `ZydisGetInstructionPerfInfo` and inherits its accuracy. It is intended
+ * for quick relative comparisons and not as a replacement for a cycle-accurate simulator.
+ *
+ * All cycle counts are fixed-point values scaled by `ZYDIS_THROUGHPUT_SCALE`.
+ * @{
+ */
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * The scale factor of all fixed-point cycle values (e.g. `150` equals `1.5` cycles).
+ */
+#define ZYDIS_THROUGHPUT_SCALE 100
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisThroughputBottleneck` enum.
+ */
+typedef enum ZydisThroughputBottleneck_
+{
+    /**
+     * The throughput is limited by the issue width of the front-end.
+     */
+    ZYDIS_THROUGHPUT_BOTTLENECK_FRONTEND,
+    /**
+     * The throughput is limited by the most heavily used execution port.
+     */
+    ZYDIS_THROUGHPUT_BOTTLENECK_PORTS,
+    /**
+     * The throughput is limited by a loop-carried dependency chain.
+     */
+    ZYDIS_THROUGHPUT_BOTTLENECK_DEPENDENCIES,
+
+    /**
+     * Maximum value of this enum.
+     */
+    ZYDIS_THROUGHPUT_BOTTLENECK_MAX_VALUE = ZYDIS_THROUGHPUT_BOTTLENECK_DEPENDENCIES,
+    /**
+     * The minimum number of bits required to represent all values of this enum.
+     */
+    ZYDIS_THROUGHPUT_BOTTLENECK_REQUIRED_BITS =
+        ZYAN_BITS_TO_REPRESENT(ZYDIS_THROUGHPUT_BOTTLENECK_MAX_VALUE)
+} ZydisThroughputBottleneck;
+
+/**
+ * Defines the `ZydisThroughputEstimate` struct.
+ */
+typedef struct ZydisThroughputEstimate_
+{
+    /**
+     * The estimated number of cycles per iteration (scaled by `ZYDIS_THROUGHPUT_SCALE`).
+     */
+    ZyanU32 cycles;
+    /**
+     * The front-end bound (scaled by `ZYDIS_THROUGHPUT_SCALE`).
+     */
+    ZyanU32 frontend_cycles;
+    /**
+     * The port bound (scaled by `ZYDIS_THROUGHPUT_SCALE`).
+     */
+    ZyanU32 port_cycles;
+    /**
+     * The dependency bound (scaled by `ZYDIS_THROUGHPUT_SCALE`).
+     */
+    ZyanU32 dependency_cycles;
+    /**
+     * The bound that determines `cycles`.
+     */
+    ZydisThroughputBottleneck bottleneck;
+    /**
+     * The number of instructions in the block.
+     */
+    ZyanU32 instruction_count;
+    /**
+     * The number of fused-domain uops issued per iteration.
+     */
+    ZyanU32 uop_count;
+    /**
+     * The number of macro-fused instruction pairs.
+     */
+    ZyanU32 fused_pair_count;
+    /**
+     * The average number of uops dispatched to each port per iteration (scaled by
+     * `ZYDIS_THROUGHPUT_SCALE`). The port numbering matches `ZydisInstructionPerfInfo.ports`.
+     */
+    ZyanU32 port_pressure[ZYDIS_PERF_MAX_PORTS];
+} ZydisThroughputEstimate;
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Estimates the steady-state throughput of the given basic block.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   buffer      A pointer to the block.
+ * @param   length      The length of the block, in bytes.
+ * @param   uarch       The microarchitecture.
+ * @param   estimate    A pointer to the `ZydisThroughputEstimate` struct that receives the
+ *                      estimate.
+ *
+ * @return  A zyan status code.
+ *
+ * The block is decoded linearly until `length` is exhausted. A final branch is assumed to jump
+ * back to the start of the block. The decoder must not be in minimal mode.
+ */
+ZYDIS_EXPORT ZyanStatus ZydisEstimateThroughput(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZydisMicroarchitecture uarch, ZydisThroughputEstimate* estimate);
+
+/* ============================================================================================== */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYDIS_THROUGHPUT_H */
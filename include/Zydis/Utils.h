@@ -91,6 +91,9 @@ ZYDIS_EXPORT ZyanStatus ZydisCalcAbsoluteAddress(const ZydisDecodedInstruction*
  *
  * Note that `IP/EIP/RIP` from the register-context will be ignored in favor of the passed
  * runtime-address.
+ *
+ * Segment bases and `VSIB` operands are not supported. Use `ZydisCalcMemoryAddresses` to
+ * evaluate all memory accesses of an instruction, including gather/scatter lanes.
  */
 ZYDIS_EXPORT ZyanStatus ZydisCalcAbsoluteAddressEx(const ZydisDecodedInstruction* instruction,
     const ZydisDecodedOperand* operand, ZyanU64 runtime_address,
@@ -38,10 +38,22 @@
 #if !defined(ZYDIS_DISABLE_DECODER)
 #   include <Zydis/Decoder.h>
 #   include <Zydis/DecoderTypes.h>
+#   include <Zydis/JccErratum.h>
+#   include <Zydis/ControlFlow.h>
+#   include <Zydis/JumpTable.h>
+#   include <Zydis/RegisterUsage.h>
+#   include <Zydis/Liveness.h>
+#   include <Zydis/DeadFlags.h>
+#   include <Zydis/IsaScan.h>
+#   include <Zydis/PerfInfo.h>
+#   include <Zydis/Throughput.h>
+#   include <Zydis/MemoryAccess.h>
+#   include <Zydis/References.h>
 #endif
 
 #if !defined(ZYDIS_DISABLE_ENCODER)
 #   include <Zydis/Encoder.h>
+#   include <Zydis/Relocation.h>
 #endif
 
 #if !defined(ZYDIS_DISABLE_FORMATTER)
@@ -137,11 +149,12 @@ typedef enum ZydisFeature_
     ZYDIS_FEATURE_AVX512,
     ZYDIS_FEATURE_KNC,
     ZYDIS_FEATURE_SEGMENT,
+    ZYDIS_FEATURE_LEGACY_MODES,
 
     /**
      * Maximum value of this enum.
      */
-    ZYDIS_FEATURE_MAX_VALUE = ZYDIS_FEATURE_SEGMENT,
+    ZYDIS_FEATURE_MAX_VALUE = ZYDIS_FEATURE_LEGACY_MODES,
     /**
      * The minimum number of bits required to represent all values of this enum.
      */
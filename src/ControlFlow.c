@@ -0,0 +1,598 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/ControlFlow.h>
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisCfgFlow` enum.
+ */
+typedef enum ZydisCfgFlow_
+{
+    /**
+     * Execution continues with the next instruction.
+     */
+    ZYDIS_CFG_FLOW_NONE,
+    /**
+     * Conditional branch.
+     */
+    ZYDIS_CFG_FLOW_COND_JUMP,
+    /**
+     * Unconditional branch.
+     */
+    ZYDIS_CFG_FLOW_JUMP,
+    /**
+     * Call.
+     */
+    ZYDIS_CFG_FLOW_CALL,
+    /**
+     * Return.
+     */
+    ZYDIS_CFG_FLOW_RETURN,
+    /**
+     * Execution never continues (e.g. `UD2`).
+     */
+    ZYDIS_CFG_FLOW_STOP
+} ZydisCfgFlow;
+
+/**
+ * Defines the `ZydisCfgOutput` struct.
+ */
+typedef struct ZydisCfgOutput_
+{
+    ZydisCfgBlock* blocks;
+    ZyanUSize block_capacity;
+    ZyanUSize block_count;
+    ZydisCfgEdge* edges;
+    ZyanUSize edge_capacity;
+    ZyanUSize edge_count;
+} ZydisCfgOutput;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+static ZyanBool ZydisCfgTestBit(const ZyanU8* bitmap, ZyanUSize offset)
+{
+    return (bitmap[offset >> 3] >> (offset & 7)) & 1;
+}
+
+static void ZydisCfgSetBit(ZyanU8* bitmap, ZyanUSize offset)
+{
+    bitmap[offset >> 3] |= (ZyanU8)(1 << (offset & 7));
+}
+
+/**
+ * Classifies the control-flow behavior of the given instruction.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  The control-flow behavior.
+ */
+static ZydisCfgFlow ZydisCfgGetFlow(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_COND_BR:
+        return ZYDIS_CFG_FLOW_COND_JUMP;
+    case ZYDIS_CATEGORY_UNCOND_BR:
+        return ZYDIS_CFG_FLOW_JUMP;
+    case ZYDIS_CATEGORY_CALL:
+        return ZYDIS_CFG_FLOW_CALL;
+    case ZYDIS_CATEGORY_RET:
+        return ZYDIS_CFG_FLOW_RETURN;
+    default:
+        break;
+    }
+
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_UD0:
+    case ZYDIS_MNEMONIC_UD1:
+    case ZYDIS_MNEMONIC_UD2:
+        return ZYDIS_CFG_FLOW_STOP;
+    default:
+        return ZYDIS_CFG_FLOW_NONE;
+    }
+}
+
+/**
+ * Calculates the target of a relative branch without decoding the operands. This matches the
+ * behavior of `ZydisCalcAbsoluteAddress`.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   address     The runtime address of the instruction.
+ * @param   target      Receives the target address.
+ *
+ * @return  `ZYAN_TRUE`, if the branch target is statically known or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisCfgGetBranchTarget(const ZydisDecodedInstruction* instruction,
+    ZyanU64 address, ZyanU64* target)
+{
+    for (ZyanU8 i = 0; i < ZYAN_ARRAY_LENGTH(instruction->raw.imm); ++i)
+    {
+        if (!instruction->raw.imm[i].size || !instruction->raw.imm[i].is_relative)
+        {
+            continue;
+        }
+        *target = address + instruction->length + (ZyanU64)instruction->raw.imm[i].value.s;
+        if ((instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+            (instruction->operand_width == 16) &&
+            (instruction->mnemonic != ZYDIS_MNEMONIC_XBEGIN))
+        {
+            *target &= 0xFFFF;
+        }
+        return ZYAN_TRUE;
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * Translates the given runtime address to an offset into the analyzed code.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   address The runtime address.
+ * @param   offset  Receives the offset.
+ *
+ * @return  `ZYAN_TRUE`, if the address lies inside the analyzed code or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisCfgGetOffset(const ZydisCfg* cfg, ZyanU64 address, ZyanUSize* offset)
+{
+    const ZyanU64 delta = address - cfg->runtime_address;
+    if (delta >= cfg->length)
+    {
+        return ZYAN_FALSE;
+    }
+    *offset = (ZyanUSize)delta;
+    return ZYAN_TRUE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exploration                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Marks the given offset as block leader and queues it for exploration.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   offset  The offset.
+ */
+static void ZydisCfgPushLeader(ZydisCfg* cfg, ZyanUSize offset)
+{
+    if (ZydisCfgTestBit(cfg->leaders, offset))
+    {
+        return;
+    }
+    ZydisCfgSetBit(cfg->leaders, offset);
+    if (ZydisCfgTestBit(cfg->visited, offset))
+    {
+        // Already explored, this only splits an existing block
+        return;
+    }
+
+    if (cfg->worklist_count == ZYDIS_CFG_WORKLIST_SIZE)
+    {
+        // Rediscovered later by scanning for unexplored leaders
+        if (!cfg->has_pending || (offset < cfg->pending_offset))
+        {
+            cfg->pending_offset = offset;
+        }
+        cfg->has_pending = ZYAN_TRUE;
+        return;
+    }
+    cfg->worklist[cfg->worklist_count++] = offset;
+}
+
+/**
+ * Linearly explores the code starting at the given offset until the control flow diverges.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   offset  The offset of the leader to explore.
+ */
+static void ZydisCfgExploreLeader(ZydisCfg* cfg, ZyanUSize offset)
+{
+    ZydisDecodedInstruction instruction;
+    while (offset < cfg->length)
+    {
+        if (ZydisCfgTestBit(cfg->visited, offset))
+        {
+            // Merging into previously explored code
+            ZydisCfgSetBit(cfg->leaders, offset);
+            return;
+        }
+        ZydisCfgSetBit(cfg->visited, offset);
+
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(cfg->decoder, ZYAN_NULL,
+            cfg->buffer + offset, cfg->length - offset, &instruction)))
+        {
+            return;
+        }
+
+        const ZyanU64 address = cfg->runtime_address + offset;
+        const ZyanUSize next = offset + instruction.length;
+        const ZydisCfgFlow flow = ZydisCfgGetFlow(&instruction);
+        ZyanU64 target;
+        ZyanUSize target_offset;
+        if ((flow == ZYDIS_CFG_FLOW_COND_JUMP) || (flow == ZYDIS_CFG_FLOW_JUMP) ||
+            ((flow == ZYDIS_CFG_FLOW_CALL) && cfg->follow_calls))
+        {
+            if (ZydisCfgGetBranchTarget(&instruction, address, &target) &&
+                ZydisCfgGetOffset(cfg, target, &target_offset))
+            {
+                ZydisCfgPushLeader(cfg, target_offset);
+            }
+        }
+
+        switch (flow)
+        {
+        case ZYDIS_CFG_FLOW_NONE:
+            break;
+        case ZYDIS_CFG_FLOW_COND_JUMP:
+        case ZYDIS_CFG_FLOW_CALL:
+            if (next < cfg->length)
+            {
+                ZydisCfgSetBit(cfg->leaders, next);
+            }
+            break;
+        case ZYDIS_CFG_FLOW_JUMP:
+        case ZYDIS_CFG_FLOW_RETURN:
+        case ZYDIS_CFG_FLOW_STOP:
+            return;
+        }
+
+        offset = next;
+    }
+}
+
+/**
+ * Refills the worklist with leaders that were dropped due to the worklist being full.
+ *
+ * @param   cfg A pointer to the `ZydisCfg` instance.
+ */
+static void ZydisCfgRefillWorklist(ZydisCfg* cfg)
+{
+    cfg->has_pending = ZYAN_FALSE;
+
+    const ZyanUSize bitmap_size = (cfg->length + 7) / 8;
+    for (ZyanUSize i = cfg->pending_offset / 8; i < bitmap_size; ++i)
+    {
+        ZyanU8 mask = cfg->leaders[i] & (ZyanU8)~cfg->visited[i];
+        while (mask)
+        {
+            ZyanU8 bit = 0;
+            while (!((mask >> bit) & 1))
+            {
+                ++bit;
+            }
+            mask &= (ZyanU8)~(1 << bit);
+
+            const ZyanUSize offset = i * 8 + bit;
+            if (cfg->worklist_count == ZYDIS_CFG_WORKLIST_SIZE)
+            {
+                cfg->has_pending = ZYAN_TRUE;
+                cfg->pending_offset = offset;
+                return;
+            }
+            cfg->worklist[cfg->worklist_count++] = offset;
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Graph construction                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Appends an edge to the output.
+ *
+ * @param   output          A pointer to the `ZydisCfgOutput` struct.
+ * @param   type            The edge type.
+ * @param   target_address  The target address.
+ * @param   is_indirect     `ZYAN_TRUE`, if the target is not statically known.
+ * @param   is_conditional  `ZYAN_TRUE`, if the edge is only taken conditionally.
+ */
+static void ZydisCfgEmitEdge(ZydisCfgOutput* output, ZydisCfgEdgeType type,
+    ZyanU64 target_address, ZyanBool is_indirect, ZyanBool is_conditional)
+{
+    if (output->edge_count < output->edge_capacity)
+    {
+        ZydisCfgEdge* const edge = &output->edges[output->edge_count];
+        edge->target_address = target_address;
+        edge->target = ZYDIS_CFG_BLOCK_NONE;
+        edge->type = type;
+        edge->is_indirect = is_indirect;
+        edge->is_conditional = is_conditional;
+    }
+    ++output->edge_count;
+}
+
+/**
+ * Emits the basic block starting at the given leader.
+ *
+ * @param   cfg     A pointer to the `ZydisCfg` instance.
+ * @param   output  A pointer to the `ZydisCfgOutput` struct.
+ * @param   offset  The offset of the leader.
+ */
+static void ZydisCfgEmitBlock(const ZydisCfg* cfg, ZydisCfgOutput* output, ZyanUSize offset)
+{
+    const ZyanUSize first_edge = output->edge_count;
+    ZyanU32 instruction_count = 0;
+    ZyanUSize current = offset;
+
+    ZydisDecodedInstruction instruction;
+    while (ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(cfg->decoder, ZYAN_NULL,
+        cfg->buffer + current, cfg->length - current, &instruction)))
+    {
+        ++instruction_count;
+
+        const ZyanU64 address = cfg->runtime_address + current;
+        const ZyanUSize next = current + instruction.length;
+        const ZyanU64 next_address = cfg->runtime_address + next;
+        const ZydisCfgFlow flow = ZydisCfgGetFlow(&instruction);
+        ZyanU64 target = 0;
+        ZyanBool is_indirect = ZYAN_TRUE;
+        if ((flow == ZYDIS_CFG_FLOW_COND_JUMP) || (flow == ZYDIS_CFG_FLOW_JUMP) ||
+            (flow == ZYDIS_CFG_FLOW_CALL))
+        {
+            is_indirect = !ZydisCfgGetBranchTarget(&instruction, address, &target);
+        }
+
+        current = next;
+        switch (flow)
+        {
+        case ZYDIS_CFG_FLOW_NONE:
+            // Exploration marks undecodable instructions as visited as well, so the block ends in
+            // the loop condition, if decoding the next instruction fails
+            if ((next < cfg->length) && ZydisCfgTestBit(cfg->visited, next) &&
+                !ZydisCfgTestBit(cfg->leaders, next))
+            {
+                continue;
+            }
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, next_address, ZYAN_FALSE,
+                ZYAN_FALSE);
+            break;
+        case ZYDIS_CFG_FLOW_COND_JUMP:
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_JUMP, target, is_indirect, ZYAN_TRUE);
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, next_address, ZYAN_FALSE,
+                ZYAN_TRUE);
+            break;
+        case ZYDIS_CFG_FLOW_JUMP:
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_JUMP, target, is_indirect, ZYAN_FALSE);
+            break;
+        case ZYDIS_CFG_FLOW_CALL:
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_CALL, target, is_indirect, ZYAN_FALSE);
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, next_address, ZYAN_FALSE,
+                ZYAN_FALSE);
+            break;
+        case ZYDIS_CFG_FLOW_RETURN:
+            ZydisCfgEmitEdge(output, ZYDIS_CFG_EDGE_TYPE_RETURN, 0, ZYAN_FALSE, ZYAN_FALSE);
+            break;
+        case ZYDIS_CFG_FLOW_STOP:
+            break;
+        }
+        break;
+    }
+
+    if (!instruction_count)
+    {
+        return;
+    }
+
+    if (output->block_count < output->block_capacity)
+    {
+        ZydisCfgBlock* const block = &output->blocks[output->block_count];
+        block->address = cfg->runtime_address + offset;
+        block->length = (ZyanU32)(current - offset);
+        block->instruction_count = instruction_count;
+        block->first_edge = (ZyanU32)first_edge;
+        block->edge_count = (ZyanU32)(output->edge_count - first_edge);
+    }
+    ++output->block_count;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanUSize ZydisCfgGetWorkspaceSize(ZyanUSize length)
+{
+    return 2 * ((length + 7) / 8);
+}
+
+ZyanStatus ZydisCfgInit(ZydisCfg* cfg, const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanBool follow_calls, void* workspace,
+    ZyanUSize workspace_size)
+{
+    if (!cfg || !decoder || (!buffer && length) || (!workspace && length))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    const ZyanUSize bitmap_size = (length + 7) / 8;
+    if (workspace_size < 2 * bitmap_size)
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+
+    cfg->decoder = decoder;
+    cfg->buffer = (const ZyanU8*)buffer;
+    cfg->length = length;
+    cfg->runtime_address = runtime_address;
+    cfg->leaders = (ZyanU8*)workspace;
+    cfg->visited = cfg->leaders + bitmap_size;
+    cfg->follow_calls = follow_calls;
+    cfg->has_pending = ZYAN_FALSE;
+    cfg->pending_offset = 0;
+    cfg->worklist_count = 0;
+    if (length)
+    {
+        ZYAN_MEMSET(workspace, 0, 2 * bitmap_size);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisCfgAddEntryPoint(ZydisCfg* cfg, ZyanU64 address)
+{
+    if (!cfg)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanUSize offset;
+    if (!ZydisCfgGetOffset(cfg, address, &offset))
+    {
+        return ZYAN_STATUS_OUT_OF_RANGE;
+    }
+    ZydisCfgPushLeader(cfg, offset);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisCfgExplore(ZydisCfg* cfg)
+{
+    if (!cfg)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (;;)
+    {
+        while (cfg->worklist_count)
+        {
+            ZydisCfgExploreLeader(cfg, cfg->worklist[--cfg->worklist_count]);
+        }
+        if (!cfg->has_pending)
+        {
+            break;
+        }
+        ZydisCfgRefillWorklist(cfg);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisCfgBuild(const ZydisCfg* cfg, ZydisCfgBlock* blocks, ZyanUSize* block_count,
+    ZydisCfgEdge* edges, ZyanUSize* edge_count)
+{
+    if (!cfg || !block_count || !edge_count || (!blocks && *block_count) ||
+        (!edges && *edge_count))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisCfgOutput output;
+    output.blocks = blocks;
+    output.block_capacity = *block_count;
+    output.block_count = 0;
+    output.edges = edges;
+    output.edge_capacity = *edge_count;
+    output.edge_count = 0;
+
+    // Leaders are visited in ascending order, which keeps the blocks sorted by address
+    const ZyanUSize bitmap_size = (cfg->length + 7) / 8;
+    for (ZyanUSize i = 0; i < bitmap_size; ++i)
+    {
+        const ZyanU8 mask = cfg->leaders[i] & cfg->visited[i];
+        if (!mask)
+        {
+            continue;
+        }
+        for (ZyanU8 bit = 0; bit < 8; ++bit)
+        {
+            if ((mask >> bit) & 1)
+            {
+                ZydisCfgEmitBlock(cfg, &output, i * 8 + bit);
+            }
+        }
+    }
+
+    *block_count = output.block_count;
+    *edge_count = output.edge_count;
+    if ((output.block_count > output.block_capacity) ||
+        (output.edge_count > output.edge_capacity))
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+
+    for (ZyanUSize i = 0; i < output.edge_count; ++i)
+    {
+        ZydisCfgEdge* const edge = &edges[i];
+        ZyanUSize index;
+        if (edge->is_indirect || (edge->type == ZYDIS_CFG_EDGE_TYPE_RETURN) ||
+            !ZYAN_SUCCESS(ZydisCfgFindBlock(blocks, output.block_count, edge->target_address,
+                &index)) || (blocks[index].address != edge->target_address))
+        {
+            continue;
+        }
+        edge->target = (ZyanU32)index;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisCfgFindBlock(const ZydisCfgBlock* blocks, ZyanUSize block_count,
+    ZyanU64 address, ZyanUSize* index)
+{
+    if ((!blocks && block_count) || !index)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Find the last block starting at or before the address
+    ZyanUSize lo = 0;
+    ZyanUSize hi = block_count;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + (hi - lo) / 2;
+        if (blocks[mid].address <= address)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+    if (!lo || (address - blocks[lo - 1].address >= blocks[lo - 1].length))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+    *index = lo - 1;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
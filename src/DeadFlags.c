@@ -0,0 +1,273 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/DeadFlags.h>
+
+/* ============================================================================================== */
+/* Internal constants                                                                             */
+/* ============================================================================================== */
+
+/**
+ * All CPU flags tracked by the analysis.
+ */
+#define ZYDIS_DEAD_FLAGS_ALL \
+    (ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_PF | ZYDIS_CPUFLAG_AF | ZYDIS_CPUFLAG_ZF | \
+     ZYDIS_CPUFLAG_SF | ZYDIS_CPUFLAG_TF | ZYDIS_CPUFLAG_IF | ZYDIS_CPUFLAG_DF | \
+     ZYDIS_CPUFLAG_OF | ZYDIS_CPUFLAG_IOPL | ZYDIS_CPUFLAG_NT | ZYDIS_CPUFLAG_RF | \
+     ZYDIS_CPUFLAG_VM | ZYDIS_CPUFLAG_AC | ZYDIS_CPUFLAG_VIF | ZYDIS_CPUFLAG_VIP | \
+     ZYDIS_CPUFLAG_ID)
+
+ZYAN_STATIC_ASSERT((ZYDIS_DEAD_FLAGS_CACHE_SIZE & (ZYDIS_DEAD_FLAGS_CACHE_SIZE - 1)) == 0);
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns the cache entry for the given address.
+ *
+ * @param   analyzer    A pointer to the `ZydisDeadFlagsAnalyzer` instance.
+ * @param   address     The runtime address.
+ *
+ * @return  A pointer to the cache entry slot. The entry might belong to a different address.
+ */
+static ZydisDeadFlagsCacheEntry* ZydisDeadFlagsGetCacheEntry(ZydisDeadFlagsAnalyzer* analyzer,
+    ZyanU64 address)
+{
+    const ZyanU64 hash = address ^ (address >> 16);
+    return &analyzer->cache[hash & (ZYDIS_DEAD_FLAGS_CACHE_SIZE - 1)];
+}
+
+/**
+ * Checks if the given instruction ends the straight-line code scanned by the analysis.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction transfers control or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisDeadFlagsIsTerminator(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_COND_BR:
+    case ZYDIS_CATEGORY_UNCOND_BR:
+    case ZYDIS_CATEGORY_CALL:
+    case ZYDIS_CATEGORY_RET:
+    case ZYDIS_CATEGORY_INTERRUPT:
+    case ZYDIS_CATEGORY_SYSCALL:
+    case ZYDIS_CATEGORY_SYSRET:
+        return ZYAN_TRUE;
+    default:
+        break;
+    }
+
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_UD0:
+    case ZYDIS_MNEMONIC_UD1:
+    case ZYDIS_MNEMONIC_UD2:
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/**
+ * Returns the CPU flags read by the given instruction.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  The CPU flags read by the instruction.
+ */
+static ZydisAccessedFlagsMask ZydisDeadFlagsGetRead(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_PUSHF:
+    case ZYDIS_MNEMONIC_PUSHFD:
+    case ZYDIS_MNEMONIC_PUSHFQ:
+        // The whole flags register is stored to memory
+        return ZYDIS_DEAD_FLAGS_ALL;
+    default:
+        return instruction->cpu_flags->tested;
+    }
+}
+
+/**
+ * Checks if the given instruction might leave the CPU flags it writes unchanged.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the written flags might survive or `ZYAN_FALSE`, if not.
+ *
+ * Shifts and rotates do not modify any flags, if the masked count is zero. This is only known
+ * statically for the immediate and `1` forms, but not for the forms using `CL` as count.
+ */
+static ZyanBool ZydisDeadFlagsIsConditionalWrite(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_RCL:
+    case ZYDIS_MNEMONIC_RCR:
+    case ZYDIS_MNEMONIC_ROL:
+    case ZYDIS_MNEMONIC_ROR:
+    case ZYDIS_MNEMONIC_SAR:
+    case ZYDIS_MNEMONIC_SHL:
+    case ZYDIS_MNEMONIC_SHR:
+        if (!instruction->raw.imm[0].size)
+        {
+            // `D0`/`D1` shift by `1`, `D2`/`D3` by `CL`
+            return (instruction->opcode & 0x02) != 0;
+        }
+        break;
+    case ZYDIS_MNEMONIC_SHLD:
+    case ZYDIS_MNEMONIC_SHRD:
+        if (!instruction->raw.imm[0].size)
+        {
+            return ZYAN_TRUE;
+        }
+        break;
+    default:
+        return ZYAN_FALSE;
+    }
+
+    const ZyanU64 count_mask = (instruction->operand_width == 64) ? 0x3F : 0x1F;
+    return (instruction->raw.imm[0].value.u & count_mask) == 0;
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisDeadFlagsAnalyzerInit(ZydisDeadFlagsAnalyzer* analyzer,
+    const ZydisDecoder* decoder, ZyanUSize window)
+{
+    if (!analyzer || !decoder || !window)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    analyzer->decoder = decoder;
+    analyzer->window = window;
+
+    return ZydisDeadFlagsAnalyzerReset(analyzer);
+}
+
+ZyanStatus ZydisDeadFlagsAnalyzerReset(ZydisDeadFlagsAnalyzer* analyzer)
+{
+    if (!analyzer)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (ZyanUSize i = 0; i < ZYDIS_DEAD_FLAGS_CACHE_SIZE; ++i)
+    {
+        analyzer->cache[i].is_valid = ZYAN_FALSE;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisDeadFlagsQuery(ZydisDeadFlagsAnalyzer* analyzer, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZydisAccessedFlagsMask* dead_flags)
+{
+    if (!analyzer || !buffer || !length || !dead_flags)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisDeadFlagsCacheEntry* const entry = ZydisDeadFlagsGetCacheEntry(analyzer,
+        runtime_address);
+    if (entry->is_valid && (entry->address == runtime_address))
+    {
+        *dead_flags = entry->dead;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanU8* const data = (const ZyanU8*)buffer;
+    ZydisAccessedFlagsMask pending = ZYDIS_DEAD_FLAGS_ALL;
+    ZydisAccessedFlagsMask dead = 0;
+    ZyanUSize offset = 0;
+    for (ZyanUSize i = 0; (i < analyzer->window) && pending && (offset < length); ++i)
+    {
+        if (i)
+        {
+            // The cached result is valid independent of the remaining window size, as the window
+            // only limits the effort, not the correctness of the analysis
+            const ZydisDeadFlagsCacheEntry* const cached =
+                ZydisDeadFlagsGetCacheEntry(analyzer, runtime_address + offset);
+            if (cached->is_valid && (cached->address == runtime_address + offset))
+            {
+                dead |= cached->dead & pending;
+                break;
+            }
+        }
+
+        ZydisDecodedInstruction instruction;
+        const ZyanStatus status = ZydisDecoderDecodeInstruction(analyzer->decoder, ZYAN_NULL,
+            data + offset, length - offset, &instruction);
+        if (!ZYAN_SUCCESS(status))
+        {
+            if (!i)
+            {
+                return status;
+            }
+            break;
+        }
+        if (!instruction.cpu_flags)
+        {
+            break;
+        }
+
+        // Flags tested before being overwritten are live
+        pending &= ~ZydisDeadFlagsGetRead(&instruction);
+
+        const ZydisAccessedFlags* const flags = instruction.cpu_flags;
+        const ZydisAccessedFlagsMask written =
+            flags->modified | flags->set_0 | flags->set_1 | flags->undefined;
+        if (!ZydisDeadFlagsIsConditionalWrite(&instruction))
+        {
+            dead |= written & pending;
+            pending &= ~written;
+        }
+
+        if (ZydisDeadFlagsIsTerminator(&instruction))
+        {
+            break;
+        }
+        offset += instruction.length;
+    }
+
+    entry->address = runtime_address;
+    entry->dead = dead;
+    entry->is_valid = ZYAN_TRUE;
+
+    *dead_flags = dead;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
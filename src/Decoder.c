@@ -37,6 +37,13 @@
 #include <Zydis/Internal/DecoderData.h>
 #include <Zydis/Internal/SharedData.h>
 
+#if !defined(ZYAN_NO_LIBC) && (defined(ZYAN_X64) || defined(ZYAN_X86))
+#   if defined(__SSE2__) || defined(ZYAN_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#       include <emmintrin.h>
+#       define ZYDIS_PREFIX_SCAN_SSE2
+#   endif
+#endif
+
 /* ============================================================================================== */
 /* Macros                                                                                         */
 /* ============================================================================================== */
@@ -54,6 +61,58 @@
 #define ZYDIS_DECODER_MODE_ACTIVE(decoder, mode) \
     (!!(((decoder)->decoder_mode & (1 << (mode)))))
 
+/**
+ * Returns the status code for a failed read of `count` bytes from the input data-source.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   count       The number of bytes that could not be read.
+ *
+ * As the readable input is limited to `ZYDIS_MAX_INSTRUCTION_LENGTH` bytes, a failed read is
+ * caused by either the instruction length limit (which takes precedence) or the end of the input
+ * buffer.
+ */
+#define ZYDIS_INPUT_ERROR(instruction, count) \
+    (((instruction)->length + (count) > ZYDIS_MAX_INSTRUCTION_LENGTH) ? \
+        ZYDIS_STATUS_INSTRUCTION_TOO_LONG : ZYDIS_STATUS_NO_MORE_DATA)
+
+/**
+ * Checks if the given decoder tree node type selects a path based on a decoder mode
+ * (`ZYDIS_NODETYPE_MODE_AMD` to `ZYDIS_NODETYPE_MODE_UD0_COMPAT`).
+ *
+ * @param   node_type   The decoder tree node type.
+ */
+#define ZYDIS_DT_IS_DECODER_MODE_NODE(node_type) \
+    ((ZyanU8)((node_type) - ZYDIS_NODETYPE_MODE_AMD) <= \
+        (ZyanU8)(ZYDIS_NODETYPE_MODE_UD0_COMPAT - ZYDIS_NODETYPE_MODE_AMD))
+
+/**
+ * Returns the child index selected by a decoder mode tree node.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   node_type   The decoder tree node type.
+ *
+ * The `ZYDIS_NODETYPE_MODE_*` node types are laid out in the same order as the corresponding
+ * `ZydisDecoderMode` values, so the decoder mode bitmap is indexed directly.
+ */
+#define ZYDIS_DT_RESOLVE_DECODER_MODE_NODE(decoder, node_type) \
+    (((decoder)->decoder_mode >> \
+        ((node_type) - ZYDIS_NODETYPE_MODE_AMD + ZYDIS_DECODER_MODE_AMD_BRANCHES)) & 1)
+
+/**
+ * Returns the machine mode used for decoding.
+ *
+ * @param   value   The `ZydisMachineMode` value stored in the decoder or instruction.
+ *
+ * Evaluates to the constant `ZYDIS_MACHINE_MODE_LONG_64` if support for the 16/32-bit machine
+ * modes is disabled. This allows the compiler to remove all code paths that are specific to the
+ * legacy and compatibility modes (e.g. 16-bit addressing).
+ */
+#ifdef ZYDIS_DISABLE_LEGACY_MODES
+#   define ZYDIS_MACHINE_MODE(value) ZYDIS_MACHINE_MODE_LONG_64
+#else
+#   define ZYDIS_MACHINE_MODE(value) (value)
+#endif
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -82,9 +141,24 @@ typedef struct ZydisDecoderState_
      */
     const ZyanU8* buffer;
     /**
-     * The input buffer length.
+     * The number of bytes that can still be consumed by the current instruction.
+     *
+     * This is the input buffer length limited to `ZYDIS_MAX_INSTRUCTION_LENGTH`, which allows the
+     * input functions to enforce both limits with a single comparison.
      */
     ZyanUSize buffer_len;
+    /**
+     * Signals, if at least `ZYDIS_DECODER_PADDED_LENGTH` bytes are readable at the start of the
+     * instruction. This allows the prefixes to be classified with a single vector load and the
+     * displacement and immediate values to be read with unchecked 8-byte loads.
+     */
+    ZyanBool padded;
+#ifdef ZYDIS_DECODER_STATS
+    /**
+     * The number of decoder tree nodes visited while decoding the current instruction.
+     */
+    ZyanU8 path_length;
+#endif
     /**
      * Prefix information.
      */
@@ -242,6 +316,123 @@ typedef enum ZydisRegisterEncoding_
 
 /* ---------------------------------------------------------------------------------------------- */
 
+/* ============================================================================================== */
+/* Decoder statistics                                                                             */
+/* ============================================================================================== */
+
+#ifdef ZYDIS_DECODER_STATS
+
+ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MAX_VALUE < ZYDIS_DECODER_STATS_NODE_TYPE_COUNT);
+
+/**
+ * Contains the decoder statistics collected since the last call to `ZydisDecoderResetStats`.
+ */
+static ZydisDecoderStats g_decoder_stats;
+
+/**
+ * Contains the names of all decoder tree node types.
+ */
+static const char* const STR_NODE_TYPE[ZYDIS_NODETYPE_MAX_VALUE + 1] =
+{
+    [ZYDIS_NODETYPE_INVALID               ] = "INVALID",
+    [ZYDIS_NODETYPE_DEFINITION            ] = "DEFINITION",
+    [ZYDIS_NODETYPE_SWITCH_TABLE          ] = "SWITCH_TABLE",
+    [ZYDIS_NODETYPE_SWITCH_TABLE_XOP      ] = "SWITCH_TABLE_XOP",
+    [ZYDIS_NODETYPE_SWITCH_TABLE_VEX      ] = "SWITCH_TABLE_VEX",
+    [ZYDIS_NODETYPE_SWITCH_TABLE_EMVEX    ] = "SWITCH_TABLE_EMVEX",
+    [ZYDIS_NODETYPE_SWITCH_TABLE_REX2     ] = "SWITCH_TABLE_REX2",
+    [ZYDIS_NODETYPE_OPCODE_TABLE          ] = "OPCODE_TABLE",
+    [ZYDIS_NODETYPE_MODE                  ] = "MODE",
+    [ZYDIS_NODETYPE_MODE_COMPACT          ] = "MODE_COMPACT",
+    [ZYDIS_NODETYPE_MODRM_MOD             ] = "MODRM_MOD",
+    [ZYDIS_NODETYPE_MODRM_MOD_COMPACT     ] = "MODRM_MOD_COMPACT",
+    [ZYDIS_NODETYPE_MODRM_REG             ] = "MODRM_REG",
+    [ZYDIS_NODETYPE_MODRM_RM              ] = "MODRM_RM",
+    [ZYDIS_NODETYPE_PREFIX_GROUP1         ] = "PREFIX_GROUP1",
+    [ZYDIS_NODETYPE_MANDATORY_PREFIX      ] = "MANDATORY_PREFIX",
+    [ZYDIS_NODETYPE_OPERAND_SIZE          ] = "OPERAND_SIZE",
+    [ZYDIS_NODETYPE_ADDRESS_SIZE          ] = "ADDRESS_SIZE",
+    [ZYDIS_NODETYPE_VECTOR_LENGTH         ] = "VECTOR_LENGTH",
+    [ZYDIS_NODETYPE_REX_W                 ] = "REX_W",
+    [ZYDIS_NODETYPE_REX_B                 ] = "REX_B",
+    [ZYDIS_NODETYPE_EVEX_B                ] = "EVEX_B",
+    [ZYDIS_NODETYPE_MVEX_E                ] = "MVEX_E",
+    [ZYDIS_NODETYPE_MODE_AMD              ] = "MODE_AMD",
+    [ZYDIS_NODETYPE_MODE_KNC              ] = "MODE_KNC",
+    [ZYDIS_NODETYPE_MODE_MPX              ] = "MODE_MPX",
+    [ZYDIS_NODETYPE_MODE_CET              ] = "MODE_CET",
+    [ZYDIS_NODETYPE_MODE_LZCNT            ] = "MODE_LZCNT",
+    [ZYDIS_NODETYPE_MODE_TZCNT            ] = "MODE_TZCNT",
+    [ZYDIS_NODETYPE_MODE_WBNOINVD         ] = "MODE_WBNOINVD",
+    [ZYDIS_NODETYPE_MODE_CLDEMOTE         ] = "MODE_CLDEMOTE",
+    [ZYDIS_NODETYPE_MODE_IPREFETCH        ] = "MODE_IPREFETCH",
+    [ZYDIS_NODETYPE_MODE_UD0_COMPAT       ] = "MODE_UD0_COMPAT",
+    [ZYDIS_NODETYPE_EVEX_ND               ] = "EVEX_ND",
+    [ZYDIS_NODETYPE_EVEX_NF               ] = "EVEX_NF",
+    [ZYDIS_NODETYPE_EVEX_SCC              ] = "EVEX_SCC",
+    [ZYDIS_NODETYPE_REX_2                 ] = "REX_2",
+    [ZYDIS_NODETYPE_EVEX_U                ] = "EVEX_U"
+};
+
+/**
+ * Records a visit of a decoder tree node of the given type.
+ *
+ * @param   state       A pointer to the `ZydisDecoderState` struct.
+ * @param   node_type   The `ZydisDecoderTreeNodeType` of the node.
+ */
+#define ZYDIS_STATS_NODE(state, node_type) \
+    do \
+    { \
+        ++g_decoder_stats.node_count[node_type]; \
+        ++(state)->path_length; \
+    } while (0)
+
+/**
+ * Records the result of a decode attempt.
+ *
+ * @param   state       A pointer to the `ZydisDecoderState` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   status      The status of the decode attempt.
+ */
+#define ZYDIS_STATS_RESULT(state, instruction, status) \
+    ZydisRecordDecoderStats(state, instruction, status)
+
+/**
+ * Updates the path length, encoding and error counters with the result of a decode attempt.
+ *
+ * @param   state       A pointer to the `ZydisDecoderState` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   status      The status of the decode attempt.
+ */
+static void ZydisRecordDecoderStats(const ZydisDecoderState* state,
+    const ZydisDecodedInstruction* instruction, ZyanStatus status)
+{
+    ++g_decoder_stats.path_length_count[
+        ZYAN_MIN(state->path_length, ZYDIS_DECODER_STATS_PATH_LENGTH_COUNT - 1)];
+
+    if (ZYAN_SUCCESS(status))
+    {
+        ++g_decoder_stats.encoding_count[instruction->encoding];
+        return;
+    }
+
+    if ((ZYAN_STATUS_MODULE(status) == ZYAN_MODULE_ZYDIS) &&
+        (ZYAN_STATUS_CODE(status) < ZYDIS_DECODER_STATS_STATUS_CODE_COUNT))
+    {
+        ++g_decoder_stats.error_count[ZYAN_STATUS_CODE(status)];
+    } else
+    {
+        ++g_decoder_stats.other_error_count;
+    }
+}
+
+#else
+
+#define ZYDIS_STATS_NODE(state, node_type)
+#define ZYDIS_STATS_RESULT(state, instruction, status)
+
+#endif
+
 /* ============================================================================================== */
 /* Internal functions                                                                             */
 /* ============================================================================================== */
@@ -268,11 +459,7 @@ static ZyanStatus ZydisInputPeek(ZydisDecoderState* state,
     ZYAN_ASSERT(state);
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(value);
-
-    if (instruction->length >= ZYDIS_MAX_INSTRUCTION_LENGTH)
-    {
-        return ZYDIS_STATUS_INSTRUCTION_TOO_LONG;
-    }
+    ZYAN_ASSERT(instruction->length + state->buffer_len <= ZYDIS_MAX_INSTRUCTION_LENGTH);
 
     if (state->buffer_len > 0)
     {
@@ -280,7 +467,7 @@ static ZyanStatus ZydisInputPeek(ZydisDecoderState* state,
         return ZYAN_STATUS_SUCCESS;
     }
 
-    return ZYDIS_STATUS_NO_MORE_DATA;
+    return ZYDIS_INPUT_ERROR(instruction, 1);
 }
 
 /**
@@ -323,10 +510,7 @@ static ZyanStatus ZydisInputNext(ZydisDecoderState* state,
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(value);
 
-    if (instruction->length >= ZYDIS_MAX_INSTRUCTION_LENGTH)
-    {
-        return ZYDIS_STATUS_INSTRUCTION_TOO_LONG;
-    }
+    ZYAN_ASSERT(instruction->length + state->buffer_len <= ZYDIS_MAX_INSTRUCTION_LENGTH);
 
     if (state->buffer_len > 0)
     {
@@ -336,7 +520,7 @@ static ZyanStatus ZydisInputNext(ZydisDecoderState* state,
         return ZYAN_STATUS_SUCCESS;
     }
 
-    return ZYDIS_STATUS_NO_MORE_DATA;
+    return ZYDIS_INPUT_ERROR(instruction, 1);
 }
 
 /**
@@ -360,10 +544,7 @@ static ZyanStatus ZydisInputNextBytes(ZydisDecoderState* state,
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(value);
 
-    if (instruction->length + number_of_bytes > ZYDIS_MAX_INSTRUCTION_LENGTH)
-    {
-        return ZYDIS_STATUS_INSTRUCTION_TOO_LONG;
-    }
+    ZYAN_ASSERT(instruction->length + state->buffer_len <= ZYDIS_MAX_INSTRUCTION_LENGTH);
 
     if (state->buffer_len >= number_of_bytes)
     {
@@ -376,7 +557,69 @@ static ZyanStatus ZydisInputNextBytes(ZydisDecoderState* state,
         return ZYAN_STATUS_SUCCESS;
     }
 
-    return ZYDIS_STATUS_NO_MORE_DATA;
+    return ZYDIS_INPUT_ERROR(instruction, number_of_bytes);
+}
+
+/**
+ * Reads up to 8 bytes from the current read-position of padded input with a single unaligned load
+ * and increases the read-position by the specified amount of bytes afterwards.
+ *
+ * @param   state           A pointer to the `ZydisDecoderState` struct.
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   number_of_bytes The number of bytes to read from the input data-source (`1` to `8`).
+ * @param   value           A pointer to the memory that receives the zero-extended little-endian
+ *                          value.
+ *
+ * @return  A zyan status code.
+ *
+ * This function may only be used, if `ZydisDecoderState.padded` is set. The padding guarantees
+ * that 8 bytes are readable at every position inside of an instruction, so only the instruction
+ * length limit has to be checked.
+ */
+ZYAN_STATIC_ASSERT(ZYDIS_DECODER_PADDED_LENGTH >= ZYDIS_MAX_INSTRUCTION_LENGTH - 1 + 8);
+
+static ZyanStatus ZydisInputNextWide(ZydisDecoderState* state,
+    ZydisDecodedInstruction* instruction, ZyanU8 number_of_bytes, ZyanU64* value)
+{
+    ZYAN_ASSERT(state);
+    ZYAN_ASSERT(state->padded);
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(value);
+    ZYAN_ASSERT((number_of_bytes > 0) && (number_of_bytes <= 8));
+
+    ZYAN_ASSERT(instruction->length + state->buffer_len <= ZYDIS_MAX_INSTRUCTION_LENGTH);
+
+    if (state->buffer_len >= number_of_bytes)
+    {
+        ZyanU64 data;
+        ZYAN_MEMCPY(&data, state->buffer, sizeof(data));
+        ZYAN_LE64_TO_NATIVE(data);
+        *value = (number_of_bytes < 8) ? (data & ((1ULL << (number_of_bytes * 8)) - 1)) : data;
+
+        instruction->length += number_of_bytes;
+        state->buffer += number_of_bytes;
+        state->buffer_len -= number_of_bytes;
+
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    return ZYDIS_INPUT_ERROR(instruction, number_of_bytes);
+}
+
+/**
+ * Sign-extends a value read by `ZydisInputNextWide`.
+ *
+ * @param   value   The zero-extended value.
+ * @param   size    The physical size of the value, in bits.
+ *
+ * @return  The sign-extended value.
+ */
+static ZyanI64 ZydisInputSignExtend(ZyanU64 value, ZyanU8 size)
+{
+    ZYAN_ASSERT((size > 0) && (size <= 64));
+
+    const ZyanU64 sign = 1ULL << (size - 1);
+    return (ZyanI64)((value ^ sign) - sign);
 }
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -460,7 +703,7 @@ static ZyanStatus ZydisDecodeXOP(ZydisDecoderContext* context,
     ZYAN_ASSERT(((data[1] >> 0) & 0x1F) >= 8);
     ZYAN_ASSERT(instruction->raw.xop.offset == instruction->length - 3);
 
-    if (instruction->machine_mode == ZYDIS_MACHINE_MODE_REAL_16)
+    if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_REAL_16)
     {
         // XOP is invalid in 16-bit real mode
         return ZYDIS_STATUS_DECODING_ERROR;
@@ -509,7 +752,7 @@ static ZyanStatus ZydisDecodeVEX(ZydisDecoderContext* context,
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT((data[0] == 0xC4) || (data[0] == 0xC5));
 
-    if (instruction->machine_mode == ZYDIS_MACHINE_MODE_REAL_16)
+    if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_REAL_16)
     {
         // VEX is invalid in 16-bit real mode
         return ZYDIS_STATUS_DECODING_ERROR;
@@ -586,7 +829,7 @@ static ZyanStatus ZydisDecodeEVEX(const ZydisDecoder* decoder, ZydisDecoderConte
     ZYAN_ASSERT(data[0] == 0x62);
     ZYAN_ASSERT(instruction->raw.evex.offset == instruction->length - 4);
 
-    if (instruction->machine_mode == ZYDIS_MACHINE_MODE_REAL_16)
+    if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_REAL_16)
     {
         // EVEX is invalid in 16-bit real mode
         return ZYDIS_STATUS_DECODING_ERROR;
@@ -631,7 +874,7 @@ static ZyanStatus ZydisDecodeEVEX(const ZydisDecoder* decoder, ZydisDecoderConte
     instruction->raw.evex.SCC       = (data[3] >> 0) & 0x0F; // uses same bits as 'V4' and 'aaa'
 
     if (!instruction->raw.evex.V4 &&
-        (instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64))
+        (ZYDIS_MACHINE_MODE(instruction->machine_mode) != ZYDIS_MACHINE_MODE_LONG_64))
     {
         return ZYDIS_STATUS_MALFORMED_EVEX;
     }
@@ -681,7 +924,7 @@ static ZyanStatus ZydisDecodeMVEX(ZydisDecoderContext* context,
     ZYAN_ASSERT(data[0] == 0x62);
     ZYAN_ASSERT(instruction->raw.mvex.offset == instruction->length - 4);
 
-    if (instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64)
+    if (ZYDIS_MACHINE_MODE(instruction->machine_mode) != ZYDIS_MACHINE_MODE_LONG_64)
     {
         // MVEX is only valid in 64-bit mode
         return ZYDIS_STATUS_DECODING_ERROR;
@@ -788,6 +1031,14 @@ static ZyanStatus ZydisReadDisplacement(ZydisDecoderState* state,
     instruction->raw.disp.size = size;
     instruction->raw.disp.offset = instruction->length;
 
+    if (state->padded)
+    {
+        ZyanU64 value;
+        ZYAN_CHECK(ZydisInputNextWide(state, instruction, size / 8, &value));
+        instruction->raw.disp.value = ZydisInputSignExtend(value, size);
+        return ZYAN_STATUS_SUCCESS;
+    }
+
     switch (size)
     {
     case 8:
@@ -855,6 +1106,21 @@ static ZyanStatus ZydisReadImmediate(ZydisDecoderState* state,
     instruction->raw.imm[id].is_signed = is_signed;
     instruction->raw.imm[id].is_address = is_address;
     instruction->raw.imm[id].is_relative = is_relative;
+
+    if (state->padded)
+    {
+        ZyanU64 value;
+        ZYAN_CHECK(ZydisInputNextWide(state, instruction, size / 8, &value));
+        if (is_signed)
+        {
+            instruction->raw.imm[id].value.s = ZydisInputSignExtend(value, size);
+        } else
+        {
+            instruction->raw.imm[id].value.u = value;
+        }
+        return ZYAN_STATUS_SUCCESS;
+    }
+
     switch (size)
     {
     case 8:
@@ -971,7 +1237,7 @@ static ZyanU8 ZydisCalcRegisterId(const ZydisDecoderContext* context,
         {
             value = value - 8;
         }
-        if (instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64)
+        if (ZYDIS_MACHINE_MODE(instruction->machine_mode) != ZYDIS_MACHINE_MODE_LONG_64)
         {
             return value;
         }
@@ -979,7 +1245,7 @@ static ZyanU8 ZydisCalcRegisterId(const ZydisDecoderContext* context,
     }
     case ZYDIS_REG_ENCODING_IS4:
     {
-        if (instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64)
+        if (ZYDIS_MACHINE_MODE(instruction->machine_mode) != ZYDIS_MACHINE_MODE_LONG_64)
         {
             return (instruction->raw.imm[0].value.u >> 4) & 0x07;
         }
@@ -1039,7 +1305,7 @@ static void ZydisSetOperandSizeAndElementInfo(const ZydisDecoderContext* context
         } else
         {
             // TODO: TMM register size should probably be 0
-            operand->size = ZydisRegisterGetWidth(instruction->machine_mode,
+            operand->size = ZydisRegisterGetWidth(ZYDIS_MACHINE_MODE(instruction->machine_mode),
                 operand->reg.value);
         }
         operand->element_type = ZYDIS_ELEMENT_TYPE_INT;
@@ -1392,7 +1658,7 @@ static ZyanStatus ZydisDecodeOperandMemory(const ZydisDecoderContext* context,
         case 0:
             if (modrm_rm == 5)
             {
-                if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+                if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
                 {
                     operand->mem.base = ZYDIS_REGISTER_EIP;
                 } else
@@ -1452,7 +1718,7 @@ static ZyanStatus ZydisDecodeOperandMemory(const ZydisDecoderContext* context,
         case 0:
             if (modrm_rm == 5)
             {
-                if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+                if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
                 {
                     operand->mem.base = ZYDIS_REGISTER_RIP;
                 } else
@@ -1661,389 +1927,433 @@ static void ZydisDecodeOperandImplicitMemory(const ZydisDecoder* decoder,
 #endif
 
 #ifndef ZYDIS_MINIMAL_MODE
-static ZyanStatus ZydisDecodeOperands(const ZydisDecoder* decoder, const ZydisDecoderContext* context,
-    const ZydisDecodedInstruction* instruction, ZydisDecodedOperand* operands, ZyanU8 operand_count)
+/**
+ * Defines the `ZydisOperandRecipeWidth` enum.
+ */
+typedef enum ZydisOperandRecipeWidth_
+{
+    /**
+     * The register class does not depend on the instruction.
+     */
+    ZYDIS_OPERAND_RECIPE_WIDTH_FIXED,
+    /**
+     * The register class is selected by the effective operand width.
+     */
+    ZYDIS_OPERAND_RECIPE_WIDTH_OPERAND,
+    /**
+     * The register class is selected by the effective address width.
+     */
+    ZYDIS_OPERAND_RECIPE_WIDTH_ADDRESS
+} ZydisOperandRecipeWidth;
+
+/**
+ * Defines the `ZydisOperandRecipe` struct.
+ *
+ * Operand recipes resolve the register class of a semantic operand type by table lookup, which
+ * replaces the per-operand `switch` over all semantic operand types.
+ */
+typedef struct ZydisOperandRecipe_
+{
+    /**
+     * The register class for an effective width of 16, 32 and 64 bits or
+     * `ZYDIS_REGCLASS_INVALID`, if the operand is not a register operand.
+     */
+    ZyanU8 register_class[3];
+    /**
+     * The `ZydisOperandRecipeWidth` that selects the `register_class` entry.
+     */
+    ZyanU8 width;
+    /**
+     * The `ZYDIS_OPERAND_MATCH_*` type flag of the operand.
+     */
+    ZydisOperandMatch match;
+} ZydisOperandRecipe;
+
+#define ZYDIS_RECIPE_OTHER(match) \
+    { { 0, 0, 0 }, ZYDIS_OPERAND_RECIPE_WIDTH_FIXED, ZYDIS_OPERAND_MATCH_##match }
+#define ZYDIS_RECIPE_FIXED(reg_class) \
+    { { reg_class, reg_class, reg_class }, ZYDIS_OPERAND_RECIPE_WIDTH_FIXED, \
+      ZYDIS_OPERAND_MATCH_REGISTER }
+#define ZYDIS_RECIPE_WIDTH(class16, class32, class64, width) \
+    { { class16, class32, class64 }, ZYDIS_OPERAND_RECIPE_WIDTH_##width, \
+      ZYDIS_OPERAND_MATCH_REGISTER }
+
+/**
+ * Contains the operand recipes for all semantic operand types.
+ */
+static const ZydisOperandRecipe OPERAND_RECIPES[ZYDIS_SEMANTIC_OPTYPE_MAX_VALUE + 1] =
+{
+    /* UNUSED       */ { { 0, 0, 0 }, ZYDIS_OPERAND_RECIPE_WIDTH_FIXED, 0 },
+    /* IMPLICIT_REG */ ZYDIS_RECIPE_OTHER(REGISTER),
+    /* IMPLICIT_MEM */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* IMPLICIT_IMM1*/ ZYDIS_RECIPE_OTHER(IMMEDIATE),
+    /* GPR8         */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_GPR8),
+    /* GPR16        */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_GPR16),
+    /* GPR32        */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_GPR32),
+    /* GPR64        */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_GPR64),
+    /* GPR16_32_64  */ ZYDIS_RECIPE_WIDTH(ZYDIS_REGCLASS_GPR16, ZYDIS_REGCLASS_GPR32,
+                                          ZYDIS_REGCLASS_GPR64, OPERAND),
+    /* GPR32_32_64  */ ZYDIS_RECIPE_WIDTH(ZYDIS_REGCLASS_GPR32, ZYDIS_REGCLASS_GPR32,
+                                          ZYDIS_REGCLASS_GPR64, OPERAND),
+    /* GPR16_32_32  */ ZYDIS_RECIPE_WIDTH(ZYDIS_REGCLASS_GPR16, ZYDIS_REGCLASS_GPR32,
+                                          ZYDIS_REGCLASS_GPR32, OPERAND),
+    /* GPR_ASZ      */ ZYDIS_RECIPE_WIDTH(ZYDIS_REGCLASS_GPR16, ZYDIS_REGCLASS_GPR32,
+                                          ZYDIS_REGCLASS_GPR64, ADDRESS),
+    /* FPR          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_X87),
+    /* MMX          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_MMX),
+    /* XMM          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_XMM),
+    /* YMM          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_YMM),
+    /* ZMM          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_ZMM),
+    /* TMM          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_TMM),
+    /* BND          */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_BOUND),
+    /* SREG         */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_SEGMENT),
+    /* CR           */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_CONTROL),
+    /* DR           */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_DEBUG),
+    /* MASK         */ ZYDIS_RECIPE_FIXED(ZYDIS_REGCLASS_MASK),
+    /* MEM          */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* MEM_VSIBX    */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* MEM_VSIBY    */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* MEM_VSIBZ    */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* IMM          */ ZYDIS_RECIPE_OTHER(IMMEDIATE),
+    /* REL          */ ZYDIS_RECIPE_OTHER(RELATIVE),
+    /* ABS          */ ZYDIS_RECIPE_OTHER(IMMEDIATE),
+    /* PTR          */ ZYDIS_RECIPE_OTHER(POINTER),
+    /* AGEN         */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* MOFFS        */ ZYDIS_RECIPE_OTHER(MEMORY),
+    /* MIB          */ ZYDIS_RECIPE_OTHER(MEMORY)
+};
+
+#undef ZYDIS_RECIPE_WIDTH
+#undef ZYDIS_RECIPE_FIXED
+#undef ZYDIS_RECIPE_OTHER
+
+/**
+ * Checks if the given operand definition consumes one of the raw immediate values.
+ *
+ * @param   definition  A pointer to the `ZydisOperandDefinition` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the operand is an `IMM`, `REL` or `ABS` operand or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZydisIsRawImmediateOperand(const ZydisOperandDefinition* definition)
+{
+    return (definition->type == ZYDIS_SEMANTIC_OPTYPE_IMM) ||
+           (definition->type == ZYDIS_SEMANTIC_OPTYPE_REL) ||
+           (definition->type == ZYDIS_SEMANTIC_OPTYPE_ABS);
+}
+
+/**
+ * Maps register operand encodings to the `ZydisRegisterEncoding` used to calculate the
+ * register-id.
+ */
+static const ZyanU8 OPERAND_REGISTER_ENCODINGS[ZYDIS_OPERAND_ENCODING_MASK + 1] =
+{
+    /* NONE      */ ZYDIS_REG_ENCODING_INVALID,
+    /* MODRM_REG */ ZYDIS_REG_ENCODING_REG,
+    /* MODRM_RM  */ ZYDIS_REG_ENCODING_RM,
+    /* OPCODE    */ ZYDIS_REG_ENCODING_OPCODE,
+    /* NDSNDD    */ ZYDIS_REG_ENCODING_NDSNDD,
+    /* IS4       */ ZYDIS_REG_ENCODING_IS4,
+    /* MASK      */ ZYDIS_REG_ENCODING_MASK
+};
+
+/**
+ * Returns the register class of the given operand definition.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   definition  A pointer to the `ZydisOperandDefinition` struct.
+ *
+ * @return  The register class or `ZYDIS_REGCLASS_INVALID`, if the operand definition does not
+ *          describe an explicit register operand.
+ */
+ZYAN_INLINE ZydisRegisterClass ZydisGetOperandRegisterClass(
+    const ZydisDecodedInstruction* instruction, const ZydisOperandDefinition* definition)
+{
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(definition);
+    ZYAN_STATIC_ASSERT(ZYDIS_REGCLASS_MAX_VALUE <= 0xFF);
+
+    const ZydisOperandRecipe* recipe = &OPERAND_RECIPES[definition->type];
+    switch (recipe->width)
+    {
+    case ZYDIS_OPERAND_RECIPE_WIDTH_FIXED:
+        return (ZydisRegisterClass)recipe->register_class[0];
+    case ZYDIS_OPERAND_RECIPE_WIDTH_OPERAND:
+        ZYAN_ASSERT((instruction->operand_width == 16) || (instruction->operand_width == 32) ||
+            (instruction->operand_width == 64));
+        return (ZydisRegisterClass)recipe->register_class[instruction->operand_width >> 5];
+    case ZYDIS_OPERAND_RECIPE_WIDTH_ADDRESS:
+        ZYAN_ASSERT((instruction->address_width == 16) || (instruction->address_width == 32) ||
+            (instruction->address_width == 64));
+        return (ZydisRegisterClass)recipe->register_class[instruction->address_width >> 5];
+    default:
+        ZYAN_UNREACHABLE;
+    }
+}
+
+/**
+ * Decodes a single instruction operand.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operand     A pointer to the zero-initialized `ZydisDecodedOperand` struct.
+ * @param   definition  A pointer to the `ZydisOperandDefinition` struct.
+ * @param   id          The index of the operand.
+ * @param   imm_id      The index of the raw immediate used by immediate operands.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisDecodeOperand(const ZydisDecoder* decoder,
+    const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction,
+    ZydisDecodedOperand* operand, const ZydisOperandDefinition* definition, ZyanU8 id,
+    ZyanU8 imm_id)
 {
     ZYAN_ASSERT(decoder);
     ZYAN_ASSERT(context);
-    ZYAN_ASSERT(context->definition);
     ZYAN_ASSERT(instruction);
-    ZYAN_ASSERT(operands);
-    ZYAN_ASSERT(operand_count);
-    ZYAN_ASSERT(operand_count <= instruction->operand_count);
+    ZYAN_ASSERT(operand);
+    ZYAN_ASSERT(definition);
 
-    const ZydisInstructionDefinition* definition = context->definition;
-    const ZydisOperandDefinition* operand = ZydisGetOperandDefinitions(definition);
+    const ZydisOperandDetails *details = ZydisGetOperandDetails(definition);
+    ZydisRegisterClass register_class = ZYDIS_REGCLASS_INVALID;
+
+    operand->id = id;
+    operand->visibility = definition->visibility;
+    operand->actions = definition->actions;
+    ZYAN_ASSERT(!(definition->actions &
+        ZYDIS_OPERAND_ACTION_READ & ZYDIS_OPERAND_ACTION_CONDREAD) ||
+        (definition->actions & ZYDIS_OPERAND_ACTION_READ) ^
+        (definition->actions & ZYDIS_OPERAND_ACTION_CONDREAD));
+    ZYAN_ASSERT(!(definition->actions &
+        ZYDIS_OPERAND_ACTION_WRITE & ZYDIS_OPERAND_ACTION_CONDWRITE) ||
+        (definition->actions & ZYDIS_OPERAND_ACTION_WRITE) ^
+        (definition->actions & ZYDIS_OPERAND_ACTION_CONDWRITE));
+
+    // Implicit operands
+    switch (definition->type)
+    {
+    case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_REG:
+        ZydisDecodeOperandImplicitRegister(decoder, context, instruction, operand, details);
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_MEM:
+        ZydisDecodeOperandImplicitMemory(decoder, context, instruction, operand, details);
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_IMM1:
+        operand->type = ZYDIS_OPERAND_TYPE_IMMEDIATE;
+        operand->size = 8;
+        operand->imm.value.u = 1;
+        operand->imm.is_signed = ZYAN_FALSE;
+        operand->imm.is_relative = ZYAN_FALSE;
+        break;
+    default:
+        break;
+    }
+    if (operand->type)
+    {
+        goto FinalizeOperand;
+    }
 
-    ZYAN_MEMSET(operands, 0, sizeof(ZydisDecodedOperand) * operand_count);
+    operand->encoding = details->encoding;
 
-    ZyanU8 imm_id = 0;
-    for (ZyanU8 i = 0; i < operand_count; ++i)
+    // Register operands
+    register_class = ZydisGetOperandRegisterClass(instruction, definition);
+    if (register_class)
     {
-        const ZydisOperandDetails *details = ZydisGetOperandDetails(operand);
-        ZydisRegisterClass register_class = ZYDIS_REGCLASS_INVALID;
-
-        operands[i].id = i;
-        operands[i].visibility = operand->visibility;
-        operands[i].actions = operand->actions;
-        ZYAN_ASSERT(!(operand->actions &
-            ZYDIS_OPERAND_ACTION_READ & ZYDIS_OPERAND_ACTION_CONDREAD) ||
-            (operand->actions & ZYDIS_OPERAND_ACTION_READ) ^
-            (operand->actions & ZYDIS_OPERAND_ACTION_CONDREAD));
-        ZYAN_ASSERT(!(operand->actions &
-            ZYDIS_OPERAND_ACTION_WRITE & ZYDIS_OPERAND_ACTION_CONDWRITE) ||
-            (operand->actions & ZYDIS_OPERAND_ACTION_WRITE) ^
-            (operand->actions & ZYDIS_OPERAND_ACTION_CONDWRITE));
-
-        // Implicit operands
-        switch (operand->type)
-        {
-        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_REG:
-            ZydisDecodeOperandImplicitRegister(decoder, context, instruction, &operands[i], details);
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_MEM:
-            ZydisDecodeOperandImplicitMemory(decoder, context, instruction, &operands[i], details);
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_IMM1:
-            operands[i].type = ZYDIS_OPERAND_TYPE_IMMEDIATE;
-            operands[i].size = 8;
-            operands[i].imm.value.u = 1;
-            operands[i].imm.is_signed = ZYAN_FALSE;
-            operands[i].imm.is_relative = ZYAN_FALSE;
-            break;
-        default:
-            break;
-        }
-        if (operands[i].type)
+        ZYAN_ASSERT(details->encoding < ZYAN_ARRAY_LENGTH(OPERAND_REGISTER_ENCODINGS));
+        const ZydisRegisterEncoding encoding =
+            (ZydisRegisterEncoding)OPERAND_REGISTER_ENCODINGS[details->encoding];
+        ZYAN_ASSERT(encoding != ZYDIS_REG_ENCODING_INVALID);
+        ZYAN_CHECK(
+            ZydisDecodeOperandRegister(
+                instruction, operand, register_class,
+                ZydisCalcRegisterId(context, instruction, encoding, register_class)));
+
+        if (definition->is_multisource4)
         {
-            goto FinalizeOperand;
+            operand->attributes |= ZYDIS_OATTRIB_IS_MULTISOURCE4;
         }
 
-        operands[i].encoding = details->encoding;
+        goto FinalizeOperand;
+    }
 
-        // Register operands
-        switch (operand->type)
+    // Memory operands
+    switch (definition->type)
+    {
+    case ZYDIS_SEMANTIC_OPTYPE_MEM:
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_INVALID));
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBX:
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_XMM));
+        operand->mem.type = ZYDIS_MEMOP_TYPE_VSIB;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBY:
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_YMM));
+        operand->mem.type = ZYDIS_MEMOP_TYPE_VSIB;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBZ:
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_ZMM));
+        operand->mem.type = ZYDIS_MEMOP_TYPE_VSIB;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_PTR:
+        ZYAN_ASSERT((instruction->raw.imm[0].size == 16) ||
+            (instruction->raw.imm[0].size == 32));
+        ZYAN_ASSERT(instruction->raw.imm[1].size == 16);
+        operand->type = ZYDIS_OPERAND_TYPE_POINTER;
+        operand->ptr.offset = (ZyanU32)instruction->raw.imm[0].value.u;
+        operand->ptr.segment = (ZyanU16)instruction->raw.imm[1].value.u;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_AGEN:
+        operand->actions = 0; // TODO: Remove after generator update
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_INVALID));
+        operand->mem.type = ZYDIS_MEMOP_TYPE_AGEN;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_MOFFS:
+        ZYAN_ASSERT(instruction->raw.disp.size);
+        operand->type = ZYDIS_OPERAND_TYPE_MEMORY;
+        operand->mem.type = ZYDIS_MEMOP_TYPE_MEM;
+        operand->mem.disp.size = instruction->raw.disp.size;
+        operand->mem.disp.offset = instruction->raw.disp.offset;
+        operand->mem.disp.value = instruction->raw.disp.value;
+        break;
+    case ZYDIS_SEMANTIC_OPTYPE_MIB:
+        operand->actions = 0; // TODO: Remove after generator update
+        ZYAN_CHECK(
+            ZydisDecodeOperandMemory(
+                context, instruction, operand, ZYDIS_REGCLASS_INVALID));
+        operand->mem.type = ZYDIS_MEMOP_TYPE_MIB;
+        break;
+    default:
+        break;
+    }
+    if (operand->type)
+    {
+#if !defined(ZYDIS_DISABLE_AVX512) || !defined(ZYDIS_DISABLE_KNC)
+        // Handle compressed 8-bit displacement
+        if (((instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_EVEX) ||
+            (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_MVEX)) &&
+            (context->evex.tuple_type != ZYDIS_TUPLETYPE_NO_SCALE) &&
+            (instruction->raw.disp.size == 8))
         {
-        case ZYDIS_SEMANTIC_OPTYPE_GPR8:
-            register_class = ZYDIS_REGCLASS_GPR8;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR16:
-            register_class = ZYDIS_REGCLASS_GPR16;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR32:
-            register_class = ZYDIS_REGCLASS_GPR32;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR64:
-            register_class = ZYDIS_REGCLASS_GPR64;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR16_32_64:
-            ZYAN_ASSERT((instruction->operand_width == 16) || (instruction->operand_width == 32) ||
-                (instruction->operand_width == 64));
-            register_class =
-                (instruction->operand_width == 16) ? ZYDIS_REGCLASS_GPR16 : (
-                    (instruction->operand_width == 32) ? ZYDIS_REGCLASS_GPR32 : ZYDIS_REGCLASS_GPR64);
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR32_32_64:
-            ZYAN_ASSERT((instruction->operand_width == 16) || (instruction->operand_width == 32) ||
-                (instruction->operand_width == 64));
-            register_class =
-                (instruction->operand_width == 16) ? ZYDIS_REGCLASS_GPR32 : (
-                    (instruction->operand_width == 32) ? ZYDIS_REGCLASS_GPR32 : ZYDIS_REGCLASS_GPR64);
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR16_32_32:
-            ZYAN_ASSERT((instruction->operand_width == 16) || (instruction->operand_width == 32) ||
-                (instruction->operand_width == 64));
-            register_class =
-                (instruction->operand_width == 16) ? ZYDIS_REGCLASS_GPR16 : ZYDIS_REGCLASS_GPR32;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_GPR_ASZ:
-            ZYAN_ASSERT((instruction->address_width == 16) || (instruction->address_width == 32) ||
-                (instruction->address_width == 64));
-            register_class =
-                (instruction->address_width == 16) ? ZYDIS_REGCLASS_GPR16 : (
-                    (instruction->address_width == 32) ? ZYDIS_REGCLASS_GPR32 : ZYDIS_REGCLASS_GPR64);
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_FPR:
-            register_class = ZYDIS_REGCLASS_X87;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MMX:
-            register_class = ZYDIS_REGCLASS_MMX;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_XMM:
-            register_class = ZYDIS_REGCLASS_XMM;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_YMM:
-            register_class = ZYDIS_REGCLASS_YMM;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_ZMM:
-            register_class = ZYDIS_REGCLASS_ZMM;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_TMM:
-            register_class = ZYDIS_REGCLASS_TMM;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_BND:
-            register_class = ZYDIS_REGCLASS_BOUND;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_SREG:
-            register_class = ZYDIS_REGCLASS_SEGMENT;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_CR:
-            register_class = ZYDIS_REGCLASS_CONTROL;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_DR:
-            register_class = ZYDIS_REGCLASS_DEBUG;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MASK:
-            register_class = ZYDIS_REGCLASS_MASK;
-            break;
-        default:
-            break;
+            operand->mem.disp.value *= context->cd8_scale;
         }
-        if (register_class)
-        {
-            switch (details->encoding)
-            {
-            case ZYDIS_OPERAND_ENCODING_MODRM_REG:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_REG, register_class)));
-                break;
-            case ZYDIS_OPERAND_ENCODING_MODRM_RM:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_RM, register_class)));
-                break;
-            case ZYDIS_OPERAND_ENCODING_OPCODE:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_OPCODE, register_class)));
-                break;
-            case ZYDIS_OPERAND_ENCODING_NDSNDD:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_NDSNDD, register_class)));
-                break;
-            case ZYDIS_OPERAND_ENCODING_MASK:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_MASK, register_class)));
-                break;
-            case ZYDIS_OPERAND_ENCODING_IS4:
-                ZYAN_CHECK(
-                    ZydisDecodeOperandRegister(
-                        instruction, &operands[i], register_class,
-                        ZydisCalcRegisterId(
-                            context, instruction, ZYDIS_REG_ENCODING_IS4, register_class)));
-                break;
-            default:
-                ZYAN_UNREACHABLE;
-            }
-
-            if (operand->is_multisource4)
-            {
-                operands[i].attributes |= ZYDIS_OATTRIB_IS_MULTISOURCE4;
-            }
+#endif
 
-            goto FinalizeOperand;
-        }
+        goto FinalizeOperand;
+    }
 
-        // Memory operands
-        switch (operand->type)
+    // Immediate operands
+    switch (definition->type)
+    {
+    case ZYDIS_SEMANTIC_OPTYPE_REL:
+    case ZYDIS_SEMANTIC_OPTYPE_ABS:
+        ZYAN_ASSERT((definition->type == ZYDIS_SEMANTIC_OPTYPE_REL) || !instruction->raw.imm[imm_id].is_relative);
+        ZYAN_ASSERT((definition->type == ZYDIS_SEMANTIC_OPTYPE_ABS) ||  instruction->raw.imm[imm_id].is_relative);
+        ZYAN_FALLTHROUGH;
+    case ZYDIS_SEMANTIC_OPTYPE_IMM:
+        ZYAN_ASSERT((imm_id == 0) || (imm_id == 1));
+        operand->type = ZYDIS_OPERAND_TYPE_IMMEDIATE;
+        operand->size = ZydisGetOperandSizes(definition)[context->eosz_index] * 8;
+        if (details->encoding == ZYDIS_OPERAND_ENCODING_IS4)
         {
-        case ZYDIS_SEMANTIC_OPTYPE_MEM:
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_INVALID));
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBX:
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_XMM));
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_VSIB;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBY:
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_YMM));
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_VSIB;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MEM_VSIBZ:
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_ZMM));
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_VSIB;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_PTR:
-            ZYAN_ASSERT((instruction->raw.imm[0].size == 16) ||
-                (instruction->raw.imm[0].size == 32));
-            ZYAN_ASSERT(instruction->raw.imm[1].size == 16);
-            operands[i].type = ZYDIS_OPERAND_TYPE_POINTER;
-            operands[i].ptr.offset = (ZyanU32)instruction->raw.imm[0].value.u;
-            operands[i].ptr.segment = (ZyanU16)instruction->raw.imm[1].value.u;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_AGEN:
-            operands[i].actions = 0; // TODO: Remove after generator update
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_INVALID));
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_AGEN;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MOFFS:
-            ZYAN_ASSERT(instruction->raw.disp.size);
-            operands[i].type = ZYDIS_OPERAND_TYPE_MEMORY;
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_MEM;
-            operands[i].mem.disp.size = instruction->raw.disp.size;
-            operands[i].mem.disp.offset = instruction->raw.disp.offset;
-            operands[i].mem.disp.value = instruction->raw.disp.value;
-            break;
-        case ZYDIS_SEMANTIC_OPTYPE_MIB:
-            operands[i].actions = 0; // TODO: Remove after generator update
-            ZYAN_CHECK(
-                ZydisDecodeOperandMemory(
-                    context, instruction, &operands[i], ZYDIS_REGCLASS_INVALID));
-            operands[i].mem.type = ZYDIS_MEMOP_TYPE_MIB;
-            break;
-        default:
-            break;
+            // The upper half of the 8-bit immediate is used to encode a register specifier
+            ZYAN_ASSERT(instruction->raw.imm[imm_id].size == 8);
+            operand->imm.value.u = (ZyanU8)instruction->raw.imm[imm_id].value.u & 0x0F;
         }
-        if (operands[i].type)
+        else
         {
-#if !defined(ZYDIS_DISABLE_AVX512) || !defined(ZYDIS_DISABLE_KNC)
-            // Handle compressed 8-bit displacement
-            if (((instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_EVEX) ||
-                (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_MVEX)) &&
-                (context->evex.tuple_type != ZYDIS_TUPLETYPE_NO_SCALE) &&
-                (instruction->raw.disp.size == 8))
-            {
-                operands[i].mem.disp.value *= context->cd8_scale;
-            }
-#endif
-
-            goto FinalizeOperand;
+            operand->imm.value.u = instruction->raw.imm[imm_id].value.u;
         }
+        operand->imm.offset = instruction->raw.imm[imm_id].offset;
+        operand->imm.size = instruction->raw.imm[imm_id].size;
+        operand->imm.is_signed = instruction->raw.imm[imm_id].is_signed;
+        operand->imm.is_address = instruction->raw.imm[imm_id].is_address;
+        operand->imm.is_relative = instruction->raw.imm[imm_id].is_relative;
+        break;
+    default:
+        break;
+    }
+    ZYAN_ASSERT(operand->type == ZYDIS_OPERAND_TYPE_IMMEDIATE);
 
-        // Immediate operands
-        switch (operand->type)
+FinalizeOperand:
+    // Set segment-register for memory operands
+    if (operand->type == ZYDIS_OPERAND_TYPE_MEMORY)
+    {
+        static const struct
         {
-        case ZYDIS_SEMANTIC_OPTYPE_REL:
-        case ZYDIS_SEMANTIC_OPTYPE_ABS:
-            ZYAN_ASSERT((operand->type == ZYDIS_SEMANTIC_OPTYPE_REL) || !instruction->raw.imm[imm_id].is_relative);
-            ZYAN_ASSERT((operand->type == ZYDIS_SEMANTIC_OPTYPE_ABS) ||  instruction->raw.imm[imm_id].is_relative);
-            ZYAN_FALLTHROUGH;
-        case ZYDIS_SEMANTIC_OPTYPE_IMM:
-            ZYAN_ASSERT((imm_id == 0) || (imm_id == 1));
-            operands[i].type = ZYDIS_OPERAND_TYPE_IMMEDIATE;
-            operands[i].size = ZydisGetOperandSizes(operand)[context->eosz_index] * 8;
-            if (details->encoding == ZYDIS_OPERAND_ENCODING_IS4)
-            {
-                // The upper half of the 8-bit immediate is used to encode a register specifier
-                ZYAN_ASSERT(instruction->raw.imm[imm_id].size == 8);
-                operands[i].imm.value.u = (ZyanU8)instruction->raw.imm[imm_id].value.u & 0x0F;
-            }
-            else
-            {
-                operands[i].imm.value.u = instruction->raw.imm[imm_id].value.u;
-            }
-            operands[i].imm.offset = instruction->raw.imm[imm_id].offset;
-            operands[i].imm.size = instruction->raw.imm[imm_id].size;
-            operands[i].imm.is_signed = instruction->raw.imm[imm_id].is_signed;
-            operands[i].imm.is_address = instruction->raw.imm[imm_id].is_address;
-            operands[i].imm.is_relative = instruction->raw.imm[imm_id].is_relative;
-            ++imm_id;
-            break;
-        default:
-            break;
-        }
-        ZYAN_ASSERT(operands[i].type == ZYDIS_OPERAND_TYPE_IMMEDIATE);
+            ZydisInstructionAttributes attribute;
+            ZydisRegister segment;
+        } overrides[] =
+        {
+            { ZYDIS_ATTRIB_HAS_SEGMENT_CS, ZYDIS_REGISTER_CS },
+            { ZYDIS_ATTRIB_HAS_SEGMENT_SS, ZYDIS_REGISTER_SS },
+            { ZYDIS_ATTRIB_HAS_SEGMENT_DS, ZYDIS_REGISTER_DS },
+            { ZYDIS_ATTRIB_HAS_SEGMENT_ES, ZYDIS_REGISTER_ES },
+            { ZYDIS_ATTRIB_HAS_SEGMENT_FS, ZYDIS_REGISTER_FS },
+            { ZYDIS_ATTRIB_HAS_SEGMENT_GS, ZYDIS_REGISTER_GS }
+        };
 
-    FinalizeOperand:
-        // Set segment-register for memory operands
-        if (operands[i].type == ZYDIS_OPERAND_TYPE_MEMORY)
+        ZyanBool has_override = ZYAN_FALSE;
+        if (!definition->ignore_seg_override &&
+            (instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT))
         {
-            if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_CS)
-            {
-                operands[i].mem.segment = ZYDIS_REGISTER_CS;
-            }
-            else if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_SS)
-            {
-                operands[i].mem.segment = ZYDIS_REGISTER_SS;
-            }
-            else if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_DS)
-            {
-                operands[i].mem.segment = ZYDIS_REGISTER_DS;
-            } 
-            else if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_ES)
+            for (ZyanUSize j = 0; j < ZYAN_ARRAY_LENGTH(overrides); ++j)
             {
-                operands[i].mem.segment = ZYDIS_REGISTER_ES;
-            }
-            else if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_FS)
-            {
-                operands[i].mem.segment = ZYDIS_REGISTER_FS;
+                if (instruction->attributes & overrides[j].attribute)
+                {
+                    operand->mem.segment = overrides[j].segment;
+                    has_override = ZYAN_TRUE;
+                    break;
+                }
             }
-            else if (!operand->ignore_seg_override &&
-                instruction->attributes & ZYDIS_ATTRIB_HAS_SEGMENT_GS)
+        }
+        if (!has_override && (operand->mem.segment == ZYDIS_REGISTER_NONE))
+        {
+            if ((operand->mem.base == ZYDIS_REGISTER_RSP) ||
+                (operand->mem.base == ZYDIS_REGISTER_RBP) ||
+                (operand->mem.base == ZYDIS_REGISTER_ESP) ||
+                (operand->mem.base == ZYDIS_REGISTER_EBP) ||
+                (operand->mem.base == ZYDIS_REGISTER_SP) ||
+                (operand->mem.base == ZYDIS_REGISTER_BP))
             {
-                operands[i].mem.segment = ZYDIS_REGISTER_GS;
+                operand->mem.segment = ZYDIS_REGISTER_SS;
             }
             else
             {
-                if (operands[i].mem.segment == ZYDIS_REGISTER_NONE)
-                {
-                    if ((operands[i].mem.base == ZYDIS_REGISTER_RSP) ||
-                        (operands[i].mem.base == ZYDIS_REGISTER_RBP) ||
-                        (operands[i].mem.base == ZYDIS_REGISTER_ESP) ||
-                        (operands[i].mem.base == ZYDIS_REGISTER_EBP) ||
-                        (operands[i].mem.base == ZYDIS_REGISTER_SP) ||
-                        (operands[i].mem.base == ZYDIS_REGISTER_BP))
-                    {
-                        operands[i].mem.segment = ZYDIS_REGISTER_SS;
-                    }
-                    else
-                    {
-                        operands[i].mem.segment = ZYDIS_REGISTER_DS;
-                    }
-                }
+                operand->mem.segment = ZYDIS_REGISTER_DS;
             }
         }
-
-        ZydisSetOperandSizeAndElementInfo(context, instruction, &operands[i], operand);
-        ++operand;
     }
 
+    ZydisSetOperandSizeAndElementInfo(context, instruction, operand, definition);
+
 #if !defined(ZYDIS_DISABLE_AVX512) || !defined(ZYDIS_DISABLE_KNC)
     // Fix operand-action for EVEX/MVEX instructions with merge-mask
-    if (instruction->avx.mask.mode == ZYDIS_MASK_MODE_MERGING)
+    if ((id == 0) && (instruction->avx.mask.mode == ZYDIS_MASK_MODE_MERGING))
     {
-        ZYAN_ASSERT(operand_count >= 1);
-        switch (operands[0].actions)
+        switch (operand->actions)
         {
         case ZYDIS_OPERAND_ACTION_WRITE:
-            if (operands[0].type == ZYDIS_OPERAND_TYPE_MEMORY)
+            if (operand->type == ZYDIS_OPERAND_TYPE_MEMORY)
             {
-                operands[0].actions = ZYDIS_OPERAND_ACTION_CONDWRITE;
+                operand->actions = ZYDIS_OPERAND_ACTION_CONDWRITE;
             }
             else
             {
-                operands[0].actions = ZYDIS_OPERAND_ACTION_READ_CONDWRITE;
+                operand->actions = ZYDIS_OPERAND_ACTION_READ_CONDWRITE;
             }
             break;
         case ZYDIS_OPERAND_ACTION_READWRITE:
-            operands[0].actions = ZYDIS_OPERAND_ACTION_READ_CONDWRITE;
+            operand->actions = ZYDIS_OPERAND_ACTION_READ_CONDWRITE;
             break;
         default:
             break;
@@ -2053,6 +2363,37 @@ static ZyanStatus ZydisDecodeOperands(const ZydisDecoder* decoder, const ZydisDe
 
     return ZYAN_STATUS_SUCCESS;
 }
+
+static ZyanStatus ZydisDecodeOperands(const ZydisDecoder* decoder, const ZydisDecoderContext* context,
+    const ZydisDecodedInstruction* instruction, ZydisDecodedOperand* operands, ZyanU8 operand_count)
+{
+    ZYAN_ASSERT(decoder);
+    ZYAN_ASSERT(context);
+    ZYAN_ASSERT(context->definition);
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(operands);
+    ZYAN_ASSERT(operand_count);
+    ZYAN_ASSERT(operand_count <= instruction->operand_count);
+
+    const ZydisInstructionDefinition* definition = context->definition;
+    const ZydisOperandDefinition* operand = ZydisGetOperandDefinitions(definition);
+
+    ZYAN_MEMSET(operands, 0, sizeof(ZydisDecodedOperand) * operand_count);
+
+    ZyanU8 imm_id = 0;
+    for (ZyanU8 i = 0; i < operand_count; ++i)
+    {
+        ZYAN_CHECK(ZydisDecodeOperand(decoder, context, instruction, &operands[i], operand, i,
+            imm_id));
+        if (ZydisIsRawImmediateOperand(operand))
+        {
+            ++imm_id;
+        }
+        ++operand;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
 #endif
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -3154,6 +3495,150 @@ static void ZydisSetAVXInformation(ZydisDecoderContext* context,
 /* Physical instruction decoding                                                                  */
 /* ---------------------------------------------------------------------------------------------- */
 
+/**
+ * Collects a single optional instruction prefix.
+ *
+ * @param   state       A pointer to the `ZydisDecoderState` struct.
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   prefix_byte The prefix byte.
+ * @param   offset      The offset of the prefix byte.
+ * @param   rex         A pointer to the variable holding the last `REX` prefix.
+ *
+ * @return  `ZYAN_TRUE`, if the byte is a prefix or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZydisCollectOptionalPrefix(ZydisDecoderState* state,
+    ZydisDecodedInstruction* instruction, ZyanU8 prefix_byte, ZyanU8 offset, ZyanU8* rex)
+{
+    ZYAN_ASSERT(state);
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(rex);
+
+    switch (prefix_byte)
+    {
+    case 0xF0:
+        state->prefixes.has_lock = ZYAN_TRUE;
+        state->prefixes.offset_lock = offset;
+        break;
+    case 0xF2:
+        ZYAN_FALLTHROUGH;
+    case 0xF3:
+        state->prefixes.group1 = prefix_byte;
+        state->prefixes.mandatory_candidate = prefix_byte;
+        state->prefixes.offset_group1 = offset;
+        state->prefixes.offset_mandatory = offset;
+        break;
+    case 0x2E:
+        ZYAN_FALLTHROUGH;
+    case 0x36:
+        ZYAN_FALLTHROUGH;
+    case 0x3E:
+        ZYAN_FALLTHROUGH;
+    case 0x26:
+        if (ZYDIS_MACHINE_MODE(state->decoder->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
+        {
+            if ((prefix_byte == 0x3E) &&
+                (state->prefixes.effective_segment != 0x64) &&
+                (state->prefixes.effective_segment != 0x65))
+            {
+                state->prefixes.offset_notrack = offset;
+            }
+            state->prefixes.group2 = prefix_byte;
+            state->prefixes.offset_group2 = offset;
+            break;
+        }
+        ZYAN_FALLTHROUGH;
+    case 0x64:
+        ZYAN_FALLTHROUGH;
+    case 0x65:
+        state->prefixes.group2 = prefix_byte;
+        state->prefixes.offset_group2 = offset;
+        state->prefixes.effective_segment = prefix_byte;
+        state->prefixes.offset_segment = offset;
+        state->prefixes.offset_notrack = -1;
+        break;
+    case 0x66:
+        // context->prefixes.has_osz_override = ZYAN_TRUE;
+        state->prefixes.offset_osz_override = offset;
+        if (!state->prefixes.mandatory_candidate)
+        {
+            state->prefixes.mandatory_candidate = 0x66;
+            state->prefixes.offset_mandatory = offset;
+        }
+        instruction->attributes |= ZYDIS_ATTRIB_HAS_OPERANDSIZE;
+        break;
+    case 0x67:
+        // context->prefixes.has_asz_override = ZYAN_TRUE;
+        state->prefixes.offset_asz_override = offset;
+        instruction->attributes |= ZYDIS_ATTRIB_HAS_ADDRESSSIZE;
+        break;
+    default:
+        if ((ZYDIS_MACHINE_MODE(state->decoder->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64) &&
+            (prefix_byte & 0xF0) == 0x40)
+        {
+            *rex = prefix_byte;
+            instruction->raw.rex.offset = offset;
+        } else
+        {
+            return ZYAN_FALSE;
+        }
+        break;
+    }
+
+    // Invalidate `REX`, if it's not the last legacy prefix
+    if (*rex && (*rex != prefix_byte))
+    {
+        *rex = 0x00;
+        instruction->raw.rex.offset = 0;
+    }
+    instruction->raw.prefixes[instruction->raw.prefix_count++].value = prefix_byte;
+
+    return ZYAN_TRUE;
+}
+
+#ifdef ZYDIS_PREFIX_SCAN_SSE2
+/**
+ * Counts the legacy (and `REX`) prefix bytes at the start of the given buffer.
+ *
+ * @param   buffer      A pointer to the input buffer. At least 16 bytes must be readable.
+ * @param   long_mode   Signals, if `REX` prefixes should be included.
+ *
+ * @return  The number of consecutive prefix bytes (`0` to `16`).
+ */
+ZYAN_INLINE ZyanU8 ZydisCountOptionalPrefixes(const ZyanU8* buffer, ZyanBool long_mode)
+{
+    ZYAN_ASSERT(buffer);
+
+    const __m128i data = _mm_loadu_si128((const __m128i*)buffer);
+
+    // `F0`, `F2` and `F3`
+    __m128i prefixes = _mm_or_si128(
+        _mm_cmpeq_epi8(data, _mm_set1_epi8((char)0xF0)),
+        _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xFE)), _mm_set1_epi8((char)0xF2)));
+    // `26`, `2E`, `36` and `3E`
+    prefixes = _mm_or_si128(prefixes,
+        _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xE7)), _mm_set1_epi8(0x26)));
+    // `64`, `65`, `66` and `67`
+    prefixes = _mm_or_si128(prefixes,
+        _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xFC)), _mm_set1_epi8(0x64)));
+    if (long_mode)
+    {
+        // `40` to `4F`
+        prefixes = _mm_or_si128(prefixes,
+            _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xF0)), _mm_set1_epi8(0x40)));
+    }
+
+    // Bit 16 and above are always set, which terminates the loop for 16 prefix bytes
+    const ZyanU32 non_prefixes = ~(ZyanU32)_mm_movemask_epi8(prefixes);
+    ZyanU8 count = 0;
+    while (!(non_prefixes & (1u << count)))
+    {
+        ++count;
+    }
+
+    return count;
+}
+#endif
+
 /**
  * Collects optional instruction prefixes.
  *
@@ -3173,95 +3658,50 @@ static ZyanStatus ZydisCollectOptionalPrefixes(ZydisDecoderState* state,
     ZYAN_ASSERT(instruction->raw.prefix_count == 0);
 
     ZyanU8 rex = 0x00;
-    ZyanU8 offset = 0;
     ZyanBool done = ZYAN_FALSE;
-    do
+
+#ifdef ZYDIS_PREFIX_SCAN_SSE2
+    // Classify the next 16 bytes at once, if available. This avoids the per-byte bounds checks and
+    // exits early for the common case of instructions without any prefixes
+    if (state->padded)
     {
-        ZyanU8 prefix_byte;
-        ZYAN_CHECK(ZydisInputPeek(state, instruction, &prefix_byte));
-        switch (prefix_byte)
+        ZYAN_ASSERT(instruction->length == 0);
+
+        const ZyanU8 count = ZydisCountOptionalPrefixes(state->buffer,
+            ZYDIS_MACHINE_MODE(state->decoder->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64);
+        if (!count)
         {
-        case 0xF0:
-            state->prefixes.has_lock = ZYAN_TRUE;
-            state->prefixes.offset_lock = offset;
-            break;
-        case 0xF2:
-            ZYAN_FALLTHROUGH;
-        case 0xF3:
-            state->prefixes.group1 = prefix_byte;
-            state->prefixes.mandatory_candidate = prefix_byte;
-            state->prefixes.offset_group1 = offset;
-            state->prefixes.offset_mandatory = offset;
-            break;
-        case 0x2E:
-            ZYAN_FALLTHROUGH;
-        case 0x36:
-            ZYAN_FALLTHROUGH;
-        case 0x3E:
-            ZYAN_FALLTHROUGH;
-        case 0x26:
-            if (state->decoder->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
-            {
-                if ((prefix_byte == 0x3E) &&
-                    (state->prefixes.effective_segment != 0x64) &&
-                    (state->prefixes.effective_segment != 0x65))
-                {
-                    state->prefixes.offset_notrack = offset;
-                }
-                state->prefixes.group2 = prefix_byte;
-                state->prefixes.offset_group2 = offset;
-                break;
-            }
-            ZYAN_FALLTHROUGH;
-        case 0x64:
-            ZYAN_FALLTHROUGH;
-        case 0x65:
-            state->prefixes.group2 = prefix_byte;
-            state->prefixes.offset_group2 = offset;
-            state->prefixes.effective_segment = prefix_byte;
-            state->prefixes.offset_segment = offset;
-            state->prefixes.offset_notrack = -1;
-            break;
-        case 0x66:
-            // context->prefixes.has_osz_override = ZYAN_TRUE;
-            state->prefixes.offset_osz_override = offset;
-            if (!state->prefixes.mandatory_candidate)
-            {
-                state->prefixes.mandatory_candidate = 0x66;
-                state->prefixes.offset_mandatory = offset;
-            }
-            instruction->attributes |= ZYDIS_ATTRIB_HAS_OPERANDSIZE;
-            break;
-        case 0x67:
-            // context->prefixes.has_asz_override = ZYAN_TRUE;
-            state->prefixes.offset_asz_override = offset;
-            instruction->attributes |= ZYDIS_ATTRIB_HAS_ADDRESSSIZE;
-            break;
-        default:
-            if ((state->decoder->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) &&
-                (prefix_byte & 0xF0) == 0x40)
-            {
-                rex = prefix_byte;
-                instruction->raw.rex.offset = offset;
-            } else
+            return ZYAN_STATUS_SUCCESS;
+        }
+        // Instructions exceeding the length limit are left to the regular path, which reports
+        // the correct error
+        if (count < ZYDIS_MAX_INSTRUCTION_LENGTH)
+        {
+            for (ZyanU8 offset = 0; offset < count; ++offset)
             {
-                done = ZYAN_TRUE;
+                const ZyanBool is_prefix = ZydisCollectOptionalPrefix(state, instruction,
+                    state->buffer[offset], offset, &rex);
+                ZYAN_ASSERT(is_prefix);
+                ZYAN_UNUSED(is_prefix);
             }
-            break;
+            instruction->length = count;
+            state->buffer += count;
+            state->buffer_len -= count;
+            done = ZYAN_TRUE;
         }
+    }
+#endif
+
+    for (ZyanU8 offset = 0; !done; ++offset)
+    {
+        ZyanU8 prefix_byte;
+        ZYAN_CHECK(ZydisInputPeek(state, instruction, &prefix_byte));
+        done = !ZydisCollectOptionalPrefix(state, instruction, prefix_byte, offset, &rex);
         if (!done)
         {
-            // Invalidate `REX`, if it's not the last legacy prefix
-            if (rex && (rex != prefix_byte))
-            {
-                rex = 0x00;
-                instruction->raw.rex.offset = 0;
-            }
-            instruction->raw.prefixes[instruction->raw.prefix_count++].value = prefix_byte;
             ZydisInputSkip(state, instruction);
-            ++offset;
         }
-    } while (!done);
+    }
 
     if (instruction->attributes & ZYDIS_ATTRIB_HAS_OPERANDSIZE)
     {
@@ -3278,7 +3718,7 @@ static ZyanStatus ZydisCollectOptionalPrefixes(ZydisDecoderState* state,
         instruction->raw.prefixes[instruction->raw.rex.offset].type = ZYDIS_PREFIX_TYPE_EFFECTIVE;
         ZydisDecodeREX(state->context, instruction, rex);
     }
-    if ((state->decoder->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+    if ((ZYDIS_MACHINE_MODE(state->decoder->machine_mode) != ZYDIS_MACHINE_MODE_LONG_64) &&
         (state->prefixes.group2 == 0x3E))
     {
         state->prefixes.offset_notrack = state->prefixes.offset_group2;
@@ -3352,7 +3792,8 @@ static ZyanStatus ZydisDecodeOptionalInstructionParts(ZydisDecoderState* state,
                 case 0:
                     if (instruction->raw.modrm.rm == 5)
                     {
-                        if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+                        if (ZYDIS_MACHINE_MODE(instruction->machine_mode) ==
+                            ZYDIS_MACHINE_MODE_LONG_64)
                         {
                             instruction->attributes |= ZYDIS_ATTRIB_IS_RELATIVE;
                         }
@@ -3545,12 +3986,12 @@ static void ZydisSetEffectiveOperandWidth(ZydisDecoderContext* context,
         index = 1;
     }
 
-    if ((instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_COMPAT_32) ||
-        (instruction->machine_mode == ZYDIS_MACHINE_MODE_LEGACY_32))
+    if ((ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_COMPAT_32) ||
+        (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LEGACY_32))
     {
         index += 2;
     }
-    else if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+    else if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
     {
         index += 4;
         index += (context->vector_unified.W & 0x01) << 1;
@@ -3615,12 +4056,12 @@ static void ZydisSetEffectiveAddressWidth(ZydisDecoderContext* context,
     };
 
     ZyanU8 index = (instruction->attributes & ZYDIS_ATTRIB_HAS_ADDRESSSIZE) ? 1 : 0;
-    if ((instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_COMPAT_32) ||
-        (instruction->machine_mode == ZYDIS_MACHINE_MODE_LEGACY_32))
+    if ((ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_COMPAT_32) ||
+        (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LEGACY_32))
     {
         index += 2;
     }
-    else if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+    else if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
     {
         index += 4;
     }
@@ -3747,7 +4188,7 @@ static ZyanStatus ZydisNodeHandlerOpcode(ZydisDecoderState* state,
                 ZyanU8 next_input;
                 ZYAN_CHECK(ZydisInputPeek(state, instruction, &next_input));
                 if (((next_input & 0xF0) >= 0xC0) ||
-                    (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64))
+                    (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64))
                 {
                     if (instruction->attributes & ZYDIS_ATTRIB_HAS_REX)
                     {
@@ -3816,7 +4257,8 @@ static ZyanStatus ZydisNodeHandlerOpcode(ZydisDecoderState* state,
                             // This condition catches the `MVEX` encoded ones to save a bunch of
                             // `mode` filters in the data-tables.
                             // `KNC` instructions with `VEX` encoding still require a `mode` filter.
-                            if (state->decoder->machine_mode != ZYDIS_MACHINE_MODE_LONG_64)
+                            if (ZYDIS_MACHINE_MODE(state->decoder->machine_mode) !=
+                                ZYDIS_MACHINE_MODE_LONG_64)
                             {
                                 return ZYDIS_STATUS_DECODING_ERROR;
                             }
@@ -3904,7 +4346,7 @@ static ZyanStatus ZydisNodeHandlerOpcode(ZydisDecoderState* state,
                     return ZYDIS_STATUS_DECODING_ERROR;
                 }
 
-                if (state->decoder->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+                if (ZYDIS_MACHINE_MODE(state->decoder->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
                 {
                     ZyanU8 rex2;
                     ZYAN_CHECK(ZydisInputNext(state, instruction, &rex2));
@@ -4009,7 +4451,7 @@ static ZyanStatus ZydisNodeHandlerMode(const ZydisDecodedInstruction* instructio
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(index);
 
-    switch (instruction->machine_mode)
+    switch (ZYDIS_MACHINE_MODE(instruction->machine_mode))
     {
     case ZYDIS_MACHINE_MODE_LONG_COMPAT_16:
     case ZYDIS_MACHINE_MODE_LEGACY_16:
@@ -4035,7 +4477,7 @@ static ZyanStatus ZydisNodeHandlerModeCompact(const ZydisDecodedInstruction* ins
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(index);
 
-    *index = (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) ? 0 : 1;
+    *index = (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64) ? 0 : 1;
     return ZYAN_STATUS_SUCCESS;
 }
 
@@ -4142,7 +4584,7 @@ static ZyanStatus ZydisNodeHandlerOperandSize(const ZydisDecoderState* state,
     ZYAN_ASSERT(instruction);
     ZYAN_ASSERT(index);
 
-    if ((instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) &&
+    if ((ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64) &&
         (state->context->vector_unified.W))
     {
         *index = 2;
@@ -4153,7 +4595,7 @@ static ZyanStatus ZydisNodeHandlerOperandSize(const ZydisDecoderState* state,
             instruction->raw.prefixes[state->prefixes.offset_osz_override].type =
                 ZYDIS_PREFIX_TYPE_EFFECTIVE;
         }
-        switch (instruction->machine_mode)
+        switch (ZYDIS_MACHINE_MODE(instruction->machine_mode))
         {
         case ZYDIS_MACHINE_MODE_LONG_COMPAT_16:
         case ZYDIS_MACHINE_MODE_LEGACY_16:
@@ -4183,7 +4625,7 @@ static ZyanStatus ZydisNodeHandlerAddressSize(ZydisDecodedInstruction* instructi
         instruction->raw.prefixes[context->prefixes.offset_asz_override].type =
             ZYDIS_PREFIX_TYPE_EFFECTIVE;
     }*/
-    switch (instruction->machine_mode)
+    switch (ZYDIS_MACHINE_MODE(instruction->machine_mode))
     {
     case ZYDIS_MACHINE_MODE_LONG_COMPAT_16:
     case ZYDIS_MACHINE_MODE_LEGACY_16:
@@ -4494,7 +4936,8 @@ static ZyanStatus ZydisPopulateRegisterIds(ZydisDecoderContext* context,
         addressed is a control or debug register.
     */
 
-    const ZyanBool is_64_bit  = (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64);
+    const ZyanBool is_64_bit  =
+        (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64);
     const ZyanBool is_mod_reg = context->reg_info.is_mod_reg;
     const ZyanBool has_sib    = !is_mod_reg && (instruction->raw.modrm.rm == 4);
     const ZyanBool has_vsib   = has_sib && (def_rm == ZYDIS_MEMOP_TYPE_VSIB);
@@ -4506,7 +4949,7 @@ static ZyanStatus ZydisPopulateRegisterIds(ZydisDecoderContext* context,
     ZyanU8 id_base  = has_sib ? instruction->raw.sib.base : instruction->raw.modrm.rm;
     ZyanU8 id_index = instruction->raw.sib.index;
 
-    if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+    if (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64)
     {
         const ZyanBool supports_rm4 = is_rex2 || 
                                       (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_EVEX) ||
@@ -4750,14 +5193,14 @@ static ZyanStatus ZydisCheckErrorConditions(ZydisDecoderState* state,
             (const ZydisInstructionDefinitionLEGACY*)definition;
 
         if (def->requires_protected_mode &&
-            (instruction->machine_mode == ZYDIS_MACHINE_MODE_REAL_16))
+            (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_REAL_16))
         {
             return ZYDIS_STATUS_DECODING_ERROR;
         }
 
         if (def->no_compat_mode &&
-            ((instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_COMPAT_16) ||
-             (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_COMPAT_32)))
+            ((ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_COMPAT_16) ||
+             (ZYDIS_MACHINE_MODE(instruction->machine_mode) == ZYDIS_MACHINE_MODE_LONG_COMPAT_32)))
         {
             return ZYDIS_STATUS_DECODING_ERROR;
         }
@@ -4917,7 +5360,7 @@ static ZyanStatus ZydisCheckErrorConditions(ZydisDecoderState* state,
     if (no_rip_rel)
     {
         const ZyanBool is_rip_rel =
-            (state->decoder->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) &&
+            (ZYDIS_MACHINE_MODE(state->decoder->machine_mode) == ZYDIS_MACHINE_MODE_LONG_64) &&
             (instruction->raw.modrm.mod == 0) && (instruction->raw.modrm.rm == 5);
         if (is_rip_rel)
         {
@@ -5067,6 +5510,7 @@ static ZyanStatus ZydisDecodeInstruction(ZydisDecoderState* state,
     do
     {
         const ZydisDecoderTreeNodeType node_type = ZYDIS_DT_GET_TYPE(node);
+        ZYDIS_STATS_NODE(state, node_type);
         ZyanU16 index = 0;
         ZyanStatus status = 0;
         switch (node_type)
@@ -5152,34 +5596,16 @@ static ZyanStatus ZydisDecodeInstruction(ZydisDecoderState* state,
             break;
 #endif
         case ZYDIS_NODETYPE_MODE_AMD:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_AMD_BRANCHES);
-            break;
         case ZYDIS_NODETYPE_MODE_KNC:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_KNC);
-            break;
         case ZYDIS_NODETYPE_MODE_MPX:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_MPX);
-            break;
         case ZYDIS_NODETYPE_MODE_CET:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_CET);
-            break;
         case ZYDIS_NODETYPE_MODE_LZCNT:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_LZCNT);
-            break;
         case ZYDIS_NODETYPE_MODE_TZCNT:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_TZCNT);
-            break;
         case ZYDIS_NODETYPE_MODE_WBNOINVD:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_WBNOINVD);
-            break;
         case ZYDIS_NODETYPE_MODE_CLDEMOTE:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_CLDEMOTE);
-            break;
         case ZYDIS_NODETYPE_MODE_IPREFETCH:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_IPREFETCH);
-            break;
         case ZYDIS_NODETYPE_MODE_UD0_COMPAT:
-            index = ZYDIS_DECODER_MODE_ACTIVE(state->decoder, ZYDIS_DECODER_MODE_UD0_COMPAT);
+            index = ZYDIS_DT_RESOLVE_DECODER_MODE_NODE(state->decoder, node_type);
             break;
         case ZYDIS_NODETYPE_EVEX_ND:
             status = ZydisNodeHandlerEvexND(state->context, instruction, &index);
@@ -5334,6 +5760,20 @@ static ZyanStatus ZydisDecodeInstruction(ZydisDecoderState* state,
             return ZYDIS_STATUS_DECODING_ERROR;
         }
 
+        // Follow decoder mode nodes directly instead of dispatching them one by one.
+        // Empty entries are left to the regular path above
+        while (ZYDIS_DT_IS_DECODER_MODE_NODE(ZYDIS_DT_GET_TYPE(node)))
+        {
+            const ZyanU16 next = ZYDIS_DT_GET_VALUE(node,
+                ZYDIS_DT_RESOLVE_DECODER_MODE_NODE(state->decoder, ZYDIS_DT_GET_TYPE(node)));
+            if (!next)
+            {
+                break;
+            }
+            ZYDIS_STATS_NODE(state, ZYDIS_DT_GET_TYPE(node));
+            node += next;
+        }
+
     } while (ZYAN_TRUE);
 }
 
@@ -5347,6 +5787,25 @@ ZyanStatus ZydisDecoderInit(ZydisDecoder* decoder, ZydisMachineMode machine_mode
     ZydisStackWidth stack_width)
 {
     ZYAN_STATIC_ASSERT(ZYDIS_DECODER_MODE_MAX_VALUE <= 32);
+    // Required by `ZYDIS_DT_RESOLVE_DECODER_MODE_NODE`
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_KNC - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_KNC - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_MPX - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_MPX - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_CET - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_CET - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_LZCNT - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_LZCNT - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_TZCNT - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_TZCNT - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_WBNOINVD - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_WBNOINVD - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_CLDEMOTE - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_CLDEMOTE - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_IPREFETCH - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_IPREFETCH - ZYDIS_DECODER_MODE_AMD_BRANCHES);
+    ZYAN_STATIC_ASSERT(ZYDIS_NODETYPE_MODE_UD0_COMPAT - ZYDIS_NODETYPE_MODE_AMD ==
+        ZYDIS_DECODER_MODE_UD0_COMPAT - ZYDIS_DECODER_MODE_AMD_BRANCHES);
 
     static const ZyanU32 decoder_modes =
 #ifdef ZYDIS_MINIMAL_MODE
@@ -5372,6 +5831,7 @@ ZyanStatus ZydisDecoderInit(ZydisDecoder* decoder, ZydisMachineMode machine_mode
             return ZYAN_STATUS_INVALID_ARGUMENT;
         }
         break;
+#ifndef ZYDIS_DISABLE_LEGACY_MODES
     case ZYDIS_MACHINE_MODE_LONG_COMPAT_32:
     case ZYDIS_MACHINE_MODE_LONG_COMPAT_16:
     case ZYDIS_MACHINE_MODE_LEGACY_32:
@@ -5382,6 +5842,7 @@ ZyanStatus ZydisDecoderInit(ZydisDecoder* decoder, ZydisMachineMode machine_mode
             return ZYAN_STATUS_INVALID_ARGUMENT;
         }
         break;
+#endif
     default:
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
@@ -5463,7 +5924,8 @@ ZyanStatus ZydisDecoderDecodeInstruction(const ZydisDecoder* decoder, ZydisDecod
     ZYAN_MEMSET(&state, 0, sizeof(state));
     state.decoder = decoder;
     state.buffer = (const ZyanU8*)buffer;
-    state.buffer_len = length;
+    state.buffer_len = ZYAN_MIN(length, ZYDIS_MAX_INSTRUCTION_LENGTH);
+    state.padded = (length >= ZYDIS_DECODER_PADDED_LENGTH);
     state.prefixes.offset_notrack = -1;
 
     ZydisDecoderContext default_context;
@@ -5479,8 +5941,13 @@ ZyanStatus ZydisDecoderDecodeInstruction(const ZydisDecoder* decoder, ZydisDecod
     instruction->machine_mode = decoder->machine_mode;
     instruction->stack_width = 16 << decoder->stack_width;
 
-    ZYAN_CHECK(ZydisCollectOptionalPrefixes(&state, instruction));
-    ZYAN_CHECK(ZydisDecodeInstruction(&state, instruction));
+    ZyanStatus status = ZydisCollectOptionalPrefixes(&state, instruction);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZydisDecodeInstruction(&state, instruction);
+    }
+    ZYDIS_STATS_RESULT(&state, instruction, status);
+    ZYAN_CHECK(status);
 
     instruction->raw.encoding2 = instruction->encoding;
 
@@ -5525,4 +5992,154 @@ ZyanStatus ZydisDecoderDecodeOperands(const ZydisDecoder* decoder,
 #endif
 }
 
+ZyanStatus ZydisDecoderDecodeOperand(const ZydisDecoder* decoder,
+    const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction, ZyanU8 index,
+    ZydisDecodedOperand* operand)
+{
+#ifdef ZYDIS_MINIMAL_MODE
+
+    ZYAN_UNUSED(decoder);
+    ZYAN_UNUSED(context);
+    ZYAN_UNUSED(instruction);
+    ZYAN_UNUSED(index);
+    ZYAN_UNUSED(operand);
+
+    return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+
+#else
+
+    if (!decoder || !context || !context->definition || !instruction || !operand ||
+        (index >= instruction->operand_count))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ZYDIS_DECODER_MODE_ACTIVE(decoder, ZYDIS_DECODER_MODE_MINIMAL))
+    {
+        return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+    }
+
+    const ZydisOperandDefinition* definitions = ZydisGetOperandDefinitions(context->definition);
+    ZyanU8 imm_id = 0;
+    for (ZyanU8 i = 0; i < index; ++i)
+    {
+        if (ZydisIsRawImmediateOperand(&definitions[i]))
+        {
+            ++imm_id;
+        }
+    }
+
+    ZYAN_MEMSET(operand, 0, sizeof(*operand));
+    return ZydisDecodeOperand(decoder, context, instruction, operand, &definitions[index], index,
+        imm_id);
+
+#endif
+}
+
+ZyanStatus ZydisDecoderFindOperand(const ZydisDecoder* decoder,
+    const ZydisDecoderContext* context, const ZydisDecodedInstruction* instruction,
+    ZydisOperandMatch match, ZydisDecodedOperand* operand)
+{
+#ifdef ZYDIS_MINIMAL_MODE
+
+    ZYAN_UNUSED(decoder);
+    ZYAN_UNUSED(context);
+    ZYAN_UNUSED(instruction);
+    ZYAN_UNUSED(match);
+    ZYAN_UNUSED(operand);
+
+    return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+
+#else
+
+    if (!decoder || !context || !context->definition || !instruction || !operand)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ZYDIS_DECODER_MODE_ACTIVE(decoder, ZYDIS_DECODER_MODE_MINIMAL))
+    {
+        return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+    }
+
+    const ZydisOperandDefinition* definitions = ZydisGetOperandDefinitions(context->definition);
+    ZyanU8 imm_id = 0;
+    for (ZyanU8 i = 0; i < instruction->operand_count; ++i)
+    {
+        const ZydisOperandDefinition* definition = &definitions[i];
+        if ((OPERAND_RECIPES[definition->type].match & match) &&
+            (!(match & ZYDIS_OPERAND_MATCH_EXPLICIT) ||
+             (definition->visibility == ZYDIS_OPERAND_VISIBILITY_EXPLICIT)))
+        {
+            ZYAN_MEMSET(operand, 0, sizeof(*operand));
+            return ZydisDecodeOperand(decoder, context, instruction, operand, definition, i,
+                imm_id);
+        }
+        if (ZydisIsRawImmediateOperand(definition))
+        {
+            ++imm_id;
+        }
+    }
+
+    return ZYAN_STATUS_NOT_FOUND;
+
+#endif
+}
+
+ZyanStatus ZydisDecoderGetStats(ZydisDecoderStats* stats)
+{
+#ifndef ZYDIS_DECODER_STATS
+
+    ZYAN_UNUSED(stats);
+
+    return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+
+#else
+
+    if (!stats)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    *stats = g_decoder_stats;
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+ZyanStatus ZydisDecoderResetStats(void)
+{
+#ifndef ZYDIS_DECODER_STATS
+
+    return ZYAN_STATUS_MISSING_DEPENDENCY; // TODO: Introduce better status code
+
+#else
+
+    ZYAN_MEMSET(&g_decoder_stats, 0, sizeof(g_decoder_stats));
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+const char* ZydisDecoderStatsGetNodeTypeString(ZyanU8 node_type)
+{
+#ifndef ZYDIS_DECODER_STATS
+
+    ZYAN_UNUSED(node_type);
+
+    return ZYAN_NULL;
+
+#else
+
+    if (node_type >= ZYAN_ARRAY_LENGTH(STR_NODE_TYPE))
+    {
+        return ZYAN_NULL;
+    }
+    return STR_NODE_TYPE[node_type];
+
+#endif
+}
+
 /* ============================================================================================== */
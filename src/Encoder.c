@@ -29,6 +29,7 @@
 // ReSharper disable CppClangTidyClangDiagnosticImplicitFallthrough
 
 #include <Zycore/LibC.h>
+#include <Zydis/Decoder.h>
 #include <Zydis/Encoder.h>
 #include <Zydis/Utils.h>
 #include <Zydis/Internal/EncoderData.h>
@@ -3152,11 +3153,15 @@ static ZydisEncodableEncoding ZydisGetViableEncodings(const ZydisEncoderRequest
  *
  * @param   request     A pointer to `ZydisEncoderRequest` struct.
  * @param   match       A pointer to `ZydisEncoderInstructionMatch` struct.
+ * @param   index       A pointer to the index of the first definition that should be considered.
+ *                      Upon successful return this variable receives the index of the definition
+ *                      following the matched one, which allows enumerating all compatible
+ *                      definitions.
  *
  * @return  A zyan status code.
  */
 static ZyanStatus ZydisFindMatchingDefinition(const ZydisEncoderRequest *request,
-    ZydisEncoderInstructionMatch *match)
+    ZydisEncoderInstructionMatch *match, ZyanU8 *index)
 {
     ZYAN_MEMSET(match, 0, sizeof(ZydisEncoderInstructionMatch));
     match->request = request;
@@ -3178,7 +3183,8 @@ static ZyanStatus ZydisFindMatchingDefinition(const ZydisEncoderRequest *request
         return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
     }
 
-    for (ZyanU8 i = 0; i < definition_count; ++i, ++definition)
+    definition += *index;
+    for (ZyanU8 i = *index; i < definition_count; ++i, ++definition)
     {
         if (definition->operand_mask != operand_mask)
         {
@@ -3355,6 +3361,7 @@ static ZyanStatus ZydisFindMatchingDefinition(const ZydisEncoderRequest *request
             continue;
         }
 
+        *index = i + 1;
         return ZYAN_STATUS_SUCCESS;
     }
 
@@ -3830,14 +3837,14 @@ static ZyanStatus ZydisEmitMvex(ZydisEncoderInstruction *instruction, ZydisEncod
 }
 
 /**
- * Emits instruction as stream of bytes.
+ * Emits legacy prefixes followed by the `REX`/`REX2`/`XOP`/`VEX`/`EVEX`/`MVEX` prefix.
  *
  * @param   instruction     A pointer to `ZydisEncoderInstruction` struct.
  * @param   buffer          A pointer to `ZydisEncoderBuffer` struct.
  *
  * @return  A zyan status code.
  */
-static ZyanStatus ZydisEmitInstruction(ZydisEncoderInstruction *instruction,
+static ZyanStatus ZydisEmitPrefixes(ZydisEncoderInstruction *instruction,
     ZydisEncoderBuffer *buffer)
 {
     ZYAN_CHECK(ZydisEmitLegacyPrefixes(instruction, buffer));
@@ -3864,6 +3871,22 @@ static ZyanStatus ZydisEmitInstruction(ZydisEncoderInstruction *instruction,
         ZYAN_UNREACHABLE;
     }
 
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * Emits instruction as stream of bytes.
+ *
+ * @param   instruction     A pointer to `ZydisEncoderInstruction` struct.
+ * @param   buffer          A pointer to `ZydisEncoderBuffer` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisEmitInstruction(ZydisEncoderInstruction *instruction,
+    ZydisEncoderBuffer *buffer)
+{
+    ZYAN_CHECK(ZydisEmitPrefixes(instruction, buffer));
+
     switch (instruction->opcode_map)
     {
     case ZYDIS_OPCODE_MAP_DEFAULT:
@@ -4412,6 +4435,84 @@ static ZyanStatus ZydisBuildInstruction(ZydisEncoderInstructionMatch *match,
     return ZYAN_STATUS_SUCCESS;
 }
 
+/**
+ * Calculates the cost of the given match according to the search mode of the request.
+ *
+ * @param   match   A pointer to `ZydisEncoderInstructionMatch` struct.
+ * @param   cost    Receives the cost of the match (lower is better).
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisGetMatchCost(const ZydisEncoderInstructionMatch *match, ZyanU32 *cost)
+{
+    ZydisEncoderInstructionMatch candidate = *match;
+    ZydisEncoderInstruction instruction;
+    ZYAN_CHECK(ZydisBuildInstruction(&candidate, &instruction));
+
+    ZyanU8 data[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    ZydisEncoderBuffer output;
+    output.buffer = data;
+    output.size = sizeof(data);
+    output.offset = 0;
+    ZydisEncoderInstruction copy = instruction;
+    ZYAN_CHECK(ZydisEmitPrefixes(&copy, &output));
+    const ZyanU32 prefix_length = (ZyanU32)output.offset;
+    output.offset = 0;
+    ZYAN_CHECK(ZydisEmitInstruction(&instruction, &output));
+    const ZyanU32 length = (ZyanU32)output.offset;
+
+    // Both values are bounded by `ZYDIS_MAX_INSTRUCTION_LENGTH`, the secondary criterion breaks
+    // ties between candidates
+    switch (match->request->search_mode)
+    {
+    case ZYDIS_ENCODER_SEARCH_MODE_SHORTEST:
+        *cost = (length << 4) | prefix_length;
+        break;
+    case ZYDIS_ENCODER_SEARCH_MODE_FEWEST_PREFIXES:
+        *cost = (prefix_length << 4) | length;
+        break;
+    default:
+        ZYAN_UNREACHABLE;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * Evaluates all instruction definitions compatible with provided encoder request and picks the
+ * cheapest one according to `ZydisEncoderRequest.search_mode`.
+ *
+ * @param   request     A pointer to `ZydisEncoderRequest` struct.
+ * @param   match       A pointer to `ZydisEncoderInstructionMatch` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisFindOptimalDefinition(const ZydisEncoderRequest *request,
+    ZydisEncoderInstructionMatch *match)
+{
+    ZyanStatus status = ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+    ZyanU32 best_cost = ZYAN_UINT32_MAX;
+    ZyanU8 index = 0;
+    ZydisEncoderInstructionMatch candidate;
+    while (ZYAN_SUCCESS(ZydisFindMatchingDefinition(request, &candidate, &index)))
+    {
+        ZyanU32 cost;
+        status = ZydisGetMatchCost(&candidate, &cost);
+        if (ZYAN_FAILED(status))
+        {
+            continue;
+        }
+        // Strict comparison keeps the table order for candidates of equal cost
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            *match = candidate;
+        }
+    }
+
+    return (best_cost != ZYAN_UINT32_MAX) ? ZYAN_STATUS_SUCCESS : status;
+}
+
 /**
  * Performs a set of sanity checks that must be satisfied for every valid encoder request.
  *
@@ -4434,6 +4535,7 @@ static ZyanStatus ZydisEncoderCheckRequestSanity(const ZydisEncoderRequest *requ
         ((ZyanUSize)request->mvex.conversion > ZYDIS_CONVERSION_MODE_MAX_VALUE) ||
         ((ZyanUSize)request->mvex.rounding > ZYDIS_ROUNDING_MODE_MAX_VALUE) ||
         ((ZyanUSize)request->mvex.swizzle > ZYDIS_SWIZZLE_MODE_MAX_VALUE) ||
+        ((ZyanUSize)request->search_mode > ZYDIS_ENCODER_SEARCH_MODE_MAX_VALUE) ||
         (request->operand_count > ZYDIS_ENCODER_MAX_OPERANDS) ||
         (request->mnemonic == ZYDIS_MNEMONIC_INVALID) ||
         (request->prefixes & ~ZYDIS_ENCODABLE_PREFIXES) ||
@@ -4603,7 +4705,15 @@ static ZyanStatus ZydisEncoderEncodeInstructionInternal(const ZydisEncoderReques
     void *buffer, ZyanUSize *length, ZydisEncoderInstruction *instruction)
 {
     ZydisEncoderInstructionMatch match;
-    ZYAN_CHECK(ZydisFindMatchingDefinition(request, &match));
+    if (request->search_mode == ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH)
+    {
+        ZyanU8 index = 0;
+        ZYAN_CHECK(ZydisFindMatchingDefinition(request, &match, &index));
+    }
+    else
+    {
+        ZYAN_CHECK(ZydisFindOptimalDefinition(request, &match));
+    }
     ZydisEncoderBuffer output;
     output.buffer = (ZyanU8 *)buffer;
     output.size = *length > ZYDIS_MAX_INSTRUCTION_LENGTH
@@ -4625,71 +4735,923 @@ static ZyanStatus ZydisEncoderEncodeInstructionInternal(const ZydisEncoderReques
     return ZYAN_STATUS_SUCCESS;
 }
 
-/* ============================================================================================== */
-/* Exported functions                                                                             */
-/* ============================================================================================== */
+/**
+ * Checks if the given value can be stored in a field of the given size without changing its
+ * meaning.
+ *
+ * @param   value       The value.
+ * @param   size        The size of the field in bits.
+ * @param   is_signed   `ZYAN_TRUE`, if the field is sign-extended by the CPU.
+ *
+ * @return  `ZYAN_TRUE`, if the value fits or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisReEncodeIsValueFit(ZyanI64 value, ZyanU8 size, ZyanBool is_signed)
+{
+    if (size == 64)
+    {
+        return ZYAN_TRUE;
+    }
+    return is_signed
+        ? ZydisGetSignedImmSize(value) <= size
+        : ZydisGetUnsignedImmSize((ZyanU64)value) <= size;
+}
 
-ZYDIS_EXPORT ZyanStatus ZydisEncoderEncodeInstruction(const ZydisEncoderRequest *request,
-    void *buffer, ZyanUSize *length)
+/**
+ * Returns the bits of the first raw immediate that hold an immediate value, as opposed to an
+ * `IS4` encoded register specifier.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ *
+ * @return  `0xFF` for regular immediates, `0x0F` if the upper half encodes a register and the
+ *          lower half a 4-bit immediate or `0x00` if the immediate only encodes a register.
+ */
+static ZyanU8 ZydisReEncodeGetImmediateMask(const ZydisDecodedInstruction *instruction,
+    const ZydisDecoderContext *context)
 {
-    if (!request || !buffer || !length)
+    const ZydisOperandDefinition *definitions = ZydisGetOperandDefinitions(
+        (const ZydisInstructionDefinition *)context->definition);
+    ZyanBool has_is4_register = ZYAN_FALSE;
+    ZyanBool has_is4_immediate = ZYAN_FALSE;
+    for (ZyanU8 i = 0; i < instruction->operand_count; ++i)
+    {
+        const ZydisOperandDefinition *definition = &definitions[i];
+        switch (definition->type)
+        {
+        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_REG:
+        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_MEM:
+        case ZYDIS_SEMANTIC_OPTYPE_IMPLICIT_IMM1:
+            continue;
+        default:
+            break;
+        }
+        if (ZydisGetOperandDetails(definition)->encoding != ZYDIS_OPERAND_ENCODING_IS4)
+        {
+            continue;
+        }
+        if (definition->type == ZYDIS_SEMANTIC_OPTYPE_IMM)
+        {
+            has_is4_immediate = ZYAN_TRUE;
+        }
+        else
+        {
+            has_is4_register = ZYAN_TRUE;
+        }
+    }
+
+    if (!has_is4_register)
     {
-        return ZYAN_STATUS_INVALID_ARGUMENT;
+        return 0xFF;
     }
-    ZYAN_CHECK(ZydisEncoderCheckRequestSanity(request));
+    return has_is4_immediate ? 0x0F : 0x00;
+}
 
-    ZydisEncoderInstruction instruction;
-    return ZydisEncoderEncodeInstructionInternal(request, buffer, length, &instruction);
+/**
+ * Checks if the given instruction contains an `EIP`/`RIP`-relative memory operand.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction contains an `EIP`/`RIP`-relative memory operand or
+ *          `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisReEncodeIsRipRelative(const ZydisDecodedInstruction *instruction)
+{
+    return (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) &&
+           (instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM) &&
+           (instruction->raw.modrm.mod == 0) &&
+           (instruction->raw.modrm.rm == 5) &&
+           (instruction->raw.disp.size == 32);
 }
 
-ZYDIS_EXPORT ZyanStatus ZydisEncoderEncodeInstructionAbsolute(ZydisEncoderRequest *request,
-    void *buffer, ZyanUSize *length, ZyanU64 runtime_address)
+/**
+ * Rebuilds the physical instruction bytes from the `raw` fields of a decoded instruction.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   bytes       A pointer to a buffer of at least `ZYDIS_MAX_INSTRUCTION_LENGTH` bytes.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisReEncodeRawBytes(const ZydisDecodedInstruction *instruction,
+    ZyanU8 *bytes)
 {
-    if (!request || !buffer || !length)
+    ZydisEncoderBuffer output;
+    output.buffer = bytes;
+    output.size = ZYDIS_MAX_INSTRUCTION_LENGTH;
+    output.offset = 0;
+
+    for (ZyanU8 i = 0; i < instruction->raw.prefix_count; ++i)
+    {
+        ZYAN_CHECK(ZydisEmitByte(instruction->raw.prefixes[i].value, &output));
+    }
+
+    switch (instruction->encoding)
+    {
+    case ZYDIS_INSTRUCTION_ENCODING_LEGACY:
+    case ZYDIS_INSTRUCTION_ENCODING_3DNOW:
+        switch (instruction->opcode_map)
+        {
+        case ZYDIS_OPCODE_MAP_DEFAULT:
+            break;
+        case ZYDIS_OPCODE_MAP_0F:
+            ZYAN_CHECK(ZydisEmitByte(0x0F, &output));
+            break;
+        case ZYDIS_OPCODE_MAP_0F0F:
+            ZYAN_CHECK(ZydisEmitUInt(0x0F0F, 2, &output));
+            break;
+        case ZYDIS_OPCODE_MAP_0F38:
+            ZYAN_CHECK(ZydisEmitUInt(0x380F, 2, &output));
+            break;
+        case ZYDIS_OPCODE_MAP_0F3A:
+            ZYAN_CHECK(ZydisEmitUInt(0x3A0F, 2, &output));
+            break;
+        default:
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        break;
+    case ZYDIS_INSTRUCTION_ENCODING_REX2:
+        ZYAN_CHECK(ZydisEmitByte(0xD5, &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.rex2.M0 << 7) | (instruction->raw.rex2.R4 << 6) |
+            (instruction->raw.rex2.X4 << 5) | (instruction->raw.rex2.B4 << 4) |
+            (instruction->raw.rex2.W  << 3) | (instruction->raw.rex2.R3 << 2) |
+            (instruction->raw.rex2.X3 << 1) | (instruction->raw.rex2.B3 << 0)), &output));
+        break;
+    case ZYDIS_INSTRUCTION_ENCODING_XOP:
+        ZYAN_CHECK(ZydisEmitByte(0x8F, &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.xop.R << 7) | (instruction->raw.xop.X << 6) |
+            (instruction->raw.xop.B << 5) | (instruction->raw.xop.m_mmmm)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.xop.W << 7) | (instruction->raw.xop.vvvv << 3) |
+            (instruction->raw.xop.L << 2) | (instruction->raw.xop.pp)), &output));
+        break;
+    case ZYDIS_INSTRUCTION_ENCODING_VEX:
+        if (instruction->raw.vex.size == 2)
+        {
+            ZYAN_CHECK(ZydisEmitByte(0xC5, &output));
+            ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+                (instruction->raw.vex.R << 7) | (instruction->raw.vex.vvvv << 3) |
+                (instruction->raw.vex.L << 2) | (instruction->raw.vex.pp)), &output));
+            break;
+        }
+        ZYAN_CHECK(ZydisEmitByte(0xC4, &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.vex.R << 7) | (instruction->raw.vex.X << 6) |
+            (instruction->raw.vex.B << 5) | (instruction->raw.vex.m_mmmm)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.vex.W << 7) | (instruction->raw.vex.vvvv << 3) |
+            (instruction->raw.vex.L << 2) | (instruction->raw.vex.pp)), &output));
+        break;
+    case ZYDIS_INSTRUCTION_ENCODING_EVEX:
+        ZYAN_CHECK(ZydisEmitByte(0x62, &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.evex.R3 << 7) | (instruction->raw.evex.X3 << 6) |
+            (instruction->raw.evex.B3 << 5) | (instruction->raw.evex.R4 << 4) |
+            (instruction->raw.evex.B4 << 3) | (instruction->raw.evex.mmm)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.evex.W << 7) | (instruction->raw.evex.vvvv << 3) |
+            (instruction->raw.evex.U << 2) | (instruction->raw.evex.pp)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.evex.z << 7) | (instruction->raw.evex.L2 << 6) |
+            (instruction->raw.evex.L << 5) | (instruction->raw.evex.b << 4) |
+            (instruction->raw.evex.V4 << 3) | (instruction->raw.evex.aaa)), &output));
+        break;
+    case ZYDIS_INSTRUCTION_ENCODING_MVEX:
+        ZYAN_CHECK(ZydisEmitByte(0x62, &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.mvex.R << 7) | (instruction->raw.mvex.X << 6) |
+            (instruction->raw.mvex.B << 5) | (instruction->raw.mvex.R2 << 4) |
+            (instruction->raw.mvex.mmmm)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.mvex.W << 7) | (instruction->raw.mvex.vvvv << 3) |
+            (instruction->raw.mvex.pp)), &output));
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)(
+            (instruction->raw.mvex.E << 7) | (instruction->raw.mvex.SSS << 4) |
+            (instruction->raw.mvex.V2 << 3) | (instruction->raw.mvex.kkk)), &output));
+        break;
+    default:
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (instruction->encoding != ZYDIS_INSTRUCTION_ENCODING_3DNOW)
+    {
+        ZYAN_CHECK(ZydisEmitByte(instruction->opcode, &output));
+    }
+    if (instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM)
+    {
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)((instruction->raw.modrm.mod << 6) |
+            (instruction->raw.modrm.reg << 3) | instruction->raw.modrm.rm), &output));
+    }
+    if (instruction->attributes & ZYDIS_ATTRIB_HAS_SIB)
+    {
+        ZYAN_CHECK(ZydisEmitByte((ZyanU8)((instruction->raw.sib.scale << 6) |
+            (instruction->raw.sib.index << 3) | instruction->raw.sib.base), &output));
+    }
+    if (instruction->raw.disp.size)
+    {
+        ZYAN_CHECK(ZydisEmitUInt((ZyanU64)instruction->raw.disp.value,
+            instruction->raw.disp.size / 8, &output));
+    }
+    for (ZyanU8 i = 0; i < ZYAN_ARRAY_LENGTH(instruction->raw.imm); ++i)
+    {
+        if (instruction->raw.imm[i].size)
+        {
+            ZYAN_CHECK(ZydisEmitUInt(instruction->raw.imm[i].value.u,
+                instruction->raw.imm[i].size / 8, &output));
+        }
+    }
+    if (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_3DNOW)
+    {
+        ZYAN_CHECK(ZydisEmitByte(instruction->opcode, &output));
+    }
+
+    // Any mismatch indicates a malformed (or not fully decoded) instruction
+    if (output.offset != instruction->length)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    ZYAN_CHECK(ZydisEncoderCheckRequestSanity(request));
 
-    const ZydisEncoderRelInfo *rel_info = ZydisGetRelInfo(request->mnemonic);
-    ZydisEncoderOperand *op_rip_rel = ZYAN_NULL;
-    ZyanBool adjusted_rel = ZYAN_FALSE;
-    ZyanU64 absolute_address = 0;
-    ZyanU8 mode_index = ZydisGetMachineModeWidth(request->machine_mode) >> 5;
-    for (ZyanU8 i = 0; i < request->operand_count; ++i)
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * Applies the requested modifications to the instruction bytes rebuilt by
+ * `ZydisReEncodeRawBytes`, if possible without changing the instruction length.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   patch       A pointer to the `ZydisEncoderPatch` struct.
+ * @param   bytes       A pointer to the rebuilt instruction bytes.
+ *
+ * @return  `ZYAN_TRUE`, if all modifications were applied or `ZYAN_FALSE`, if the instruction
+ *          has to be passed through the full encoder.
+ */
+static ZyanBool ZydisReEncodePatchBytes(const ZydisDecodedInstruction *instruction,
+    const ZydisDecoderContext *context, const ZydisEncoderPatch *patch, ZyanU8 *bytes)
+{
+    ZydisEncoderBuffer output;
+    output.buffer = bytes;
+    output.size = instruction->length;
+
+    if (patch->flags & ZYDIS_ENCODER_PATCH_DISPLACEMENT)
     {
-        ZydisEncoderOperand *op = &request->operands[i];
-        if ((op->type == ZYDIS_OPERAND_TYPE_IMMEDIATE) && rel_info)
+        if (!instruction->raw.disp.size)
         {
-            if (adjusted_rel)
+            return ZYAN_FALSE;
+        }
+        ZyanI64 displacement = patch->displacement;
+        if ((instruction->raw.disp.size == 8) && (context->cd8_scale > 1))
+        {
+            if (displacement % context->cd8_scale)
             {
-                return ZYAN_STATUS_INVALID_ARGUMENT;
+                return ZYAN_FALSE;
             }
+            displacement /= context->cd8_scale;
+        }
+        if (!ZydisReEncodeIsValueFit(displacement, instruction->raw.disp.size, ZYAN_TRUE) &&
+            ((instruction->raw.disp.size != instruction->address_width) ||
+             !ZydisReEncodeIsValueFit(displacement, instruction->raw.disp.size, ZYAN_FALSE)))
+        {
+            return ZYAN_FALSE;
+        }
+        output.offset = instruction->raw.disp.offset;
+        if (!ZYAN_SUCCESS(ZydisEmitUInt((ZyanU64)displacement, instruction->raw.disp.size / 8,
+            &output)))
+        {
+            return ZYAN_FALSE;
+        }
+    }
 
-            switch (rel_info->accepts_scaling_hints)
+    // An `IS4` encoded register operand occupies the upper half of the first immediate
+    const ZyanU8 imm_mask = (patch->flags & ZYDIS_ENCODER_PATCH_IMMEDIATE)
+        ? ZydisReEncodeGetImmediateMask(instruction, context)
+        : 0xFF;
+
+    ZyanI8 imm_index = -1;
+    ZyanI8 rel_index = -1;
+    for (ZyanI8 i = 0; i < (ZyanI8)ZYAN_ARRAY_LENGTH(instruction->raw.imm); ++i)
+    {
+        if (!instruction->raw.imm[i].size)
+        {
+            continue;
+        }
+        if (instruction->raw.imm[i].is_relative)
+        {
+            rel_index = (rel_index < 0) ? i : rel_index;
+        }
+        else if (i || imm_mask)
+        {
+            imm_index = (imm_index < 0) ? i : imm_index;
+        }
+    }
+
+    if (patch->flags & ZYDIS_ENCODER_PATCH_IMMEDIATE)
+    {
+        if (imm_index < 0)
+        {
+            return ZYAN_FALSE;
+        }
+        ZyanU64 immediate = (ZyanU64)patch->immediate;
+        if ((imm_index == 0) && (imm_mask != 0xFF))
+        {
+            if (immediate > imm_mask)
             {
-            case ZYDIS_SIZE_HINT_NONE:
-            case ZYDIS_SIZE_HINT_OSZ:
+                return ZYAN_FALSE;
+            }
+            immediate |= instruction->raw.imm[0].value.u & (ZyanU8)~imm_mask;
+        }
+        else if (!ZydisReEncodeIsValueFit(patch->immediate, instruction->raw.imm[imm_index].size,
+            instruction->raw.imm[imm_index].is_signed))
+        {
+            return ZYAN_FALSE;
+        }
+        output.offset = instruction->raw.imm[imm_index].offset;
+        if (!ZYAN_SUCCESS(ZydisEmitUInt(immediate, instruction->raw.imm[imm_index].size / 8,
+            &output)))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    if (patch->flags & ZYDIS_ENCODER_PATCH_RELATIVE_TARGET)
+    {
+        ZyanI64 rel = (ZyanI64)(patch->target - (patch->runtime_address + instruction->length));
+        if (rel_index >= 0)
+        {
+            if (!ZydisReEncodeIsValueFit(rel, instruction->raw.imm[rel_index].size, ZYAN_TRUE))
             {
-                static const ZyanI8 asz_priority[3][3] =
-                {
-                    { 0, 1, 2 },
-                    { 0, 2, 1 },
-                    { 0, 2, -1 },
-                };
-                static const ZyanI8 osz_priority[3][3] =
-                {
-                    { 0, 1, 2 },
-                    { 0, 2, 1 },
-                    { 0, 2, 1 },
-                };
-                ZyanI8 forced_priority_row[3] = { -1, -1, -1 };
-                ZyanI8 *priority_row = ZYAN_NULL;
-                ZyanU8 extra_length = 0;
-                ZyanU8 start_offset = 0;
-                if (rel_info->accepts_scaling_hints == ZYDIS_SIZE_HINT_NONE)
-                {
-                    if ((request->branch_type == ZYDIS_BRANCH_TYPE_FAR) ||
+                return ZYAN_FALSE;
+            }
+            output.offset = instruction->raw.imm[rel_index].offset;
+            if (!ZYAN_SUCCESS(ZydisEmitUInt((ZyanU64)rel,
+                instruction->raw.imm[rel_index].size / 8, &output)))
+            {
+                return ZYAN_FALSE;
+            }
+        }
+        else
+        {
+            if (!ZydisReEncodeIsRipRelative(instruction))
+            {
+                return ZYAN_FALSE;
+            }
+            if (instruction->address_width == 32)
+            {
+                // `EIP`-relative addresses wrap around at 4GiB
+                rel = (ZyanI32)(ZyanU32)rel;
+            }
+            if (!ZydisReEncodeIsValueFit(rel, 32, ZYAN_TRUE))
+            {
+                return ZYAN_FALSE;
+            }
+            output.offset = instruction->raw.disp.offset;
+            if (!ZYAN_SUCCESS(ZydisEmitUInt((ZyanU64)rel, 4, &output)))
+            {
+                return ZYAN_FALSE;
+            }
+        }
+    }
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * Re-encodes the instruction by converting it to an encoder request, applying the requested
+ * modifications and passing it through the full encoder.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   patch       A pointer to the `ZydisEncoderPatch` struct.
+ * @param   buffer      A pointer to the output buffer receiving encoded instruction.
+ * @param   length      A pointer to the variable containing length of the output buffer. Upon
+ *                      successful return this variable receives length of the encoded instruction.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisReEncodeFallback(const ZydisDecodedInstruction *instruction,
+    const ZydisDecoderContext *context, const ZydisEncoderPatch *patch, void *buffer,
+    ZyanUSize *length)
+{
+    // Operand decoding only depends on machine mode and stack width, the remaining decoder
+    // modes have already been applied while resolving `context->definition`
+    ZydisDecoder decoder;
+    ZYAN_CHECK(ZydisDecoderInit(&decoder, instruction->machine_mode,
+        (ZydisStackWidth)(instruction->stack_width >> 5)));
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+    ZYAN_CHECK(ZydisDecoderDecodeOperands(&decoder, context, instruction, operands,
+        instruction->operand_count));
+
+    ZydisEncoderRequest request;
+    ZYAN_CHECK(ZydisEncoderDecodedInstructionToEncoderRequest(instruction, operands,
+        instruction->operand_count_visible, &request));
+
+    ZyanBool is_relative = ZYAN_FALSE;
+    ZyanBool has_disp = ZYAN_FALSE;
+    ZyanBool has_imm = ZYAN_FALSE;
+    for (ZyanU8 i = 0; i < request.operand_count; ++i)
+    {
+        const ZydisDecodedOperand *dec_op = &operands[i];
+        ZydisEncoderOperand *enc_op = &request.operands[i];
+        ZyanU64 target;
+        switch (dec_op->type)
+        {
+        case ZYDIS_OPERAND_TYPE_MEMORY:
+            if ((dec_op->mem.base == ZYDIS_REGISTER_EIP) ||
+                (dec_op->mem.base == ZYDIS_REGISTER_RIP))
+            {
+                if (patch->flags & ZYDIS_ENCODER_PATCH_RELATIVE_TARGET)
+                {
+                    target = patch->target;
+                }
+                else
+                {
+                    ZYAN_CHECK(ZydisCalcAbsoluteAddress(instruction, dec_op,
+                        patch->runtime_address, &target));
+                }
+                enc_op->mem.displacement = (ZyanI64)target;
+                is_relative = ZYAN_TRUE;
+                break;
+            }
+            if (!has_disp && (patch->flags & ZYDIS_ENCODER_PATCH_DISPLACEMENT))
+            {
+                enc_op->mem.displacement = patch->displacement;
+                has_disp = ZYAN_TRUE;
+            }
+            break;
+        case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+            if (dec_op->imm.is_relative)
+            {
+                if (patch->flags & ZYDIS_ENCODER_PATCH_RELATIVE_TARGET)
+                {
+                    target = patch->target;
+                }
+                else
+                {
+                    ZYAN_CHECK(ZydisCalcAbsoluteAddress(instruction, dec_op,
+                        patch->runtime_address, &target));
+                }
+                enc_op->imm.u = target;
+                is_relative = ZYAN_TRUE;
+                break;
+            }
+            if (!has_imm && (patch->flags & ZYDIS_ENCODER_PATCH_IMMEDIATE))
+            {
+                enc_op->imm.s = patch->immediate;
+                has_imm = ZYAN_TRUE;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (((patch->flags & ZYDIS_ENCODER_PATCH_DISPLACEMENT) && !has_disp) ||
+        ((patch->flags & ZYDIS_ENCODER_PATCH_IMMEDIATE) && !has_imm) ||
+        ((patch->flags & ZYDIS_ENCODER_PATCH_RELATIVE_TARGET) && !is_relative))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (!is_relative)
+    {
+        return ZydisEncoderEncodeInstruction(&request, buffer, length);
+    }
+
+    // Allow the encoder to promote short branches that can't reach the new target
+    if ((request.branch_type == ZYDIS_BRANCH_TYPE_SHORT) ||
+        (request.branch_type == ZYDIS_BRANCH_TYPE_NEAR))
+    {
+        request.branch_type = ZYDIS_BRANCH_TYPE_NONE;
+        request.branch_width = ZYDIS_BRANCH_WIDTH_NONE;
+    }
+
+    return ZydisEncoderEncodeInstructionAbsolute(&request, buffer, length,
+        patch->runtime_address);
+}
+
+/**
+ * Selects the segment prefix that can be added to the given instruction without changing its
+ * semantics.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  The prefix byte or `0`, if no such prefix exists.
+ */
+static ZyanU8 ZydisLengthenGetPaddingPrefix(const ZydisDecodedInstruction *instruction)
+{
+    // `CS`/`DS` act as branch hints and `DS` as `NOTRACK` prefix on branch instructions
+    if (instruction->meta.branch_type != ZYDIS_BRANCH_TYPE_NONE)
+    {
+        return 0;
+    }
+
+    // Repeating an existing segment override is always redundant
+    static const struct
+    {
+        ZydisInstructionAttributes attribute;
+        ZyanU8 prefix;
+    } segments[] =
+    {
+        { ZYDIS_ATTRIB_HAS_SEGMENT_CS, 0x2E },
+        { ZYDIS_ATTRIB_HAS_SEGMENT_SS, 0x36 },
+        { ZYDIS_ATTRIB_HAS_SEGMENT_DS, 0x3E },
+        { ZYDIS_ATTRIB_HAS_SEGMENT_ES, 0x26 },
+        { ZYDIS_ATTRIB_HAS_SEGMENT_FS, 0x64 },
+        { ZYDIS_ATTRIB_HAS_SEGMENT_GS, 0x65 },
+    };
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(segments); ++i)
+    {
+        if (instruction->attributes & segments[i].attribute)
+        {
+            return segments[i].prefix;
+        }
+    }
+
+    // `CS`, `DS`, `ES` and `SS` overrides are ignored in 64-bit mode
+    if (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64)
+    {
+        return 0x2E;
+    }
+
+    return 0;
+}
+
+/**
+ * Grows the displacement field of the given instruction by exactly `growth` bytes.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct to modify.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct.
+ * @param   growth      The number of bytes to add.
+ *
+ * @return  `ZYAN_TRUE`, if the displacement could be grown or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisLengthenDisplacement(ZydisDecodedInstruction *instruction,
+    const ZydisDecoderContext *context, ZyanU8 growth)
+{
+    if (!growth)
+    {
+        return ZYAN_TRUE;
+    }
+    if (!(instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM) || (instruction->raw.modrm.mod == 3))
+    {
+        return ZYAN_FALSE;
+    }
+
+    const ZyanU8 wide_size = (instruction->address_width == 16) ? 16 : 32;
+    ZyanU8 new_size;
+    switch (instruction->raw.modrm.mod)
+    {
+    case 0:
+        // `mod == 0` doubles as disp-only (and `RIP`-relative) form for these `rm`/`base` values
+        if (instruction->address_width == 16)
+        {
+            if (instruction->raw.modrm.rm == 6)
+            {
+                return ZYAN_FALSE;
+            }
+        }
+        else if ((instruction->raw.modrm.rm == 5) ||
+                 ((instruction->raw.modrm.rm == 4) && (instruction->raw.sib.base == 5)))
+        {
+            return ZYAN_FALSE;
+        }
+        if (instruction->raw.disp.size)
+        {
+            return ZYAN_FALSE;
+        }
+        new_size = (ZyanU8)(growth * 8);
+        if ((new_size != 8) && (new_size != wide_size))
+        {
+            return ZYAN_FALSE;
+        }
+        instruction->raw.modrm.mod = (new_size == 8) ? 1 : 2;
+        instruction->raw.disp.value = 0;
+        break;
+    case 1:
+        if ((instruction->raw.disp.size != 8) || (8 + growth * 8 != wide_size))
+        {
+            return ZYAN_FALSE;
+        }
+        new_size = wide_size;
+        instruction->raw.modrm.mod = 2;
+        // `disp32` is never scaled, unlike compressed `disp8 * N`
+        if (context->cd8_scale > 1)
+        {
+            instruction->raw.disp.value *= context->cd8_scale;
+        }
+        break;
+    default:
+        return ZYAN_FALSE;
+    }
+
+    instruction->raw.disp.size = new_size;
+    instruction->length += growth;
+    return ZYAN_TRUE;
+}
+
+/**
+ * Checks if two decoded operands are semantically identical.
+ *
+ * Encoding-specific details like the physical displacement size or offsets are ignored.
+ * `RIP`-relative memory operands are compared by their absolute address, as the displacement
+ * depends on the instruction length.
+ *
+ * @param   a_instruction   A pointer to the `ZydisDecodedInstruction` struct of `a`.
+ * @param   a               A pointer to the first `ZydisDecodedOperand` struct.
+ * @param   b_instruction   A pointer to the `ZydisDecodedInstruction` struct of `b`.
+ * @param   b               A pointer to the second `ZydisDecodedOperand` struct.
+ *
+ * @return  `ZYAN_TRUE`, if both operands are equivalent or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisLengthenIsSameOperand(const ZydisDecodedInstruction *a_instruction,
+    const ZydisDecodedOperand *a, const ZydisDecodedInstruction *b_instruction,
+    const ZydisDecodedOperand *b)
+{
+    if ((a->type != b->type) ||
+        (a->visibility != b->visibility) ||
+        (a->actions != b->actions) ||
+        (a->size != b->size) ||
+        (a->element_type != b->element_type) ||
+        (a->element_size != b->element_size) ||
+        (a->element_count != b->element_count))
+    {
+        return ZYAN_FALSE;
+    }
+
+    switch (a->type)
+    {
+    case ZYDIS_OPERAND_TYPE_REGISTER:
+        return a->reg.value == b->reg.value;
+    case ZYDIS_OPERAND_TYPE_MEMORY:
+    {
+        if ((a->mem.type != b->mem.type) ||
+            (a->mem.segment != b->mem.segment) ||
+            (a->mem.base != b->mem.base) ||
+            (a->mem.index != b->mem.index) ||
+            (a->mem.scale != b->mem.scale))
+        {
+            return ZYAN_FALSE;
+        }
+        if ((a->mem.base != ZYDIS_REGISTER_RIP) && (a->mem.base != ZYDIS_REGISTER_EIP))
+        {
+            return a->mem.disp.value == b->mem.disp.value;
+        }
+        // Both instructions start at the same address
+        ZyanU64 a_address;
+        ZyanU64 b_address;
+        return ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(a_instruction, a, 0, &a_address)) &&
+               ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(b_instruction, b, 0, &b_address)) &&
+               (a_address == b_address);
+    }
+    case ZYDIS_OPERAND_TYPE_POINTER:
+        return (a->ptr.segment == b->ptr.segment) && (a->ptr.offset == b->ptr.offset);
+    case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+        return (a->imm.is_signed == b->imm.is_signed) &&
+               (a->imm.is_relative == b->imm.is_relative) &&
+               (a->imm.value.u == b->imm.value.u);
+    default:
+        return ZYAN_TRUE;
+    }
+}
+
+/**
+ * Checks if the given lengthened bytes decode to an instruction that is semantically identical
+ * to the original one.
+ *
+ * @param   decoder     A pointer to the `ZydisDecoder` instance matching the original
+ *                      instruction.
+ * @param   instruction A pointer to the original `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisDecoderContext` struct of the original instruction.
+ * @param   bytes       A pointer to the lengthened instruction bytes.
+ * @param   length      The length of the lengthened instruction.
+ *
+ * @return  `ZYAN_TRUE`, if both instructions are equivalent or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisLengthenIsEquivalent(const ZydisDecoder *decoder,
+    const ZydisDecodedInstruction *instruction, const ZydisDecoderContext *context,
+    const ZyanU8 *bytes, ZyanU8 length)
+{
+    ZydisDecoderContext check_context;
+    ZydisDecodedInstruction check;
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, &check_context, bytes, length,
+            &check)))
+    {
+        return ZYAN_FALSE;
+    }
+
+    // `MOV CR` ignores `mod`, `REX.W` may be ignored, etc., so compare everything that matters
+    if ((check.length != length) ||
+        (check.mnemonic != instruction->mnemonic) ||
+        (check.encoding != instruction->encoding) ||
+        (check.opcode_map != instruction->opcode_map) ||
+        (check.opcode != instruction->opcode) ||
+        (check.operand_width != instruction->operand_width) ||
+        (check.address_width != instruction->address_width) ||
+        (check.stack_width != instruction->stack_width) ||
+        (check.operand_count != instruction->operand_count) ||
+        (check.operand_count_visible != instruction->operand_count_visible))
+    {
+        return ZYAN_FALSE;
+    }
+    if (instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM)
+    {
+        if (!(check.attributes & ZYDIS_ATTRIB_HAS_MODRM) ||
+            (check.raw.modrm.reg != instruction->raw.modrm.reg) ||
+            (check.raw.modrm.rm != instruction->raw.modrm.rm))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+    if ((check.avx.vector_length != instruction->avx.vector_length) ||
+        (check.avx.mask.mode != instruction->avx.mask.mode) ||
+        (check.avx.mask.reg != instruction->avx.mask.reg) ||
+        (check.avx.broadcast.mode != instruction->avx.broadcast.mode) ||
+        (check.avx.rounding.mode != instruction->avx.rounding.mode))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+    ZydisDecodedOperand check_operands[ZYDIS_MAX_OPERAND_COUNT];
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeOperands(decoder, context, instruction, operands,
+            instruction->operand_count)) ||
+        !ZYAN_SUCCESS(ZydisDecoderDecodeOperands(decoder, &check_context, &check,
+            check_operands, check.operand_count)))
+    {
+        return ZYAN_FALSE;
+    }
+    for (ZyanU8 i = 0; i < instruction->operand_count; ++i)
+    {
+        if (!ZydisLengthenIsSameOperand(instruction, &operands[i], &check, &check_operands[i]))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * Encodes a longer, semantically identical form of the given instruction.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context         A pointer to the `ZydisDecoderContext` struct.
+ * @param   extra_length    The number of bytes to add.
+ * @param   bytes           A pointer to a buffer of at least `ZYDIS_MAX_INSTRUCTION_LENGTH` bytes.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisLengthenInstruction(const ZydisDecodedInstruction *instruction,
+    const ZydisDecoderContext *context, ZyanU8 extra_length, ZyanU8 *bytes)
+{
+    if (instruction->length + extra_length > ZYDIS_MAX_INSTRUCTION_LENGTH)
+    {
+        return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+    }
+
+    // Prefixes move the end of the instruction, so relative offsets have to shrink accordingly
+    ZyanI64 rip_disp = 0;
+    if (ZydisReEncodeIsRipRelative(instruction))
+    {
+        rip_disp = instruction->raw.disp.value - extra_length;
+        if (instruction->address_width == 32)
+        {
+            // `EIP`-relative addresses wrap around at 4GiB
+            rip_disp = (ZyanI32)(ZyanU32)rip_disp;
+        }
+        if (!ZydisReEncodeIsValueFit(rip_disp, 32, ZYAN_TRUE))
+        {
+            return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+        }
+    }
+    else if (instruction->attributes & ZYDIS_ATTRIB_IS_RELATIVE)
+    {
+        // Relative immediates are never adjusted, so the target would move
+        return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+    }
+
+    const ZyanU8 padding_prefix = ZydisLengthenGetPaddingPrefix(instruction);
+    ZyanU8 max_prefixes = 0;
+    if (padding_prefix && (instruction->raw.prefix_count < ZYDIS_ENCODER_MAX_PADDING_PREFIXES))
+    {
+        max_prefixes = ZYDIS_ENCODER_MAX_PADDING_PREFIXES - instruction->raw.prefix_count;
+    }
+
+    // Prefer growing the displacement, as excessive prefixes slow down some decoders
+    static const ZyanU8 disp_growths[] = { 4, 3, 2, 1, 0 };
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(disp_growths); ++i)
+    {
+        const ZyanU8 growth = disp_growths[i];
+        if ((growth > extra_length) || (extra_length - growth > max_prefixes))
+        {
+            continue;
+        }
+
+        ZydisDecodedInstruction lengthened = *instruction;
+        if (!ZydisLengthenDisplacement(&lengthened, context, growth))
+        {
+            continue;
+        }
+
+        if (ZydisReEncodeIsRipRelative(instruction))
+        {
+            lengthened.raw.disp.value = rip_disp;
+        }
+
+        const ZyanU8 prefix_count = extra_length - growth;
+        ZYAN_MEMMOVE(&lengthened.raw.prefixes[prefix_count], &lengthened.raw.prefixes[0],
+            lengthened.raw.prefix_count * sizeof(lengthened.raw.prefixes[0]));
+        for (ZyanU8 j = 0; j < prefix_count; ++j)
+        {
+            lengthened.raw.prefixes[j].type = ZYDIS_PREFIX_TYPE_IGNORED;
+            lengthened.raw.prefixes[j].value = padding_prefix;
+        }
+        lengthened.raw.prefix_count += prefix_count;
+        lengthened.length += prefix_count;
+        ZYAN_CHECK(ZydisReEncodeRawBytes(&lengthened, bytes));
+
+        // Make sure the result decodes to the same instruction
+        ZydisDecoder decoder;
+        ZYAN_CHECK(ZydisDecoderInit(&decoder, instruction->machine_mode,
+            (ZydisStackWidth)(instruction->stack_width >> 5)));
+        if (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_MVEX)
+        {
+            ZYAN_CHECK(ZydisDecoderEnableMode(&decoder, ZYDIS_DECODER_MODE_KNC, ZYAN_TRUE));
+        }
+        if (ZydisLengthenIsEquivalent(&decoder, instruction, context, bytes, lengthened.length))
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZYDIS_EXPORT ZyanStatus ZydisEncoderEncodeInstruction(const ZydisEncoderRequest *request,
+    void *buffer, ZyanUSize *length)
+{
+    if (!request || !buffer || !length)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    ZYAN_CHECK(ZydisEncoderCheckRequestSanity(request));
+
+    ZydisEncoderInstruction instruction;
+    return ZydisEncoderEncodeInstructionInternal(request, buffer, length, &instruction);
+}
+
+ZYDIS_EXPORT ZyanStatus ZydisEncoderEncodeInstructionAbsolute(ZydisEncoderRequest *request,
+    void *buffer, ZyanUSize *length, ZyanU64 runtime_address)
+{
+    if (!request || !buffer || !length)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    ZYAN_CHECK(ZydisEncoderCheckRequestSanity(request));
+
+    const ZydisEncoderRelInfo *rel_info = ZydisGetRelInfo(request->mnemonic);
+    ZydisEncoderOperand *op_rip_rel = ZYAN_NULL;
+    ZyanBool adjusted_rel = ZYAN_FALSE;
+    ZyanU64 absolute_address = 0;
+    ZyanU8 mode_index = ZydisGetMachineModeWidth(request->machine_mode) >> 5;
+    for (ZyanU8 i = 0; i < request->operand_count; ++i)
+    {
+        ZydisEncoderOperand *op = &request->operands[i];
+        if ((op->type == ZYDIS_OPERAND_TYPE_IMMEDIATE) && rel_info)
+        {
+            if (adjusted_rel)
+            {
+                return ZYAN_STATUS_INVALID_ARGUMENT;
+            }
+
+            switch (rel_info->accepts_scaling_hints)
+            {
+            case ZYDIS_SIZE_HINT_NONE:
+            case ZYDIS_SIZE_HINT_OSZ:
+            {
+                static const ZyanI8 asz_priority[3][3] =
+                {
+                    { 0, 1, 2 },
+                    { 0, 2, 1 },
+                    { 0, 2, -1 },
+                };
+                static const ZyanI8 osz_priority[3][3] =
+                {
+                    { 0, 1, 2 },
+                    { 0, 2, 1 },
+                    { 0, 2, 1 },
+                };
+                ZyanI8 forced_priority_row[3] = { -1, -1, -1 };
+                ZyanI8 *priority_row = ZYAN_NULL;
+                ZyanU8 extra_length = 0;
+                ZyanU8 start_offset = 0;
+                if (rel_info->accepts_scaling_hints == ZYDIS_SIZE_HINT_NONE)
+                {
+                    if ((request->branch_type == ZYDIS_BRANCH_TYPE_FAR) ||
                         (request->branch_width == ZYDIS_BRANCH_WIDTH_64))
                     {
                         return ZYAN_STATUS_INVALID_ARGUMENT;
@@ -5067,7 +6029,79 @@ ZYDIS_EXPORT ZyanStatus ZydisEncoderDecodedInstructionToEncoderRequest(
     return ZYAN_STATUS_SUCCESS;
 }
 
+ZYDIS_EXPORT ZyanStatus ZydisEncoderReEncodeInstruction(
+    const ZydisDecodedInstruction *instruction, const ZydisDecoderContext *context,
+    const ZydisEncoderPatch *patch, void *buffer, ZyanUSize *length)
+{
+    if (!instruction || !context || !buffer || !length)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisEncoderPatch empty_patch;
+    if (!patch)
+    {
+        ZYAN_MEMSET(&empty_patch, 0, sizeof(empty_patch));
+        patch = &empty_patch;
+    }
+    if ((patch->flags & ZYDIS_ENCODER_PATCH_DISPLACEMENT) &&
+        ZydisReEncodeIsRipRelative(instruction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanU8 bytes[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    ZYAN_CHECK(ZydisReEncodeRawBytes(instruction, bytes));
+    if (!ZydisReEncodePatchBytes(instruction, context, patch, bytes))
+    {
+        return ZydisReEncodeFallback(instruction, context, patch, buffer, length);
+    }
+    if (*length < instruction->length)
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+    ZYAN_MEMCPY(buffer, bytes, instruction->length);
+    *length = instruction->length;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZYDIS_EXPORT ZyanStatus ZydisEncoderLengthenInstruction(
+    const ZydisDecodedInstruction *instruction, const ZydisDecoderContext *context,
+    ZyanU8 extra_length, void *buffer, ZyanUSize *length)
+{
+    if (!instruction || !context || !buffer || !length)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanU8 bytes[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    if (!extra_length)
+    {
+        ZYAN_CHECK(ZydisReEncodeRawBytes(instruction, bytes));
+    }
+    else
+    {
+        ZYAN_CHECK(ZydisLengthenInstruction(instruction, context, extra_length, bytes));
+    }
+    const ZyanUSize new_length = instruction->length + extra_length;
+    if (*length < new_length)
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+    ZYAN_MEMCPY(buffer, bytes, new_length);
+    *length = new_length;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
 ZYDIS_EXPORT ZyanStatus ZydisEncoderNopFill(void *buffer, ZyanUSize length)
+{
+    return ZydisEncoderNopFillEx(buffer, length, 0, 0);
+}
+
+ZYDIS_EXPORT ZyanStatus ZydisEncoderNopFillEx(void *buffer, ZyanUSize length,
+    ZyanU64 runtime_address, ZyanU64 boundary)
 {
     if (!buffer)
     {
@@ -5092,10 +6126,39 @@ ZYDIS_EXPORT ZyanStatus ZydisEncoderNopFill(void *buffer, ZyanUSize length)
     while (length)
     {
         ZyanUSize nop_size = (length > 9) ? 9 : length;
+        if (boundary)
+        {
+            const ZyanU64 distance = boundary - (runtime_address % boundary);
+            if (distance < nop_size)
+            {
+                nop_size = (ZyanUSize)distance;
+            }
+        }
         ZYAN_MEMCPY(output, nops[nop_size - 1], nop_size);
         output += nop_size;
         length -= nop_size;
+        runtime_address += nop_size;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZYDIS_EXPORT ZyanStatus ZydisEncoderNopAlign(void *buffer, ZyanUSize *length,
+    ZyanU64 runtime_address, ZyanU64 alignment, ZyanU64 boundary)
+{
+    if (!buffer || !length || !alignment || (alignment & (alignment - 1)))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanUSize padding = (ZyanUSize)((alignment - (runtime_address & (alignment - 1))) &
+        (alignment - 1));
+    if (*length < padding)
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
     }
+    ZYAN_CHECK(ZydisEncoderNopFillEx(buffer, padding, runtime_address, boundary));
+    *length = padding;
 
     return ZYAN_STATUS_SUCCESS;
 }
@@ -0,0 +1,331 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/IsaScan.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Histogram                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Adds an occurrence to the given histogram entry.
+ *
+ * @param   entry   A pointer to the `ZydisIsaScanEntry` struct.
+ * @param   address The runtime address of the occurrence.
+ */
+static void ZydisIsaScanEntryAdd(ZydisIsaScanEntry* entry, ZyanU64 address)
+{
+    if (!entry->count++)
+    {
+        entry->first_address = address;
+    }
+}
+
+/**
+ * Merges the given histogram entry into another one.
+ *
+ * @param   entry   A pointer to the `ZydisIsaScanEntry` struct receiving the merged result.
+ * @param   other   A pointer to the `ZydisIsaScanEntry` struct to merge.
+ */
+static void ZydisIsaScanEntryMerge(ZydisIsaScanEntry* entry, const ZydisIsaScanEntry* other)
+{
+    if (!other->count)
+    {
+        return;
+    }
+    if (!entry->count || (other->first_address < entry->first_address))
+    {
+        entry->first_address = other->first_address;
+    }
+    entry->count += other->count;
+}
+
+/**
+ * Adds an instruction to the given report.
+ *
+ * @param   report  A pointer to the `ZydisIsaScanReport` struct.
+ * @param   address The runtime address of the instruction.
+ * @param   entry   A pointer to the `ZydisIsaScanSyncEntry` describing the instruction.
+ */
+static void ZydisIsaScanReportAdd(ZydisIsaScanReport* report, ZyanU64 address,
+    const ZydisIsaScanSyncEntry* entry)
+{
+    if (!entry->length)
+    {
+        ++report->invalid_count;
+        return;
+    }
+
+    ++report->instruction_count;
+    ZydisIsaScanEntryAdd(&report->isa_set[entry->isa_set], address);
+    ZydisIsaScanEntryAdd(&report->isa_ext[entry->isa_ext], address);
+    ZydisIsaScanEntryAdd(&report->encoding[entry->encoding], address);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Scanning                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Decodes the instruction at the given offset.
+ *
+ * @param   decoder A pointer to the `ZydisDecoder` instance.
+ * @param   buffer  A pointer to the code.
+ * @param   length  The length of the code.
+ * @param   offset  The offset of the instruction.
+ * @param   entry   Receives the instruction information. The length is set to `0`, if the
+ *                  instruction could not be decoded.
+ */
+static void ZydisIsaScanDecode(const ZydisDecoder* decoder, const ZyanU8* buffer,
+    ZyanUSize length, ZyanUSize offset, ZydisIsaScanSyncEntry* entry)
+{
+    ZydisDecodedInstruction instruction;
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, ZYAN_NULL, buffer + offset,
+        length - offset, &instruction)))
+    {
+        entry->length = 0;
+        return;
+    }
+
+    entry->length = instruction.length;
+    entry->encoding = (ZyanU8)instruction.encoding;
+    entry->isa_ext = (ZyanU8)instruction.meta.isa_ext;
+    entry->isa_set = (ZyanU16)instruction.meta.isa_set;
+}
+
+/**
+ * Linearly scans all instructions starting in the given range.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   offset          The offset of the first instruction.
+ * @param   end             The end offset of the range.
+ * @param   report          A pointer to the `ZydisIsaScanReport` struct.
+ *
+ * @return  The offset of the first instruction following the range.
+ */
+static ZyanUSize ZydisIsaScanRange(const ZydisDecoder* decoder, const ZyanU8* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanUSize offset, ZyanUSize end,
+    ZydisIsaScanReport* report)
+{
+    ZYAN_STATIC_ASSERT(ZYDIS_ISA_SET_MAX_VALUE <= 0xFFFF);
+    ZYAN_STATIC_ASSERT(ZYDIS_ISA_EXT_MAX_VALUE <= 0xFF);
+
+    while (offset < end)
+    {
+        ZydisIsaScanSyncEntry entry;
+        ZydisIsaScanDecode(decoder, buffer, length, offset, &entry);
+        ZydisIsaScanReportAdd(report, runtime_address + offset, &entry);
+        offset += entry.length ? entry.length : 1;
+    }
+
+    return offset;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisIsaScanReportInit(ZydisIsaScanReport* report)
+{
+    if (!report)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_MEMSET(report, 0, sizeof(*report));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisIsaScanReportMerge(ZydisIsaScanReport* report, const ZydisIsaScanReport* other)
+{
+    if (!report || !other)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    report->instruction_count += other->instruction_count;
+    report->invalid_count += other->invalid_count;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(report->isa_set); ++i)
+    {
+        ZydisIsaScanEntryMerge(&report->isa_set[i], &other->isa_set[i]);
+    }
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(report->isa_ext); ++i)
+    {
+        ZydisIsaScanEntryMerge(&report->isa_ext[i], &other->isa_ext[i]);
+    }
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(report->encoding); ++i)
+    {
+        ZydisIsaScanEntryMerge(&report->encoding[i], &other->encoding[i]);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisIsaScanLinear(const ZydisDecoder* decoder, const void* buffer, ZyanUSize length,
+    ZyanU64 runtime_address, ZydisIsaScanReport* report)
+{
+    if (!decoder || (!buffer && length) || !report)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisIsaScanRange(decoder, (const ZyanU8*)buffer, length, runtime_address, 0, length, report);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisIsaScanLinearChunk(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanUSize start, ZyanUSize end,
+    ZydisIsaScanChunk* chunk)
+{
+    if (!decoder || (!buffer && length) || (start > end) || (end > length) || !chunk)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* const data = (const ZyanU8*)buffer;
+
+    chunk->start = start;
+    chunk->end = end;
+    chunk->sync_count = 0;
+    ZydisIsaScanReportInit(&chunk->report);
+
+    // Log the instructions at the start of the chunk. They might not be part of the actual
+    // instruction stream, if the last instruction of the preceding chunk extends into this chunk
+    ZyanUSize offset = start;
+    while ((offset < end) && (offset - start < ZYDIS_ISA_SCAN_SYNC_WINDOW))
+    {
+        ZydisIsaScanSyncEntry* const entry = &chunk->sync[chunk->sync_count++];
+        entry->offset = (ZyanU8)(offset - start);
+        ZydisIsaScanDecode(decoder, data, length, offset, entry);
+        offset += entry->length ? entry->length : 1;
+    }
+    chunk->sync_end = offset;
+
+    chunk->exit_offset = ZydisIsaScanRange(decoder, data, length, runtime_address, offset, end,
+        &chunk->report);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisIsaScanMergeChunks(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, const ZydisIsaScanChunk* chunks,
+    ZyanUSize chunk_count, ZydisIsaScanReport* report)
+{
+    if (!decoder || (!buffer && length) || (!chunks && chunk_count) || !report)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* const data = (const ZyanU8*)buffer;
+
+    ZydisIsaScanReportInit(report);
+
+    ZyanUSize offset = 0;
+    for (ZyanUSize i = 0; i < chunk_count; ++i)
+    {
+        const ZydisIsaScanChunk* const chunk = &chunks[i];
+        if ((chunk->start != (i ? chunks[i - 1].end : 0)) ||
+            ((i == chunk_count - 1) && (chunk->end != length)))
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+
+        // Follow the actual instruction stream through the logged instructions until it reaches
+        // the first instruction of the chunk report
+        ZyanUSize j = 0;
+        while (offset < chunk->sync_end)
+        {
+            while ((j < chunk->sync_count) && (chunk->start + chunk->sync[j].offset < offset))
+            {
+                ++j;
+            }
+
+            ZydisIsaScanSyncEntry entry;
+            if ((j < chunk->sync_count) && (chunk->start + chunk->sync[j].offset == offset))
+            {
+                entry = chunk->sync[j++];
+            } else
+            {
+                ZydisIsaScanDecode(decoder, data, length, offset, &entry);
+            }
+            ZydisIsaScanReportAdd(report, runtime_address + offset, &entry);
+            offset += entry.length ? entry.length : 1;
+        }
+
+        if (offset == chunk->sync_end)
+        {
+            ZydisIsaScanReportMerge(report, &chunk->report);
+            offset = chunk->exit_offset;
+            continue;
+        }
+
+        // The instruction streams did not synchronize
+        offset = ZydisIsaScanRange(decoder, data, length, runtime_address, offset, chunk->end,
+            report);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisIsaScanExplored(const ZydisCfg* cfg, ZydisIsaScanReport* report)
+{
+    if (!cfg || !report)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (ZyanUSize i = 0; i < (cfg->length + 7) / 8; ++i)
+    {
+        for (ZyanU8 bits = cfg->visited[i], bit = 0; bits; bits >>= 1, ++bit)
+        {
+            if (!(bits & 1))
+            {
+                continue;
+            }
+
+            const ZyanUSize offset = i * 8 + bit;
+            ZydisIsaScanSyncEntry entry;
+            ZydisIsaScanDecode(cfg->decoder, cfg->buffer, cfg->length, offset, &entry);
+            ZydisIsaScanReportAdd(report, cfg->runtime_address + offset, &entry);
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,130 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/JccErratum.h>
+#include <Zydis/PerfInfo.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Checks if the given instruction is a branch affected by the `JCC` erratum.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction is affected or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisIsJccErratumBranch(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_COND_BR:
+    case ZYDIS_CATEGORY_UNCOND_BR:
+    case ZYDIS_CATEGORY_CALL:
+    case ZYDIS_CATEGORY_RET:
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisAnalyzeJccErratum(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZydisJccErratumCallback callback,
+    void* user_data, ZyanUSize* count)
+{
+    if (!decoder || (!buffer && length) || !callback)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* data = (const ZyanU8*)buffer;
+    ZydisDecodedInstruction instructions[2];
+    ZyanU8 current = 0;
+    ZyanBool has_previous = ZYAN_FALSE;
+    ZyanUSize previous_offset = 0;
+    ZyanUSize site_count = 0;
+
+    ZyanUSize offset = 0;
+    while (offset < length)
+    {
+        ZydisDecodedInstruction* const instruction = &instructions[current];
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, ZYAN_NULL, data + offset,
+            length - offset, instruction)))
+        {
+            has_previous = ZYAN_FALSE;
+            ++offset;
+            continue;
+        }
+
+        if (ZydisIsJccErratumBranch(instruction))
+        {
+            ZydisJccErratumSite site;
+            site.offset = offset;
+            site.length = instruction->length;
+            site.is_fused = ZYAN_FALSE;
+            if (has_previous && ZydisIsMacroFusedPair(&instructions[current ^ 1], instruction,
+                ZYDIS_MICROARCH_SKYLAKE))
+            {
+                site.offset = previous_offset;
+                site.length = (ZyanU8)(instruction->length + instructions[current ^ 1].length);
+                site.is_fused = ZYAN_TRUE;
+            }
+            site.runtime_address = runtime_address + site.offset;
+
+            const ZyanU64 start = site.runtime_address;
+            const ZyanU64 end = start + site.length;
+            if ((start / ZYDIS_JCC_ERRATUM_BOUNDARY) != (end / ZYDIS_JCC_ERRATUM_BOUNDARY))
+            {
+                site.mnemonic = instruction->mnemonic;
+                site.crosses_boundary = (end % ZYDIS_JCC_ERRATUM_BOUNDARY) != 0;
+                site.padding = (ZyanU8)(ZYDIS_JCC_ERRATUM_BOUNDARY -
+                    (start % ZYDIS_JCC_ERRATUM_BOUNDARY));
+                ZYAN_CHECK(callback(&site, user_data));
+                ++site_count;
+            }
+        }
+
+        has_previous = ZYAN_TRUE;
+        previous_offset = offset;
+        offset += instruction->length;
+        current ^= 1;
+    }
+
+    if (count)
+    {
+        *count = site_count;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,665 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/JumpTable.h>
+#include <Zydis/Register.h>
+#include <Zydis/Utils.h>
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisSliceEntry` struct.
+ */
+typedef struct ZydisSliceEntry_
+{
+    /**
+     * The runtime address of the instruction.
+     */
+    ZyanU64 address;
+    /**
+     * The decoded instruction.
+     */
+    ZydisDecodedInstruction instruction;
+    /**
+     * The decoder context required to lazily decode the operands.
+     */
+    ZydisDecoderContext context;
+    /**
+     * The operands, including hidden ones. Only valid, if `has_operands` is set.
+     */
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+    /**
+     * Signals whether the operands have been decoded.
+     */
+    ZyanBool has_operands;
+} ZydisSliceEntry;
+
+/**
+ * Defines the `ZydisSlice` struct.
+ */
+typedef struct ZydisSlice_
+{
+    /**
+     * A pointer to the `ZydisDecoder` instance.
+     */
+    const ZydisDecoder* decoder;
+    /**
+     * A pointer to the `ZydisMemoryView` struct or `ZYAN_NULL`.
+     */
+    const ZydisMemoryView* memory;
+    /**
+     * A ring buffer holding the instructions preceding the jump, followed by the jump itself.
+     */
+    ZydisSliceEntry entries[ZYDIS_JUMP_TABLE_SLICE_SIZE + 1];
+    /**
+     * The ring buffer index of the oldest entry.
+     */
+    ZyanUSize first;
+    /**
+     * The number of valid entries.
+     */
+    ZyanUSize count;
+} ZydisSlice;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Returns the slice entry at the given position.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   index   The position in program order, `0` being the oldest instruction.
+ *
+ * @return  A pointer to the `ZydisSliceEntry` struct.
+ */
+static ZydisSliceEntry* ZydisSliceAt(ZydisSlice* slice, ZyanUSize index)
+{
+    return &slice->entries[(slice->first + index) % ZYAN_ARRAY_LENGTH(slice->entries)];
+}
+
+/**
+ * Returns the operands of the given slice entry, decoding them on first use.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   entry   A pointer to the `ZydisSliceEntry` struct.
+ *
+ * @return  A pointer to the operands or `ZYAN_NULL`, if they could not be decoded.
+ */
+static const ZydisDecodedOperand* ZydisSliceGetOperands(const ZydisSlice* slice,
+    ZydisSliceEntry* entry)
+{
+    if (!entry->has_operands)
+    {
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeOperands(slice->decoder, &entry->context,
+            &entry->instruction, entry->operands, entry->instruction.operand_count)))
+        {
+            return ZYAN_NULL;
+        }
+        entry->has_operands = ZYAN_TRUE;
+    }
+    return entry->operands;
+}
+
+/**
+ * Normalizes the given register to its largest enclosing register.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   reg     The register.
+ *
+ * @return  The largest enclosing register.
+ */
+static ZydisRegister ZydisSliceNormalize(const ZydisSlice* slice, ZydisRegister reg)
+{
+    return ZydisRegisterGetLargestEnclosing(slice->decoder->machine_mode, reg);
+}
+
+/**
+ * Checks if the given operand is a register operand written by the instruction.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   operand A pointer to the `ZydisDecodedOperand` struct.
+ * @param   reg     The normalized register.
+ *
+ * @return  `ZYAN_TRUE`, if the operand writes to `reg` or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceIsWrite(const ZydisSlice* slice, const ZydisDecodedOperand* operand,
+    ZydisRegister reg)
+{
+    return (operand->type == ZYDIS_OPERAND_TYPE_REGISTER) &&
+        (operand->actions & ZYDIS_OPERAND_ACTION_MASK_WRITE) &&
+        (ZydisSliceNormalize(slice, operand->reg.value) == reg);
+}
+
+/**
+ * Searches backwards for the last instruction writing the given register.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   before  The index of the instruction to start searching before.
+ * @param   reg     The normalized register.
+ * @param   index   Receives the index of the defining instruction.
+ *
+ * @return  `ZYAN_TRUE`, if a definition was found or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceFindDefinition(ZydisSlice* slice, ZyanUSize before, ZydisRegister reg,
+    ZyanUSize* index)
+{
+    while (before--)
+    {
+        ZydisSliceEntry* const entry = ZydisSliceAt(slice, before);
+        const ZydisDecodedOperand* const operands = ZydisSliceGetOperands(slice, entry);
+        if (!operands)
+        {
+            return ZYAN_FALSE;
+        }
+        // Hidden operands cover implicit writes (e.g. `CDQE`, `MUL` or `DIV`)
+        for (ZyanU8 i = 0; i < entry->instruction.operand_count; ++i)
+        {
+            if (ZydisSliceIsWrite(slice, &operands[i], reg))
+            {
+                *index = before;
+                return ZYAN_TRUE;
+            }
+        }
+    }
+    return ZYAN_FALSE;
+}
+
+/**
+ * Resolves the constant value of the given register at the given position of the slice.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   before  The index of the instruction using the register.
+ * @param   reg     The normalized register.
+ * @param   value   Receives the value.
+ *
+ * @return  `ZYAN_TRUE`, if the value could be resolved or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceResolveValue(ZydisSlice* slice, ZyanUSize before, ZydisRegister reg,
+    ZyanU64* value)
+{
+    ZyanUSize index;
+    if (!ZydisSliceFindDefinition(slice, before, reg, &index))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZydisSliceEntry* const entry = ZydisSliceAt(slice, index);
+    const ZydisDecodedOperand* const operands = entry->operands;
+    if (entry->instruction.operand_count_visible != 2)
+    {
+        return ZYAN_FALSE;
+    }
+    switch (entry->instruction.mnemonic)
+    {
+    case ZYDIS_MNEMONIC_LEA:
+        return ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(&entry->instruction, &operands[1],
+            entry->address, value));
+    case ZYDIS_MNEMONIC_MOV:
+        if (operands[1].type == ZYDIS_OPERAND_TYPE_IMMEDIATE)
+        {
+            *value = operands[1].imm.value.u;
+            return ZYAN_TRUE;
+        }
+        if ((operands[1].type == ZYDIS_OPERAND_TYPE_MEMORY) && slice->memory)
+        {
+            // Base pointer loaded from a constant location (e.g. a `GOT` entry)
+            ZyanU64 address;
+            const ZyanU8 size = (ZyanU8)(operands[0].size / 8);
+            if (!ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(&entry->instruction, &operands[1],
+                entry->address, &address)) || (size > 8) ||
+                (address - slice->memory->address > slice->memory->size) ||
+                (slice->memory->size - (address - slice->memory->address) < size))
+            {
+                return ZYAN_FALSE;
+            }
+            *value = 0;
+            ZYAN_MEMCPY(value, (const ZyanU8*)slice->memory->data +
+                (address - slice->memory->address), size);
+            return ZYAN_TRUE;
+        }
+        return ZYAN_FALSE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Pattern matching                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Analyzes a table-indexed memory operand.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   index   The index of the instruction containing the memory operand.
+ * @param   operand A pointer to the memory operand.
+ * @param   table   Receives the table address, entry size and signedness.
+ *
+ * @return  `ZYAN_TRUE`, if the operand addresses a table or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceAnalyzeLoad(ZydisSlice* slice, ZyanUSize index,
+    const ZydisDecodedOperand* operand, ZydisJumpTable* table)
+{
+    if ((operand->type != ZYDIS_OPERAND_TYPE_MEMORY) ||
+        (operand->mem.type != ZYDIS_MEMOP_TYPE_MEM) ||
+        (operand->mem.index == ZYDIS_REGISTER_NONE))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZyanU64 base = 0;
+    if ((operand->mem.base != ZYDIS_REGISTER_NONE) &&
+        !ZydisSliceResolveValue(slice, index,
+            ZydisSliceNormalize(slice, operand->mem.base), &base))
+    {
+        return ZYAN_FALSE;
+    }
+
+    table->table_address = base + (ZyanU64)operand->mem.disp.value;
+    table->entry_size = (ZyanU8)(operand->size / 8);
+    table->is_signed = ZYAN_FALSE;
+    return (table->entry_size == 1) || (table->entry_size == 2) || (table->entry_size == 4) ||
+        (table->entry_size == 8);
+}
+
+/**
+ * Analyzes an instruction defining the jump target register by loading a table entry.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   index   The index of the loading instruction.
+ * @param   table   Receives the table address, entry size and signedness.
+ * @param   load    Receives a pointer to the memory operand.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction loads a table entry or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceAnalyzeEntryLoad(ZydisSlice* slice, ZyanUSize index,
+    ZydisJumpTable* table, const ZydisDecodedOperand** load)
+{
+    ZydisSliceEntry* const entry = ZydisSliceAt(slice, index);
+    ZyanBool is_signed;
+    switch (entry->instruction.mnemonic)
+    {
+    case ZYDIS_MNEMONIC_MOV:
+    case ZYDIS_MNEMONIC_MOVZX:
+        is_signed = ZYAN_FALSE;
+        break;
+    case ZYDIS_MNEMONIC_MOVSX:
+    case ZYDIS_MNEMONIC_MOVSXD:
+        is_signed = ZYAN_TRUE;
+        break;
+    default:
+        return ZYAN_FALSE;
+    }
+
+    if ((entry->instruction.operand_count_visible != 2) ||
+        !ZydisSliceAnalyzeLoad(slice, index, &entry->operands[1], table))
+    {
+        return ZYAN_FALSE;
+    }
+    table->is_signed = is_signed;
+    *load = &entry->operands[1];
+    return ZYAN_TRUE;
+}
+
+/**
+ * Checks if the given register is contained in the given register set.
+ *
+ * @param   set     A pointer to the register set.
+ * @param   count   The number of registers in the set.
+ * @param   reg     The register.
+ *
+ * @return  `ZYAN_TRUE`, if the set contains the register or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisSliceContains(const ZydisRegister* set, ZyanUSize count, ZydisRegister reg)
+{
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        if (set[i] == reg)
+        {
+            return ZYAN_TRUE;
+        }
+    }
+    return ZYAN_FALSE;
+}
+
+/**
+ * Derives the number of table entries from the bounds check preceding the table load.
+ *
+ * @param   slice   A pointer to the `ZydisSlice` struct.
+ * @param   before  The index of the loading instruction.
+ * @param   index   The (non-normalized) index register of the table load.
+ * @param   count   Receives the number of entries.
+ *
+ * @return  `ZYAN_TRUE`, if the bound could be determined or `ZYAN_FALSE`, if not.
+ *
+ * Walking backwards, two register sets are maintained: registers holding the index value and
+ * registers holding a bounds-checked value. Both are propagated through register copies, so
+ * the check matches as soon as one register is contained in both sets.
+ */
+static ZyanBool ZydisSliceFindBound(ZydisSlice* slice, ZyanUSize before, ZydisRegister index,
+    ZyanU32* count)
+{
+    ZydisRegister aliases[4] = { ZydisSliceNormalize(slice, index) };
+    ZyanUSize alias_count = 1;
+    ZydisRegister checked[4];
+    ZyanU32 bounds[4];
+    ZyanUSize checked_count = 0;
+    ZydisMnemonic branch = ZYDIS_MNEMONIC_INVALID;
+
+    while (before-- && alias_count)
+    {
+        ZydisSliceEntry* const entry = ZydisSliceAt(slice, before);
+        const ZydisDecodedOperand* const operands = ZydisSliceGetOperands(slice, entry);
+        if (!operands)
+        {
+            return ZYAN_FALSE;
+        }
+
+        switch (entry->instruction.mnemonic)
+        {
+        case ZYDIS_MNEMONIC_JNBE:
+        case ZYDIS_MNEMONIC_JNB:
+        case ZYDIS_MNEMONIC_JBE:
+        case ZYDIS_MNEMONIC_JB:
+            // Walking backwards, the last branch seen is the one following the comparison
+            branch = entry->instruction.mnemonic;
+            continue;
+        default:
+            break;
+        }
+
+        if ((entry->instruction.operand_count_visible >= 2) &&
+            (operands[0].type == ZYDIS_OPERAND_TYPE_REGISTER) &&
+            (operands[1].type == ZYDIS_OPERAND_TYPE_IMMEDIATE) &&
+            (operands[1].imm.value.u < 0xFFFFFFFF))
+        {
+            const ZyanU32 imm = (ZyanU32)operands[1].imm.value.u;
+            ZyanU32 bound = 0;
+            if ((entry->instruction.mnemonic == ZYDIS_MNEMONIC_CMP) &&
+                (branch != ZYDIS_MNEMONIC_INVALID))
+            {
+                bound = ((branch == ZYDIS_MNEMONIC_JNBE) || (branch == ZYDIS_MNEMONIC_JBE))
+                    ? imm + 1
+                    : imm;
+            } else if ((entry->instruction.mnemonic == ZYDIS_MNEMONIC_AND) &&
+                !((imm + 1) & imm))
+            {
+                bound = imm + 1;
+            }
+
+            const ZydisRegister reg = ZydisSliceNormalize(slice, operands[0].reg.value);
+            if (bound && ZydisSliceContains(aliases, alias_count, reg))
+            {
+                *count = bound;
+                return ZYAN_TRUE;
+            }
+            if (bound && (entry->instruction.mnemonic == ZYDIS_MNEMONIC_CMP) &&
+                (checked_count < ZYAN_ARRAY_LENGTH(checked)))
+            {
+                checked[checked_count] = reg;
+                bounds[checked_count++] = bound;
+                continue;
+            }
+        }
+
+        // Propagate both sets through register writes
+        ZydisRegister source = ZYDIS_REGISTER_NONE;
+        switch (entry->instruction.mnemonic)
+        {
+        case ZYDIS_MNEMONIC_MOV:
+        case ZYDIS_MNEMONIC_MOVZX:
+        case ZYDIS_MNEMONIC_MOVSX:
+        case ZYDIS_MNEMONIC_MOVSXD:
+            if (operands[1].type == ZYDIS_OPERAND_TYPE_REGISTER)
+            {
+                source = ZydisSliceNormalize(slice, operands[1].reg.value);
+            }
+            break;
+        default:
+            break;
+        }
+        for (ZyanU8 i = 0; i < entry->instruction.operand_count; ++i)
+        {
+            if ((operands[i].type != ZYDIS_OPERAND_TYPE_REGISTER) ||
+                !(operands[i].actions & ZYDIS_OPERAND_ACTION_MASK_WRITE))
+            {
+                continue;
+            }
+            const ZydisRegister reg = ZydisSliceNormalize(slice, operands[i].reg.value);
+            ZydisRegister* const sets[2] = { aliases, checked };
+            ZyanUSize* const set_counts[2] = { &alias_count, &checked_count };
+            for (ZyanU8 j = 0; j < 2; ++j)
+            {
+                ZyanUSize k = 0;
+                while (k < *set_counts[j])
+                {
+                    if (sets[j][k] != reg)
+                    {
+                        ++k;
+                        continue;
+                    }
+                    if (source != ZYDIS_REGISTER_NONE)
+                    {
+                        sets[j][k++] = source;
+                        continue;
+                    }
+                    --*set_counts[j];
+                    sets[j][k] = sets[j][*set_counts[j]];
+                    if (j)
+                    {
+                        bounds[k] = bounds[*set_counts[j]];
+                    }
+                }
+            }
+        }
+
+        for (ZyanUSize i = 0; i < checked_count; ++i)
+        {
+            if (ZydisSliceContains(aliases, alias_count, checked[i]))
+            {
+                *count = bounds[i];
+                return ZYAN_TRUE;
+            }
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisRecoverJumpTable(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanU64 jump_address,
+    const ZydisMemoryView* memory, ZydisJumpTable* table)
+{
+    if (!decoder || !buffer || !table || (jump_address < runtime_address) ||
+        (jump_address - runtime_address >= length))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisSlice slice;
+    slice.decoder = decoder;
+    slice.memory = memory;
+    slice.first = 0;
+    slice.count = 0;
+
+    // Decode up to the jump, only keeping the most recent instructions
+    const ZyanU8* data = (const ZyanU8*)buffer;
+    const ZyanUSize jump_offset = (ZyanUSize)(jump_address - runtime_address);
+    ZyanUSize offset = 0;
+    ZyanBool found = ZYAN_FALSE;
+    while (!found && (offset <= jump_offset))
+    {
+        if (slice.count == ZYAN_ARRAY_LENGTH(slice.entries))
+        {
+            slice.first = (slice.first + 1) % ZYAN_ARRAY_LENGTH(slice.entries);
+            --slice.count;
+        }
+        ZydisSliceEntry* const entry = ZydisSliceAt(&slice, slice.count);
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, &entry->context, data + offset,
+            length - offset, &entry->instruction)))
+        {
+            // Restart the slice after undecodable bytes
+            slice.count = 0;
+            ++offset;
+            continue;
+        }
+        entry->address = runtime_address + offset;
+        entry->has_operands = ZYAN_FALSE;
+        ++slice.count;
+        found = (offset == jump_offset);
+        offset += entry->instruction.length;
+    }
+    if (!found)
+    {
+        // The jump address is not an instruction boundary of the linear sweep
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanUSize jump_index = slice.count - 1;
+    ZydisSliceEntry* const jump = ZydisSliceAt(&slice, jump_index);
+    const ZydisDecodedOperand* const jump_operands = ZydisSliceGetOperands(&slice, jump);
+    if (!jump_operands || (jump->instruction.meta.category != ZYDIS_CATEGORY_UNCOND_BR) ||
+        (jump->instruction.operand_count_visible != 1))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZydisJumpTable result;
+    result.base_address = 0;
+    result.address_width = jump->instruction.address_width;
+    const ZydisDecodedOperand* load = ZYAN_NULL;
+    ZyanUSize load_index = jump_index;
+
+    if (jump_operands[0].type == ZYDIS_OPERAND_TYPE_MEMORY)
+    {
+        // `JMP [base + index * scale + disp]`
+        if (!ZydisSliceAnalyzeLoad(&slice, jump_index, &jump_operands[0], &result))
+        {
+            return ZYAN_STATUS_NOT_FOUND;
+        }
+        load = &jump_operands[0];
+    } else if (jump_operands[0].type == ZYDIS_OPERAND_TYPE_REGISTER)
+    {
+        const ZydisRegister target = ZydisSliceNormalize(&slice, jump_operands[0].reg.value);
+        ZyanUSize def;
+        if (!ZydisSliceFindDefinition(&slice, jump_index, target, &def))
+        {
+            return ZYAN_STATUS_NOT_FOUND;
+        }
+
+        const ZydisSliceEntry* const def_entry = ZydisSliceAt(&slice, def);
+        if ((def_entry->instruction.mnemonic == ZYDIS_MNEMONIC_ADD) &&
+            (def_entry->operands[1].type == ZYDIS_OPERAND_TYPE_REGISTER))
+        {
+            // `ADD target, other`: one of both registers holds the entry, the other one the base
+            const ZydisRegister other =
+                ZydisSliceNormalize(&slice, def_entry->operands[1].reg.value);
+            const ZydisRegister candidates[2][2] = { { target, other }, { other, target } };
+            for (ZyanU8 i = 0; (i < 2) && !load; ++i)
+            {
+                ZyanUSize entry_def;
+                if (ZydisSliceFindDefinition(&slice, def, candidates[i][0], &entry_def) &&
+                    ZydisSliceAnalyzeEntryLoad(&slice, entry_def, &result, &load) &&
+                    ZydisSliceResolveValue(&slice, def, candidates[i][1], &result.base_address))
+                {
+                    load_index = entry_def;
+                } else
+                {
+                    load = ZYAN_NULL;
+                }
+            }
+        } else if (ZydisSliceAnalyzeEntryLoad(&slice, def, &result, &load))
+        {
+            load_index = def;
+        }
+    }
+    if (!load)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    if (!ZydisSliceFindBound(&slice, load_index, load->mem.index, &result.entry_count))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    *table = result;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisGetJumpTableTargets(const ZydisJumpTable* table, const ZydisMemoryView* memory,
+    ZyanU64* targets, ZyanUSize* count)
+{
+    if (!table || !memory || !count || (!targets && *count) || (!memory->data && memory->size))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU64 mask = (table->address_width == 64)
+        ? 0xFFFFFFFFFFFFFFFF
+        : (1ULL << table->address_width) - 1;
+    const ZyanU8 shift = (ZyanU8)(64 - table->entry_size * 8);
+
+    ZyanUSize read = 0;
+    const ZyanUSize capacity = ZYAN_MIN(*count, (ZyanUSize)table->entry_count);
+    ZyanU64 address = table->table_address;
+    for (; read < capacity; ++read, address += table->entry_size)
+    {
+        const ZyanU64 offset = address - memory->address;
+        if ((offset > memory->size) || (memory->size - offset < table->entry_size))
+        {
+            break;
+        }
+
+        // Assumes a little-endian host, like the rest of the library
+        ZyanU64 entry = 0;
+        ZYAN_MEMCPY(&entry, (const ZyanU8*)memory->data + offset, table->entry_size);
+        if (table->is_signed && shift)
+        {
+            entry = (ZyanU64)((ZyanI64)(entry << shift) >> shift);
+        }
+        targets[read] = (table->base_address + entry) & mask;
+    }
+    *count = read;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,240 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/Liveness.h>
+#include <Zydis/Internal/RegisterSet.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Decodes the instruction at the given offset and determines its liveness transfer sets.
+ *
+ * @param   decoder A pointer to the `ZydisDecoder` instance.
+ * @param   buffer  A pointer to the code.
+ * @param   length  The length of the code.
+ * @param   options A pointer to the `ZydisLivenessOptions` struct.
+ * @param   instruction_length  Receives the length of the instruction.
+ * @param   use     Receives the registers read by the instruction.
+ * @param   def     Receives the registers fully overwritten by the instruction.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisLivenessDecode(const ZydisDecoder* decoder, const ZyanU8* buffer,
+    ZyanUSize length, const ZydisLivenessOptions* options, ZyanU8* instruction_length,
+    ZydisRegisterSet* use, ZydisRegisterSet* def)
+{
+    ZydisDecoderContext context;
+    ZydisDecodedInstruction instruction;
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+
+    ZYAN_CHECK(ZydisDecoderDecodeInstruction(decoder, &context, buffer, length, &instruction));
+    ZYAN_CHECK(ZydisDecoderDecodeOperands(decoder, &context, &instruction, operands,
+        instruction.operand_count));
+    *instruction_length = instruction.length;
+
+    return ZydisGetLivenessTransfer(&instruction, operands, instruction.operand_count, options,
+        use, def);
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisGetLivenessTransfer(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count,
+    const ZydisLivenessOptions* options, ZydisRegisterSet* use, ZydisRegisterSet* def)
+{
+    if (!instruction || !options || !use || !def)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisRegisterUsage usage;
+    ZYAN_CHECK(ZydisGetRegisterUsage(instruction, operands, operand_count, &usage));
+
+    *use = usage.read;
+    *def = usage.write;
+    if (instruction->meta.category == ZYDIS_CATEGORY_CALL)
+    {
+        ZydisRegisterSetOr(use, use, &options->call_use);
+        ZydisRegisterSetOr(def, def, &options->call_def);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisComputeLinearLiveness(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, const ZydisLivenessOptions* options, const ZydisRegisterSet* live_out,
+    ZydisRegisterSet* live_before, ZyanUSize* count)
+{
+    if (!decoder || (!buffer && length) || !options || !live_out || !count ||
+        (!live_before && *count))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* const data = (const ZyanU8*)buffer;
+
+    // Forward pass: find instruction boundaries, temporarily storing the offsets in the output
+    // array
+    ZyanUSize n = 0;
+    ZyanUSize offset = 0;
+    ZydisDecodedInstruction instruction;
+    while (ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, ZYAN_NULL, data + offset,
+        length - offset, &instruction)))
+    {
+        if (n < *count)
+        {
+            live_before[n].bits[0] = offset;
+        }
+        ++n;
+        offset += instruction.length;
+    }
+    if (n > *count)
+    {
+        *count = n;
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+    *count = n;
+
+    // Backward pass
+    ZydisRegisterSet live = *live_out;
+    for (ZyanUSize i = n; i-- > 0;)
+    {
+        offset = (ZyanUSize)live_before[i].bits[0];
+
+        ZyanU8 instruction_length;
+        ZydisRegisterSet use;
+        ZydisRegisterSet def;
+        ZYAN_CHECK(ZydisLivenessDecode(decoder, data + offset, length - offset, options,
+            &instruction_length, &use, &def));
+
+        ZydisRegisterSetTransfer(&live, &use, &live, &def);
+        live_before[i] = live;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisComputeCfgLiveness(const ZydisCfg* cfg, const ZydisCfgBlock* blocks,
+    ZyanUSize block_count, const ZydisCfgEdge* edges, ZyanUSize edge_count,
+    const ZydisLivenessOptions* options, ZydisLivenessBlock* liveness)
+{
+    if (!cfg || (!blocks && block_count) || (!edges && edge_count) || !options ||
+        (!liveness && block_count))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Summarize each block by composing the transfer functions of its instructions
+    for (ZyanUSize i = 0; i < block_count; ++i)
+    {
+        const ZydisCfgBlock* const block = &blocks[i];
+        ZydisLivenessBlock* const info = &liveness[i];
+        if ((block->address < cfg->runtime_address) ||
+            (block->address - cfg->runtime_address > cfg->length) ||
+            ((ZyanU64)block->first_edge + block->edge_count > edge_count))
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+
+        ZYAN_MEMSET(info, 0, sizeof(*info));
+        ZyanUSize offset = (ZyanUSize)(block->address - cfg->runtime_address);
+        for (ZyanU32 j = 0; j < block->instruction_count; ++j)
+        {
+            ZyanU8 instruction_length;
+            ZydisRegisterSet use;
+            ZydisRegisterSet def;
+            ZYAN_CHECK(ZydisLivenessDecode(cfg->decoder, cfg->buffer + offset,
+                cfg->length - offset, options, &instruction_length, &use, &def));
+            offset += instruction_length;
+
+            // Registers read before being defined by an earlier instruction of the block
+            ZydisRegisterSetAndNot(&use, &use, &info->def);
+            ZydisRegisterSetOr(&info->use, &info->use, &use);
+            ZydisRegisterSetOr(&info->def, &info->def, &def);
+        }
+        info->live_in = info->use;
+    }
+
+    // Iterate to a fixed point. Visiting blocks in reverse address order propagates liveness
+    // backwards along fallthrough edges within a single pass
+    ZyanBool changed = ZYAN_TRUE;
+    while (changed)
+    {
+        changed = ZYAN_FALSE;
+        for (ZyanUSize i = block_count; i-- > 0;)
+        {
+            const ZydisCfgBlock* const block = &blocks[i];
+            ZydisLivenessBlock* const info = &liveness[i];
+
+            ZydisRegisterSet live_out;
+            ZYAN_MEMSET(&live_out, 0, sizeof(live_out));
+            ZyanBool exits = (block->edge_count == 0);
+            for (ZyanU32 j = 0; j < block->edge_count; ++j)
+            {
+                const ZydisCfgEdge* const edge = &edges[block->first_edge + j];
+                switch (edge->type)
+                {
+                case ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH:
+                case ZYDIS_CFG_EDGE_TYPE_JUMP:
+                    if (edge->is_indirect || (edge->target >= block_count))
+                    {
+                        exits = ZYAN_TRUE;
+                        break;
+                    }
+                    ZydisRegisterSetOr(&live_out, &live_out, &liveness[edge->target].live_in);
+                    break;
+                case ZYDIS_CFG_EDGE_TYPE_RETURN:
+                    exits = ZYAN_TRUE;
+                    break;
+                default:
+                    // Calls are summarized by `call_use` and `call_def`
+                    break;
+                }
+            }
+            if (exits)
+            {
+                ZydisRegisterSetOr(&live_out, &live_out, &options->exit_live);
+            }
+
+            if (ZydisRegisterSetEquals(&live_out, &info->live_out))
+            {
+                continue;
+            }
+            info->live_out = live_out;
+            ZydisRegisterSetTransfer(&info->live_in, &info->use, &live_out, &info->def);
+            changed = ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
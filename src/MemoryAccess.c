@@ -0,0 +1,420 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/MemoryAccess.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Returns the number of elements loaded from memory for the given broadcast mode.
+ *
+ * @param   mode    The broadcast mode.
+ *
+ * @return  The number of source elements.
+ */
+static ZyanU16 ZydisGetBroadcastSourceCount(ZydisBroadcastMode mode)
+{
+    switch (mode)
+    {
+    case ZYDIS_BROADCAST_MODE_2_TO_4:
+    case ZYDIS_BROADCAST_MODE_2_TO_8:
+    case ZYDIS_BROADCAST_MODE_2_TO_16:
+        return 2;
+    case ZYDIS_BROADCAST_MODE_4_TO_8:
+    case ZYDIS_BROADCAST_MODE_4_TO_16:
+        return 4;
+    case ZYDIS_BROADCAST_MODE_8_TO_16:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * Checks if the given instruction stores to the stack below the current stack pointer.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction pre-decrements the stack pointer or `ZYAN_FALSE`, if
+ *          not.
+ */
+static ZyanBool ZydisIsPushingInstruction(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_PUSH:
+    case ZYDIS_CATEGORY_CALL:
+        return ZYAN_TRUE;
+    default:
+        return instruction->mnemonic == ZYDIS_MNEMONIC_ENTER;
+    }
+}
+
+/**
+ * Converts the given effective address to a linear address.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   context     A pointer to the `ZydisAddressContext` struct.
+ * @param   segment     The segment register.
+ * @param   offset      The effective address.
+ *
+ * @return  The linear address.
+ */
+static ZyanU64 ZydisToLinearAddress(const ZydisDecodedInstruction* instruction,
+    const ZydisAddressContext* context, ZydisRegister segment, ZyanU64 offset)
+{
+    switch (instruction->address_width)
+    {
+    case 16:
+        offset &= 0x000000000000FFFF;
+        break;
+    case 32:
+        offset &= 0x00000000FFFFFFFF;
+        break;
+    default:
+        break;
+    }
+
+    const ZyanBool is_64 = (instruction->machine_mode == ZYDIS_MACHINE_MODE_LONG_64);
+
+    ZyanU64 base = 0;
+    if ((segment >= ZYDIS_REGISTER_ES) && (segment <= ZYDIS_REGISTER_GS) &&
+        (!is_64 || (segment == ZYDIS_REGISTER_FS) || (segment == ZYDIS_REGISTER_GS)))
+    {
+        base = context->segment_bases[segment - ZYDIS_REGISTER_ES];
+    }
+
+    return is_64 ? base + offset : (base + offset) & 0x00000000FFFFFFFF;
+}
+
+/**
+ * Returns the value of the given register or `0` for `ZYDIS_REGISTER_NONE`.
+ *
+ * @param   context A pointer to the `ZydisAddressContext` struct.
+ * @param   reg     The register.
+ *
+ * @return  The register value.
+ */
+static ZyanU64 ZydisGetAddressRegisterValue(const ZydisAddressContext* context, ZydisRegister reg)
+{
+    return (reg == ZYDIS_REGISTER_NONE) ? 0 : context->registers->values[reg];
+}
+
+/**
+ * Returns a pointer to the contents of the given vector register.
+ *
+ * @param   context A pointer to the `ZydisAddressContext` struct.
+ * @param   reg     The vector register.
+ *
+ * @return  A pointer to the register contents or `ZYAN_NULL`, if the register is invalid.
+ */
+static const ZyanU8* ZydisGetVectorData(const ZydisAddressContext* context, ZydisRegister reg)
+{
+    const ZyanI8 id = ZydisRegisterGetId(reg);
+    if ((id < 0) || (id >= 32))
+    {
+        return ZYAN_NULL;
+    }
+    return context->vectors + (ZyanUSize)id * ZYDIS_ADDRESS_CONTEXT_VECTOR_SIZE;
+}
+
+/**
+ * Evaluates the lane addresses of a `VSIB` access.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands        A pointer to the operands array.
+ * @param   operand_count   The length of the `operands` array.
+ * @param   context         A pointer to the `ZydisAddressContext` struct.
+ * @param   access          A pointer to the `ZydisMemoryAccess` struct.
+ * @param   access_index    The index of the access.
+ * @param   addresses       A pointer to the `ZydisMemoryAddresses` struct that receives the
+ *                          addresses.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisCalcVsibAddresses(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, const ZydisAddressContext* context,
+    const ZydisMemoryAccess* access, ZyanU8 access_index, ZydisMemoryAddresses* addresses)
+{
+    const ZyanU8* const index_data = ZydisGetVectorData(context, access->index);
+    const ZyanU16 index_width = ZydisRegisterGetWidth(instruction->machine_mode, access->index);
+    if (!context->vectors || !index_data || !index_width)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // The number of lanes is limited by both the data and the index vector, e.g.
+    // `VGATHERDPD YMM0, [RAX + XMM1 * 8]` uses 4 dword indices
+    ZyanU8 lanes = (ZyanU8)ZYAN_MIN(access->element_count, index_width / 32);
+    lanes = (ZyanU8)ZYAN_MIN(lanes, ZYDIS_MAX_MEMORY_ADDRESS_COUNT);
+    if (!lanes)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+    const ZyanU8 index_size = (index_width / lanes >= 64) ? 8 : 4;
+
+    ZyanU32 mask = 0xFFFFFFFF;
+    if ((instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_EVEX) ||
+        (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_MVEX))
+    {
+        if ((instruction->avx.mask.reg != ZYDIS_REGISTER_NONE) &&
+            (instruction->avx.mask.reg != ZYDIS_REGISTER_K0))
+        {
+            mask = (ZyanU32)context->registers->values[instruction->avx.mask.reg];
+        }
+    } else if ((ZyanU8)(access->operand_index + 1) < operand_count)
+    {
+        // `AVX2` gathers use the sign bits of a vector register following the memory operand
+        const ZydisDecodedOperand* const mask_operand = &operands[access->operand_index + 1];
+        const ZyanU8 element_size = (ZyanU8)(access->element_size / 8);
+        const ZyanU8* const mask_data = (mask_operand->type == ZYDIS_OPERAND_TYPE_REGISTER) ?
+            ZydisGetVectorData(context, mask_operand->reg.value) : ZYAN_NULL;
+        if (mask_data && element_size)
+        {
+            mask = 0;
+            for (ZyanU8 lane = 0; lane < lanes; ++lane)
+            {
+                mask |= (ZyanU32)(mask_data[(lane + 1) * element_size - 1] >> 7) << lane;
+            }
+        }
+    }
+
+    // Evaluate all lanes first and compact the active ones afterwards, which allows the compiler
+    // to vectorize the address arithmetic
+    ZyanU64 offsets[ZYDIS_MAX_MEMORY_ADDRESS_COUNT];
+    const ZyanU64 base = ZydisGetAddressRegisterValue(context, access->base) +
+        (ZyanU64)access->disp;
+    for (ZyanU8 lane = 0; lane < lanes; ++lane)
+    {
+        const ZyanU8* const data = index_data + lane * index_size;
+        ZyanU64 index = (ZyanU64)data[0] | ((ZyanU64)data[1] << 8) | ((ZyanU64)data[2] << 16) |
+            ((ZyanU64)data[3] << 24);
+        if (index_size == 8)
+        {
+            index |= ((ZyanU64)data[4] << 32) | ((ZyanU64)data[5] << 40) |
+                ((ZyanU64)data[6] << 48) | ((ZyanU64)data[7] << 56);
+        } else
+        {
+            index = (ZyanU64)(ZyanI64)(ZyanI32)(ZyanU32)index;
+        }
+        offsets[lane] = base + index * access->scale;
+    }
+
+    for (ZyanU8 lane = 0; lane < lanes; ++lane)
+    {
+        if (!(mask & (1u << lane)))
+        {
+            continue;
+        }
+        if (addresses->count == ZYDIS_MAX_MEMORY_ADDRESS_COUNT)
+        {
+            return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+        }
+
+        ZydisMemoryAddress* const address = &addresses->addresses[addresses->count++];
+        address->address =
+            ZydisToLinearAddress(instruction, context, access->segment, offsets[lane]);
+        address->size = access->element_size;
+        address->access_index = access_index;
+        address->element_index = lane;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisGetMemoryAccesses(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZydisMemoryAccesses* accesses)
+{
+    if (!instruction || (operand_count && !operands) ||
+        (operand_count > ZYDIS_MAX_OPERAND_COUNT) || !accesses)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    accesses->count = 0;
+
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_PREFETCH:
+    case ZYDIS_CATEGORY_PREFETCHWT1:
+    case ZYDIS_CATEGORY_NOP:
+    case ZYDIS_CATEGORY_WIDENOP:
+        return ZYAN_STATUS_SUCCESS;
+    default:
+        break;
+    }
+
+    const ZyanBool is_string = (instruction->meta.category == ZYDIS_CATEGORY_STRINGOP) ||
+        (instruction->meta.category == ZYDIS_CATEGORY_IOSTRINGOP);
+    const ZyanBool is_masked = (instruction->avx.mask.reg != ZYDIS_REGISTER_NONE) &&
+        (instruction->avx.mask.reg != ZYDIS_REGISTER_K0);
+
+    for (ZyanU8 i = 0; i < operand_count; ++i)
+    {
+        const ZydisDecodedOperand* const operand = &operands[i];
+        if ((operand->type != ZYDIS_OPERAND_TYPE_MEMORY) ||
+            (operand->mem.type == ZYDIS_MEMOP_TYPE_AGEN) ||
+            (operand->mem.type == ZYDIS_MEMOP_TYPE_MIB) ||
+            !(operand->actions & (ZYDIS_OPERAND_ACTION_MASK_READ |
+                                  ZYDIS_OPERAND_ACTION_MASK_WRITE)))
+        {
+            continue;
+        }
+        if (accesses->count == ZYDIS_MAX_MEMORY_ACCESS_COUNT)
+        {
+            return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+        }
+
+        ZydisMemoryAccess* const access = &accesses->accesses[accesses->count++];
+        access->disp = operand->mem.disp.value;
+        access->segment = operand->mem.segment;
+        access->base = operand->mem.base;
+        access->index = operand->mem.index;
+        access->scale = operand->mem.scale;
+        access->size = operand->size;
+        access->element_size = operand->element_size;
+        access->element_count = operand->element_count;
+        access->operand_index = i;
+
+        ZydisMemoryAccessFlags flags = 0;
+        if (operand->actions & ZYDIS_OPERAND_ACTION_MASK_READ)
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_READ;
+        }
+        if (operand->actions & ZYDIS_OPERAND_ACTION_MASK_WRITE)
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_WRITE;
+        }
+        if ((operand->actions & (ZYDIS_OPERAND_ACTION_CONDREAD |
+                                 ZYDIS_OPERAND_ACTION_CONDWRITE)) ||
+            is_masked || (operand->mem.type == ZYDIS_MEMOP_TYPE_VSIB))
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL;
+        }
+        if (operand->visibility != ZYDIS_OPERAND_VISIBILITY_EXPLICIT)
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT;
+        }
+        if (operand->mem.type == ZYDIS_MEMOP_TYPE_VSIB)
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_VSIB;
+        }
+        if ((access->base == ZYDIS_REGISTER_RIP) || (access->base == ZYDIS_REGISTER_EIP))
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_RELATIVE;
+        }
+
+        if ((operand->visibility == ZYDIS_OPERAND_VISIBILITY_HIDDEN) &&
+            ((access->base == ZYDIS_REGISTER_SP) || (access->base == ZYDIS_REGISTER_ESP) ||
+             (access->base == ZYDIS_REGISTER_RSP)))
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_STACK;
+            if ((flags & ZYDIS_MEMORY_ACCESS_FLAG_WRITE) && ZydisIsPushingInstruction(instruction))
+            {
+                // The hidden operand describes the stack pointer before it is decremented
+                access->disp -= access->size / 8;
+            }
+        }
+
+        if (is_string && (operand->visibility != ZYDIS_OPERAND_VISIBILITY_EXPLICIT))
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_STRING;
+            if (instruction->attributes &
+                (ZYDIS_ATTRIB_HAS_REP | ZYDIS_ATTRIB_HAS_REPE | ZYDIS_ATTRIB_HAS_REPNE))
+            {
+                flags |= ZYDIS_MEMORY_ACCESS_FLAG_REPEATED;
+            }
+        }
+
+        if ((instruction->avx.broadcast.mode != ZYDIS_BROADCAST_MODE_NONE) &&
+            (operand->visibility == ZYDIS_OPERAND_VISIBILITY_EXPLICIT))
+        {
+            flags |= ZYDIS_MEMORY_ACCESS_FLAG_BROADCAST;
+            access->element_count = ZydisGetBroadcastSourceCount(instruction->avx.broadcast.mode);
+            access->size = access->element_size * access->element_count;
+        }
+
+        access->flags = flags;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisCalcMemoryAddresses(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZyanU64 runtime_address,
+    const ZydisAddressContext* context, ZydisMemoryAccesses* accesses,
+    ZydisMemoryAddresses* addresses)
+{
+    if (!context || !context->registers || !addresses)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_CHECK(ZydisGetMemoryAccesses(instruction, operands, operand_count, accesses));
+
+    addresses->count = 0;
+    for (ZyanU8 i = 0; i < accesses->count; ++i)
+    {
+        const ZydisMemoryAccess* const access = &accesses->accesses[i];
+        if (access->flags & ZYDIS_MEMORY_ACCESS_FLAG_VSIB)
+        {
+            ZYAN_CHECK(ZydisCalcVsibAddresses(instruction, operands, operand_count, context,
+                access, i, addresses));
+            continue;
+        }
+        if (addresses->count == ZYDIS_MAX_MEMORY_ADDRESS_COUNT)
+        {
+            return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+        }
+
+        ZyanU64 offset = (ZyanU64)access->disp;
+        if (access->flags & ZYDIS_MEMORY_ACCESS_FLAG_RELATIVE)
+        {
+            offset += runtime_address + instruction->length;
+        } else
+        {
+            offset += ZydisGetAddressRegisterValue(context, access->base) +
+                ZydisGetAddressRegisterValue(context, access->index) * access->scale;
+        }
+
+        ZydisMemoryAddress* const address = &addresses->addresses[addresses->count++];
+        address->address = ZydisToLinearAddress(instruction, context, access->segment, offset);
+        address->size = access->size;
+        address->access_index = i;
+        address->element_index = 0;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
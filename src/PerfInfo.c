@@ -0,0 +1,892 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/PerfInfo.h>
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ZydisPerfClass` enum.
+ *
+ * Groups instructions with similar performance characteristics.
+ */
+typedef enum ZydisPerfClass_
+{
+    ZYDIS_PERF_CLASS_ALU,
+    ZYDIS_PERF_CLASS_ALU_CARRY,
+    ZYDIS_PERF_CLASS_MOV,
+    ZYDIS_PERF_CLASS_LEA,
+    ZYDIS_PERF_CLASS_IMUL,
+    ZYDIS_PERF_CLASS_MUL_WIDE,
+    ZYDIS_PERF_CLASS_DIV,
+    ZYDIS_PERF_CLASS_DIV64,
+    ZYDIS_PERF_CLASS_SHIFT,
+    ZYDIS_PERF_CLASS_SHIFT_CL,
+    ZYDIS_PERF_CLASS_BITSCAN,
+    ZYDIS_PERF_CLASS_CMOV,
+    ZYDIS_PERF_CLASS_BRANCH,
+    ZYDIS_PERF_CLASS_CALL,
+    ZYDIS_PERF_CLASS_RET,
+    ZYDIS_PERF_CLASS_PUSH,
+    ZYDIS_PERF_CLASS_POP,
+    ZYDIS_PERF_CLASS_NOP,
+    ZYDIS_PERF_CLASS_VEC_MOV,
+    ZYDIS_PERF_CLASS_VEC_INT,
+    ZYDIS_PERF_CLASS_VEC_INT_MUL,
+    ZYDIS_PERF_CLASS_VEC_INT_MUL32,
+    ZYDIS_PERF_CLASS_VEC_SHIFT,
+    ZYDIS_PERF_CLASS_VEC_FP_ADD,
+    ZYDIS_PERF_CLASS_VEC_FP_MUL,
+    ZYDIS_PERF_CLASS_VEC_FMA,
+    ZYDIS_PERF_CLASS_VEC_FP_DIV,
+    ZYDIS_PERF_CLASS_VEC_FP_SQRT,
+    ZYDIS_PERF_CLASS_VEC_SHUFFLE,
+    ZYDIS_PERF_CLASS_VEC_LANE_CROSS,
+    ZYDIS_PERF_CLASS_VEC_BLEND,
+    ZYDIS_PERF_CLASS_VEC_CVT,
+    ZYDIS_PERF_CLASS_VEC_HORIZONTAL,
+    ZYDIS_PERF_CLASS_VEC_TRANSFER,
+    ZYDIS_PERF_CLASS_GATHER,
+    ZYDIS_PERF_CLASS_X87,
+    ZYDIS_PERF_CLASS_MICROCODED,
+
+    ZYDIS_PERF_CLASS_MAX_VALUE = ZYDIS_PERF_CLASS_MICROCODED
+} ZydisPerfClass;
+
+/**
+ * Defines the `ZydisPerfClassFlags` data-type.
+ */
+typedef ZyanU8 ZydisPerfClassFlags;
+
+/**
+ * The class operates on vector registers.
+ */
+#define ZYDIS_PERF_FLAG_VECTOR      0x01
+/**
+ * The class only moves data. Memory forms are pure loads without an execution uop.
+ */
+#define ZYDIS_PERF_FLAG_MOVE        0x02
+/**
+ * The class implicitly loads from the stack.
+ */
+#define ZYDIS_PERF_FLAG_STACK_LOAD  0x04
+/**
+ * The class implicitly stores to the stack.
+ */
+#define ZYDIS_PERF_FLAG_STACK_STORE 0x08
+
+/**
+ * Defines the `ZydisPerfEntry` struct.
+ */
+typedef struct ZydisPerfEntry_
+{
+    ZyanU8 uops;
+    ZyanU8 port_uops;
+    ZyanU8 latency;
+    ZyanU16 ports;
+} ZydisPerfEntry;
+
+/**
+ * Defines the `ZydisPerfMicroarchInfo` struct.
+ */
+typedef struct ZydisPerfMicroarchInfo_
+{
+    ZyanU8 load_latency;
+    ZyanU8 load_latency_vector;
+    ZyanU16 load_ports;
+    ZyanU16 store_ports;
+} ZydisPerfMicroarchInfo;
+
+/* ============================================================================================== */
+/* Data tables                                                                                    */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Ports                                                                                          */
+/* ---------------------------------------------------------------------------------------------- */
+
+#define P0      0x0001
+#define P1      0x0002
+#define P5      0x0020
+#define P6      0x0040
+#define P01     (P0 | P1)
+#define P05     (P0 | P5)
+#define P06     (P0 | P6)
+#define P15     (P1 | P5)
+#define P015    (P0 | P1 | P5)
+#define P0156   (P0 | P1 | P5 | P6)
+
+#define ALU1    0x0002
+#define ALU03   0x0009
+#define ALU12   0x0006
+#define ALU     0x000F
+#define FP1     0x0100
+#define FP01    0x0180
+#define FP03    0x0480
+#define FP12    0x0300
+#define FP23    0x0600
+#define FP      0x0780
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Microarchitectures                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Contains the load/store characteristics of each microarchitecture.
+ */
+static const ZydisPerfMicroarchInfo PERF_MICROARCHS[ZYDIS_MICROARCH_MAX_VALUE + 1] =
+{
+    /* SKYLAKE */ { 5, 6, 0x000C, 0x0010 },
+    /* ICELAKE */ { 5, 7, 0x000C, 0x0210 },
+    /* ZEN4    */ { 4, 7, 0x0070, 0x0030 }
+};
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Classes                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * Contains the flags of each performance class.
+ */
+static const ZydisPerfClassFlags PERF_CLASS_FLAGS[ZYDIS_PERF_CLASS_MAX_VALUE + 1] =
+{
+    /* ALU            */ 0,
+    /* ALU_CARRY      */ 0,
+    /* MOV            */ ZYDIS_PERF_FLAG_MOVE,
+    /* LEA            */ 0,
+    /* IMUL           */ 0,
+    /* MUL_WIDE       */ 0,
+    /* DIV            */ 0,
+    /* DIV64          */ 0,
+    /* SHIFT          */ 0,
+    /* SHIFT_CL       */ 0,
+    /* BITSCAN        */ 0,
+    /* CMOV           */ 0,
+    /* BRANCH         */ 0,
+    /* CALL           */ ZYDIS_PERF_FLAG_STACK_STORE,
+    /* RET            */ ZYDIS_PERF_FLAG_STACK_LOAD,
+    /* PUSH           */ ZYDIS_PERF_FLAG_STACK_STORE,
+    /* POP            */ ZYDIS_PERF_FLAG_STACK_LOAD,
+    /* NOP            */ 0,
+    /* VEC_MOV        */ ZYDIS_PERF_FLAG_VECTOR | ZYDIS_PERF_FLAG_MOVE,
+    /* VEC_INT        */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_INT_MUL    */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_INT_MUL32  */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_SHIFT      */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_FP_ADD     */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_FP_MUL     */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_FMA        */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_FP_DIV     */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_FP_SQRT    */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_SHUFFLE    */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_LANE_CROSS */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_BLEND      */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_CVT        */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_HORIZONTAL */ ZYDIS_PERF_FLAG_VECTOR,
+    /* VEC_TRANSFER   */ ZYDIS_PERF_FLAG_VECTOR,
+    /* GATHER         */ ZYDIS_PERF_FLAG_VECTOR,
+    /* X87            */ 0,
+    /* MICROCODED     */ 0
+};
+
+/**
+ * Contains the characteristics of each performance class on each microarchitecture in the
+ * format `{ uops, port_uops, latency, ports }`.
+ */
+static const ZydisPerfEntry PERF_CLASSES[ZYDIS_PERF_CLASS_MAX_VALUE + 1]
+    [ZYDIS_MICROARCH_MAX_VALUE + 1] =
+{
+    /*                    SKYLAKE                 ICELAKE                 ZEN4                  */
+    /* ALU            */ { {  1,  1,  1, P0156 }, {  1,  1,  1, P0156 }, {  1,  1,  1, ALU   } },
+    /* ALU_CARRY      */ { {  1,  1,  1, P06   }, {  1,  1,  1, P06   }, {  1,  1,  1, ALU   } },
+    /* MOV            */ { {  1,  1,  1, P0156 }, {  1,  1,  1, P0156 }, {  1,  1,  1, ALU   } },
+    /* LEA            */ { {  1,  1,  1, P15   }, {  1,  1,  1, P15   }, {  1,  1,  1, ALU   } },
+    /* IMUL           */ { {  1,  1,  3, P1    }, {  1,  1,  3, P1    }, {  1,  1,  3, ALU1  } },
+    /* MUL_WIDE       */ { {  2,  2,  4, P15   }, {  2,  2,  4, P15   }, {  2,  2,  3, ALU1  } },
+    /* DIV            */ { { 10,  6, 26, P0    }, {  4,  6, 12, P0    }, {  2,  6, 12, ALU1  } },
+    /* DIV64          */ { { 36, 21, 42, P0    }, {  4, 10, 15, P0    }, {  2, 10, 14, ALU1  } },
+    /* SHIFT          */ { {  1,  1,  1, P06   }, {  1,  1,  1, P06   }, {  1,  1,  1, ALU12 } },
+    /* SHIFT_CL       */ { {  3,  3,  2, P06   }, {  3,  3,  2, P06   }, {  1,  1,  1, ALU12 } },
+    /* BITSCAN        */ { {  1,  1,  3, P1    }, {  1,  1,  3, P1    }, {  1,  1,  1, ALU   } },
+    /* CMOV           */ { {  1,  1,  1, P06   }, {  1,  1,  1, P06   }, {  1,  1,  1, ALU   } },
+    /* BRANCH         */ { {  1,  1,  1, P06   }, {  1,  1,  1, P06   }, {  1,  1,  1, ALU03 } },
+    /* CALL           */ { {  2,  1,  1, P6    }, {  2,  1,  1, P6    }, {  2,  1,  1, ALU03 } },
+    /* RET            */ { {  2,  1,  1, P6    }, {  2,  1,  1, P6    }, {  1,  1,  1, ALU03 } },
+    /* PUSH           */ { {  1,  0,  1, 0     }, {  1,  0,  1, 0     }, {  1,  0,  1, 0     } },
+    /* POP            */ { {  1,  0,  0, 0     }, {  1,  0,  0, 0     }, {  1,  0,  0, 0     } },
+    /* NOP            */ { {  1,  0,  0, 0     }, {  1,  0,  0, 0     }, {  1,  0,  0, 0     } },
+    /* VEC_MOV        */ { {  1,  1,  1, P015  }, {  1,  1,  1, P015  }, {  1,  1,  1, FP    } },
+    /* VEC_INT        */ { {  1,  1,  1, P015  }, {  1,  1,  1, P015  }, {  1,  1,  1, FP    } },
+    /* VEC_INT_MUL    */ { {  1,  1,  5, P01   }, {  1,  1,  5, P01   }, {  1,  1,  3, FP03  } },
+    /* VEC_INT_MUL32  */ { {  2,  2, 10, P01   }, {  2,  2, 10, P01   }, {  1,  1,  3, FP03  } },
+    /* VEC_SHIFT      */ { {  1,  1,  1, P01   }, {  1,  1,  1, P01   }, {  1,  1,  1, FP12  } },
+    /* VEC_FP_ADD     */ { {  1,  1,  4, P01   }, {  1,  1,  4, P01   }, {  1,  1,  3, FP23  } },
+    /* VEC_FP_MUL     */ { {  1,  1,  4, P01   }, {  1,  1,  4, P01   }, {  1,  1,  3, FP01  } },
+    /* VEC_FMA        */ { {  1,  1,  4, P01   }, {  1,  1,  4, P01   }, {  1,  1,  4, FP01  } },
+    /* VEC_FP_DIV     */ { {  1,  4, 11, P0    }, {  1,  3, 11, P0    }, {  1,  3, 10, FP1   } },
+    /* VEC_FP_SQRT    */ { {  1,  4, 12, P0    }, {  1,  3, 12, P0    }, {  1,  5, 14, FP1   } },
+    /* VEC_SHUFFLE    */ { {  1,  1,  1, P5    }, {  1,  1,  1, P5    }, {  1,  1,  1, FP12  } },
+    /* VEC_LANE_CROSS */ { {  1,  1,  3, P5    }, {  1,  1,  3, P5    }, {  1,  1,  4, FP12  } },
+    /* VEC_BLEND      */ { {  1,  1,  1, P015  }, {  1,  1,  1, P015  }, {  1,  1,  1, FP01  } },
+    /* VEC_CVT        */ { {  1,  1,  4, P01   }, {  1,  1,  4, P01   }, {  1,  1,  3, FP23  } },
+    /* VEC_HORIZONTAL */ { {  3,  3,  6, P015  }, {  3,  3,  6, P015  }, {  4,  4,  6, FP    } },
+    /* VEC_TRANSFER   */ { {  1,  1,  2, P05   }, {  1,  1,  2, P05   }, {  1,  1,  3, FP23  } },
+    /* GATHER         */ { {  5,  5, 20, P015  }, {  5,  5, 20, P015  }, { 14, 14, 13, FP    } },
+    /* X87            */ { {  1,  1,  4, P05   }, {  1,  1,  4, P05   }, {  1,  1,  6, FP01  } },
+    /* MICROCODED     */ { { 10, 10, 10, P0156 }, { 10, 10, 10, P0156 }, { 10, 10, 10, ALU   } }
+};
+
+/* ---------------------------------------------------------------------------------------------- */
+
+#undef P0
+#undef P1
+#undef P5
+#undef P6
+#undef P01
+#undef P05
+#undef P06
+#undef P15
+#undef P015
+#undef P0156
+#undef ALU1
+#undef ALU03
+#undef ALU12
+#undef ALU
+#undef FP1
+#undef FP01
+#undef FP03
+#undef FP12
+#undef FP23
+#undef FP
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Determines the performance class of the given instruction based on its mnemonic.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   perf_class  Receives the performance class.
+ *
+ * @return  `ZYAN_TRUE`, if the mnemonic has a dedicated entry or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisPerfGetMnemonicClass(const ZydisDecodedInstruction* instruction,
+    ZydisPerfClass* perf_class)
+{
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_ADD:
+    case ZYDIS_MNEMONIC_AND:
+    case ZYDIS_MNEMONIC_CMP:
+    case ZYDIS_MNEMONIC_DEC:
+    case ZYDIS_MNEMONIC_INC:
+    case ZYDIS_MNEMONIC_NEG:
+    case ZYDIS_MNEMONIC_NOT:
+    case ZYDIS_MNEMONIC_OR:
+    case ZYDIS_MNEMONIC_SUB:
+    case ZYDIS_MNEMONIC_TEST:
+    case ZYDIS_MNEMONIC_XOR:
+    case ZYDIS_MNEMONIC_ANDN:
+    case ZYDIS_MNEMONIC_BLSI:
+    case ZYDIS_MNEMONIC_BLSMSK:
+    case ZYDIS_MNEMONIC_BLSR:
+    case ZYDIS_MNEMONIC_BSWAP:
+    case ZYDIS_MNEMONIC_CDQ:
+    case ZYDIS_MNEMONIC_CDQE:
+    case ZYDIS_MNEMONIC_CQO:
+    case ZYDIS_MNEMONIC_CWDE:
+    case ZYDIS_MNEMONIC_CLC:
+    case ZYDIS_MNEMONIC_CMC:
+    case ZYDIS_MNEMONIC_STC:
+        *perf_class = ZYDIS_PERF_CLASS_ALU;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_ADC:
+    case ZYDIS_MNEMONIC_ADCX:
+    case ZYDIS_MNEMONIC_ADOX:
+    case ZYDIS_MNEMONIC_SBB:
+    case ZYDIS_MNEMONIC_BT:
+    case ZYDIS_MNEMONIC_BTC:
+    case ZYDIS_MNEMONIC_BTR:
+    case ZYDIS_MNEMONIC_BTS:
+        *perf_class = ZYDIS_PERF_CLASS_ALU_CARRY;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_MOV:
+    case ZYDIS_MNEMONIC_MOVSX:
+    case ZYDIS_MNEMONIC_MOVSXD:
+    case ZYDIS_MNEMONIC_MOVZX:
+    case ZYDIS_MNEMONIC_MOVBE:
+        *perf_class = ZYDIS_PERF_CLASS_MOV;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_LEA:
+        *perf_class = ZYDIS_PERF_CLASS_LEA;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_IMUL:
+    case ZYDIS_MNEMONIC_MUL:
+        // The one-operand forms write the result to two registers
+        *perf_class = (instruction->operand_count_visible == 1) ?
+            ZYDIS_PERF_CLASS_MUL_WIDE : ZYDIS_PERF_CLASS_IMUL;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_MULX:
+        *perf_class = ZYDIS_PERF_CLASS_MUL_WIDE;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_DIV:
+    case ZYDIS_MNEMONIC_IDIV:
+        *perf_class = (instruction->operand_width == 64) ?
+            ZYDIS_PERF_CLASS_DIV64 : ZYDIS_PERF_CLASS_DIV;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_RCL:
+    case ZYDIS_MNEMONIC_RCR:
+        *perf_class = ZYDIS_PERF_CLASS_MICROCODED;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_ROL:
+    case ZYDIS_MNEMONIC_ROR:
+    case ZYDIS_MNEMONIC_SAR:
+    case ZYDIS_MNEMONIC_SHL:
+    case ZYDIS_MNEMONIC_SHR:
+        // `D2`/`D3` are the forms shifting by `CL`
+        *perf_class = ((instruction->opcode_map == ZYDIS_OPCODE_MAP_DEFAULT) &&
+            ((instruction->opcode == 0xD2) || (instruction->opcode == 0xD3))) ?
+            ZYDIS_PERF_CLASS_SHIFT_CL : ZYDIS_PERF_CLASS_SHIFT;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_RORX:
+    case ZYDIS_MNEMONIC_SARX:
+    case ZYDIS_MNEMONIC_SHLX:
+    case ZYDIS_MNEMONIC_SHRX:
+        *perf_class = ZYDIS_PERF_CLASS_SHIFT;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_BSF:
+    case ZYDIS_MNEMONIC_BSR:
+    case ZYDIS_MNEMONIC_LZCNT:
+    case ZYDIS_MNEMONIC_POPCNT:
+    case ZYDIS_MNEMONIC_TZCNT:
+    case ZYDIS_MNEMONIC_PDEP:
+    case ZYDIS_MNEMONIC_PEXT:
+    case ZYDIS_MNEMONIC_CRC32:
+        *perf_class = ZYDIS_PERF_CLASS_BITSCAN;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_NOP:
+        *perf_class = ZYDIS_PERF_CLASS_NOP;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_XCHG:
+        *perf_class = ZYDIS_PERF_CLASS_MICROCODED;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_MOVAPD:
+    case ZYDIS_MNEMONIC_MOVAPS:
+    case ZYDIS_MNEMONIC_MOVDQA:
+    case ZYDIS_MNEMONIC_MOVDQU:
+    case ZYDIS_MNEMONIC_MOVUPD:
+    case ZYDIS_MNEMONIC_MOVUPS:
+    case ZYDIS_MNEMONIC_VMOVAPD:
+    case ZYDIS_MNEMONIC_VMOVAPS:
+    case ZYDIS_MNEMONIC_VMOVDQA:
+    case ZYDIS_MNEMONIC_VMOVDQA32:
+    case ZYDIS_MNEMONIC_VMOVDQA64:
+    case ZYDIS_MNEMONIC_VMOVDQU:
+    case ZYDIS_MNEMONIC_VMOVDQU8:
+    case ZYDIS_MNEMONIC_VMOVDQU16:
+    case ZYDIS_MNEMONIC_VMOVDQU32:
+    case ZYDIS_MNEMONIC_VMOVDQU64:
+    case ZYDIS_MNEMONIC_VMOVUPD:
+    case ZYDIS_MNEMONIC_VMOVUPS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_MOV;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_MOVD:
+    case ZYDIS_MNEMONIC_MOVQ:
+    case ZYDIS_MNEMONIC_VMOVD:
+    case ZYDIS_MNEMONIC_VMOVQ:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_TRANSFER;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_ANDNPD:
+    case ZYDIS_MNEMONIC_ANDNPS:
+    case ZYDIS_MNEMONIC_ANDPD:
+    case ZYDIS_MNEMONIC_ANDPS:
+    case ZYDIS_MNEMONIC_ORPD:
+    case ZYDIS_MNEMONIC_ORPS:
+    case ZYDIS_MNEMONIC_XORPD:
+    case ZYDIS_MNEMONIC_XORPS:
+    case ZYDIS_MNEMONIC_PADDB:
+    case ZYDIS_MNEMONIC_PADDD:
+    case ZYDIS_MNEMONIC_PADDQ:
+    case ZYDIS_MNEMONIC_PADDW:
+    case ZYDIS_MNEMONIC_PAND:
+    case ZYDIS_MNEMONIC_PANDN:
+    case ZYDIS_MNEMONIC_PCMPEQB:
+    case ZYDIS_MNEMONIC_PCMPEQD:
+    case ZYDIS_MNEMONIC_PCMPEQW:
+    case ZYDIS_MNEMONIC_PCMPGTB:
+    case ZYDIS_MNEMONIC_PCMPGTD:
+    case ZYDIS_MNEMONIC_PCMPGTW:
+    case ZYDIS_MNEMONIC_PMAXSD:
+    case ZYDIS_MNEMONIC_PMAXUB:
+    case ZYDIS_MNEMONIC_PMINSD:
+    case ZYDIS_MNEMONIC_PMINUB:
+    case ZYDIS_MNEMONIC_POR:
+    case ZYDIS_MNEMONIC_PSUBB:
+    case ZYDIS_MNEMONIC_PSUBD:
+    case ZYDIS_MNEMONIC_PSUBQ:
+    case ZYDIS_MNEMONIC_PSUBW:
+    case ZYDIS_MNEMONIC_PXOR:
+    case ZYDIS_MNEMONIC_VANDNPD:
+    case ZYDIS_MNEMONIC_VANDNPS:
+    case ZYDIS_MNEMONIC_VANDPD:
+    case ZYDIS_MNEMONIC_VANDPS:
+    case ZYDIS_MNEMONIC_VORPD:
+    case ZYDIS_MNEMONIC_VORPS:
+    case ZYDIS_MNEMONIC_VXORPD:
+    case ZYDIS_MNEMONIC_VXORPS:
+    case ZYDIS_MNEMONIC_VPADDB:
+    case ZYDIS_MNEMONIC_VPADDD:
+    case ZYDIS_MNEMONIC_VPADDQ:
+    case ZYDIS_MNEMONIC_VPADDW:
+    case ZYDIS_MNEMONIC_VPAND:
+    case ZYDIS_MNEMONIC_VPANDD:
+    case ZYDIS_MNEMONIC_VPANDN:
+    case ZYDIS_MNEMONIC_VPANDQ:
+    case ZYDIS_MNEMONIC_VPCMPEQB:
+    case ZYDIS_MNEMONIC_VPCMPEQD:
+    case ZYDIS_MNEMONIC_VPCMPEQW:
+    case ZYDIS_MNEMONIC_VPCMPGTB:
+    case ZYDIS_MNEMONIC_VPCMPGTD:
+    case ZYDIS_MNEMONIC_VPCMPGTW:
+    case ZYDIS_MNEMONIC_VPMAXSD:
+    case ZYDIS_MNEMONIC_VPMAXUB:
+    case ZYDIS_MNEMONIC_VPMINSD:
+    case ZYDIS_MNEMONIC_VPMINUB:
+    case ZYDIS_MNEMONIC_VPOR:
+    case ZYDIS_MNEMONIC_VPORD:
+    case ZYDIS_MNEMONIC_VPORQ:
+    case ZYDIS_MNEMONIC_VPSUBB:
+    case ZYDIS_MNEMONIC_VPSUBD:
+    case ZYDIS_MNEMONIC_VPSUBQ:
+    case ZYDIS_MNEMONIC_VPSUBW:
+    case ZYDIS_MNEMONIC_VPTERNLOGD:
+    case ZYDIS_MNEMONIC_VPTERNLOGQ:
+    case ZYDIS_MNEMONIC_VPXOR:
+    case ZYDIS_MNEMONIC_VPXORD:
+    case ZYDIS_MNEMONIC_VPXORQ:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_INT;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_PMADDWD:
+    case ZYDIS_MNEMONIC_PMULHW:
+    case ZYDIS_MNEMONIC_PMULLW:
+    case ZYDIS_MNEMONIC_PMULUDQ:
+    case ZYDIS_MNEMONIC_VPMADDWD:
+    case ZYDIS_MNEMONIC_VPMULHW:
+    case ZYDIS_MNEMONIC_VPMULLW:
+    case ZYDIS_MNEMONIC_VPMULUDQ:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_INT_MUL;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_PMULLD:
+    case ZYDIS_MNEMONIC_VPMULLD:
+    case ZYDIS_MNEMONIC_VPMULLQ:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_INT_MUL32;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_PSLLD:
+    case ZYDIS_MNEMONIC_PSLLQ:
+    case ZYDIS_MNEMONIC_PSLLW:
+    case ZYDIS_MNEMONIC_PSRAD:
+    case ZYDIS_MNEMONIC_PSRAW:
+    case ZYDIS_MNEMONIC_PSRLD:
+    case ZYDIS_MNEMONIC_PSRLQ:
+    case ZYDIS_MNEMONIC_PSRLW:
+    case ZYDIS_MNEMONIC_VPSLLD:
+    case ZYDIS_MNEMONIC_VPSLLQ:
+    case ZYDIS_MNEMONIC_VPSLLVD:
+    case ZYDIS_MNEMONIC_VPSLLVQ:
+    case ZYDIS_MNEMONIC_VPSLLW:
+    case ZYDIS_MNEMONIC_VPSRAD:
+    case ZYDIS_MNEMONIC_VPSRAW:
+    case ZYDIS_MNEMONIC_VPSRLD:
+    case ZYDIS_MNEMONIC_VPSRLQ:
+    case ZYDIS_MNEMONIC_VPSRLVD:
+    case ZYDIS_MNEMONIC_VPSRLVQ:
+    case ZYDIS_MNEMONIC_VPSRLW:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_SHIFT;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_ADDPD:
+    case ZYDIS_MNEMONIC_ADDPS:
+    case ZYDIS_MNEMONIC_ADDSD:
+    case ZYDIS_MNEMONIC_ADDSS:
+    case ZYDIS_MNEMONIC_CMPPD:
+    case ZYDIS_MNEMONIC_CMPPS:
+    case ZYDIS_MNEMONIC_CMPSD:
+    case ZYDIS_MNEMONIC_CMPSS:
+    case ZYDIS_MNEMONIC_MAXPD:
+    case ZYDIS_MNEMONIC_MAXPS:
+    case ZYDIS_MNEMONIC_MAXSD:
+    case ZYDIS_MNEMONIC_MAXSS:
+    case ZYDIS_MNEMONIC_MINPD:
+    case ZYDIS_MNEMONIC_MINPS:
+    case ZYDIS_MNEMONIC_MINSD:
+    case ZYDIS_MNEMONIC_MINSS:
+    case ZYDIS_MNEMONIC_SUBPD:
+    case ZYDIS_MNEMONIC_SUBPS:
+    case ZYDIS_MNEMONIC_SUBSD:
+    case ZYDIS_MNEMONIC_SUBSS:
+    case ZYDIS_MNEMONIC_VADDPD:
+    case ZYDIS_MNEMONIC_VADDPS:
+    case ZYDIS_MNEMONIC_VADDSD:
+    case ZYDIS_MNEMONIC_VADDSS:
+    case ZYDIS_MNEMONIC_VCMPPD:
+    case ZYDIS_MNEMONIC_VCMPPS:
+    case ZYDIS_MNEMONIC_VCMPSD:
+    case ZYDIS_MNEMONIC_VCMPSS:
+    case ZYDIS_MNEMONIC_VMAXPD:
+    case ZYDIS_MNEMONIC_VMAXPS:
+    case ZYDIS_MNEMONIC_VMAXSD:
+    case ZYDIS_MNEMONIC_VMAXSS:
+    case ZYDIS_MNEMONIC_VMINPD:
+    case ZYDIS_MNEMONIC_VMINPS:
+    case ZYDIS_MNEMONIC_VMINSD:
+    case ZYDIS_MNEMONIC_VMINSS:
+    case ZYDIS_MNEMONIC_VSUBPD:
+    case ZYDIS_MNEMONIC_VSUBPS:
+    case ZYDIS_MNEMONIC_VSUBSD:
+    case ZYDIS_MNEMONIC_VSUBSS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_FP_ADD;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_MULPD:
+    case ZYDIS_MNEMONIC_MULPS:
+    case ZYDIS_MNEMONIC_MULSD:
+    case ZYDIS_MNEMONIC_MULSS:
+    case ZYDIS_MNEMONIC_VMULPD:
+    case ZYDIS_MNEMONIC_VMULPS:
+    case ZYDIS_MNEMONIC_VMULSD:
+    case ZYDIS_MNEMONIC_VMULSS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_FP_MUL;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_DIVPD:
+    case ZYDIS_MNEMONIC_DIVPS:
+    case ZYDIS_MNEMONIC_DIVSD:
+    case ZYDIS_MNEMONIC_DIVSS:
+    case ZYDIS_MNEMONIC_VDIVPD:
+    case ZYDIS_MNEMONIC_VDIVPS:
+    case ZYDIS_MNEMONIC_VDIVSD:
+    case ZYDIS_MNEMONIC_VDIVSS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_FP_DIV;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_SQRTPD:
+    case ZYDIS_MNEMONIC_SQRTPS:
+    case ZYDIS_MNEMONIC_SQRTSD:
+    case ZYDIS_MNEMONIC_SQRTSS:
+    case ZYDIS_MNEMONIC_VSQRTPD:
+    case ZYDIS_MNEMONIC_VSQRTPS:
+    case ZYDIS_MNEMONIC_VSQRTSD:
+    case ZYDIS_MNEMONIC_VSQRTSS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_FP_SQRT;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_PSHUFB:
+    case ZYDIS_MNEMONIC_PSHUFD:
+    case ZYDIS_MNEMONIC_PUNPCKHDQ:
+    case ZYDIS_MNEMONIC_PUNPCKLDQ:
+    case ZYDIS_MNEMONIC_SHUFPD:
+    case ZYDIS_MNEMONIC_SHUFPS:
+    case ZYDIS_MNEMONIC_UNPCKHPD:
+    case ZYDIS_MNEMONIC_UNPCKHPS:
+    case ZYDIS_MNEMONIC_UNPCKLPD:
+    case ZYDIS_MNEMONIC_UNPCKLPS:
+    case ZYDIS_MNEMONIC_VPSHUFB:
+    case ZYDIS_MNEMONIC_VPSHUFD:
+    case ZYDIS_MNEMONIC_VPUNPCKHDQ:
+    case ZYDIS_MNEMONIC_VPUNPCKLDQ:
+    case ZYDIS_MNEMONIC_VSHUFPD:
+    case ZYDIS_MNEMONIC_VSHUFPS:
+    case ZYDIS_MNEMONIC_VUNPCKHPD:
+    case ZYDIS_MNEMONIC_VUNPCKHPS:
+    case ZYDIS_MNEMONIC_VUNPCKLPD:
+    case ZYDIS_MNEMONIC_VUNPCKLPS:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_SHUFFLE;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_VEXTRACTF128:
+    case ZYDIS_MNEMONIC_VEXTRACTI128:
+    case ZYDIS_MNEMONIC_VINSERTF128:
+    case ZYDIS_MNEMONIC_VINSERTI128:
+    case ZYDIS_MNEMONIC_VPERM2F128:
+    case ZYDIS_MNEMONIC_VPERM2I128:
+    case ZYDIS_MNEMONIC_VPERMD:
+    case ZYDIS_MNEMONIC_VPERMPD:
+    case ZYDIS_MNEMONIC_VPERMPS:
+    case ZYDIS_MNEMONIC_VPERMQ:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_LANE_CROSS;
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_HADDPD:
+    case ZYDIS_MNEMONIC_HADDPS:
+    case ZYDIS_MNEMONIC_HSUBPD:
+    case ZYDIS_MNEMONIC_HSUBPS:
+    case ZYDIS_MNEMONIC_PHADDD:
+    case ZYDIS_MNEMONIC_PHADDW:
+    case ZYDIS_MNEMONIC_VHADDPD:
+    case ZYDIS_MNEMONIC_VHADDPS:
+    case ZYDIS_MNEMONIC_VHSUBPD:
+    case ZYDIS_MNEMONIC_VHSUBPS:
+    case ZYDIS_MNEMONIC_VPHADDD:
+    case ZYDIS_MNEMONIC_VPHADDW:
+        *perf_class = ZYDIS_PERF_CLASS_VEC_HORIZONTAL;
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/**
+ * Determines the performance class of the given instruction based on its category.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  The performance class.
+ */
+static ZydisPerfClass ZydisPerfGetCategoryClass(const ZydisDecodedInstruction* instruction)
+{
+    const ZyanBool is_vector = (instruction->encoding != ZYDIS_INSTRUCTION_ENCODING_LEGACY) &&
+        (instruction->encoding != ZYDIS_INSTRUCTION_ENCODING_REX2);
+
+    switch (instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_BINARY:
+    case ZYDIS_CATEGORY_LOGICAL:
+    case ZYDIS_CATEGORY_FLAGOP:
+    case ZYDIS_CATEGORY_BMI1:
+    case ZYDIS_CATEGORY_BMI2:
+        return ZYDIS_PERF_CLASS_ALU;
+    case ZYDIS_CATEGORY_BITBYTE:
+    case ZYDIS_CATEGORY_SETCC:
+        return ZYDIS_PERF_CLASS_ALU_CARRY;
+    case ZYDIS_CATEGORY_DATAXFER:
+        return is_vector ? ZYDIS_PERF_CLASS_VEC_MOV : ZYDIS_PERF_CLASS_MOV;
+    case ZYDIS_CATEGORY_SHIFT:
+    case ZYDIS_CATEGORY_ROTATE:
+        return ZYDIS_PERF_CLASS_SHIFT;
+    case ZYDIS_CATEGORY_LZCNT:
+        return ZYDIS_PERF_CLASS_BITSCAN;
+    case ZYDIS_CATEGORY_CMOV:
+        return ZYDIS_PERF_CLASS_CMOV;
+    case ZYDIS_CATEGORY_COND_BR:
+    case ZYDIS_CATEGORY_UNCOND_BR:
+        return ZYDIS_PERF_CLASS_BRANCH;
+    case ZYDIS_CATEGORY_CALL:
+        return ZYDIS_PERF_CLASS_CALL;
+    case ZYDIS_CATEGORY_RET:
+        return ZYDIS_PERF_CLASS_RET;
+    case ZYDIS_CATEGORY_PUSH:
+        return ZYDIS_PERF_CLASS_PUSH;
+    case ZYDIS_CATEGORY_POP:
+        return ZYDIS_PERF_CLASS_POP;
+    case ZYDIS_CATEGORY_NOP:
+    case ZYDIS_CATEGORY_WIDENOP:
+        return ZYDIS_PERF_CLASS_NOP;
+    case ZYDIS_CATEGORY_CONVERT:
+        return is_vector || (instruction->meta.isa_ext != ZYDIS_ISA_EXT_BASE) ?
+            ZYDIS_PERF_CLASS_VEC_CVT : ZYDIS_PERF_CLASS_ALU;
+    case ZYDIS_CATEGORY_LOGICAL_FP:
+    case ZYDIS_CATEGORY_SSE:
+    case ZYDIS_CATEGORY_MMX:
+    case ZYDIS_CATEGORY_AVX:
+    case ZYDIS_CATEGORY_AVX2:
+    case ZYDIS_CATEGORY_AVX512:
+        return ZYDIS_PERF_CLASS_VEC_INT;
+    case ZYDIS_CATEGORY_VFMA:
+    case ZYDIS_CATEGORY_FMA4:
+    case ZYDIS_CATEGORY_IFMA:
+        return ZYDIS_PERF_CLASS_VEC_FMA;
+    case ZYDIS_CATEGORY_BLEND:
+        return ZYDIS_PERF_CLASS_VEC_BLEND;
+    case ZYDIS_CATEGORY_BROADCAST:
+        return ZYDIS_PERF_CLASS_VEC_SHUFFLE;
+    case ZYDIS_CATEGORY_AVX2GATHER:
+    case ZYDIS_CATEGORY_GATHER:
+        return ZYDIS_PERF_CLASS_GATHER;
+    case ZYDIS_CATEGORY_X87_ALU:
+        return ZYDIS_PERF_CLASS_X87;
+    default:
+        return ZYDIS_PERF_CLASS_MICROCODED;
+    }
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisGetInstructionPerfInfo(const ZydisDecodedInstruction* instruction,
+    ZydisMicroarchitecture uarch, ZydisInstructionPerfInfo* info)
+{
+    if (!instruction || ((ZyanUSize)uarch > ZYDIS_MICROARCH_MAX_VALUE) || !info)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisPerfClass perf_class;
+    info->is_estimated = !ZydisPerfGetMnemonicClass(instruction, &perf_class);
+    if (info->is_estimated)
+    {
+        perf_class = ZydisPerfGetCategoryClass(instruction);
+    }
+
+    const ZydisPerfEntry* const entry = &PERF_CLASSES[perf_class][uarch];
+    const ZydisPerfClassFlags flags = PERF_CLASS_FLAGS[perf_class];
+    const ZydisPerfMicroarchInfo* const microarch = &PERF_MICROARCHS[uarch];
+
+    info->uops = entry->uops;
+    info->port_uops = entry->port_uops;
+    info->latency = entry->latency;
+    info->ports = entry->ports;
+    info->load_ports = microarch->load_ports;
+    info->store_ports = microarch->store_ports;
+    info->is_stack_load = (flags & ZYDIS_PERF_FLAG_STACK_LOAD) ? ZYAN_TRUE : ZYAN_FALSE;
+    info->is_stack_store = (flags & ZYDIS_PERF_FLAG_STACK_STORE) ? ZYAN_TRUE : ZYAN_FALSE;
+    info->has_memory_operand = (instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM) &&
+        (instruction->raw.modrm.mod != 3);
+
+    info->load_latency = 0;
+    if (info->has_memory_operand || info->is_stack_load)
+    {
+        info->load_latency = (flags & ZYDIS_PERF_FLAG_VECTOR) ?
+            microarch->load_latency_vector : microarch->load_latency;
+    }
+    if (info->has_memory_operand && (flags & ZYDIS_PERF_FLAG_MOVE))
+    {
+        // Pure loads (and stores) don't need an execution uop
+        info->port_uops = 0;
+        info->latency = 0;
+        info->ports = 0;
+    }
+
+    if (instruction->avx.vector_length == 512)
+    {
+        switch (uarch)
+        {
+        case ZYDIS_MICROARCH_ICELAKE:
+            // The vector units of port 0 and 1 are fused to a single 512-bit unit
+            if (info->ports & ~0x0002)
+            {
+                info->ports &= ~0x0002;
+            }
+            break;
+        case ZYDIS_MICROARCH_ZEN4:
+            // 512-bit operations are executed on the 256-bit units in two cycles
+            info->port_uops *= 2;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanBool ZydisIsMacroFusedPair(const ZydisDecodedInstruction* first,
+    const ZydisDecodedInstruction* second, ZydisMicroarchitecture uarch)
+{
+    if (!first || !second ||
+        (first->encoding != ZYDIS_INSTRUCTION_ENCODING_LEGACY) ||
+        (first->opcode_map != ZYDIS_OPCODE_MAP_DEFAULT))
+    {
+        return ZYAN_FALSE;
+    }
+
+    // Intel Optimization Reference Manual "Macro-Fusion": `RIP`-relative and memory-immediate
+    // forms never fuse. `CMP` and `TEST` fuse with a memory operand in either position, while
+    // `ADD`, `SUB`, `AND`, `INC` and `DEC` only fuse with a memory source and a register
+    // destination. The same restrictions apply to AMD processors
+    if ((first->attributes & ZYDIS_ATTRIB_HAS_MODRM) && (first->raw.modrm.mod != 3))
+    {
+        if (first->raw.imm[0].size)
+        {
+            return ZYAN_FALSE;
+        }
+        if ((first->machine_mode == ZYDIS_MACHINE_MODE_LONG_64) &&
+            (first->raw.modrm.mod == 0) && (first->raw.modrm.rm == 5))
+        {
+            return ZYAN_FALSE;
+        }
+        // The `ModRM.rm` memory operand is the written first operand, unless the direction bit
+        // of the `00..3F` ALU opcodes selects the `reg, r/m` form
+        const ZyanBool is_memory_destination =
+            (first->opcode >= 0x40) || !(first->opcode & 0x02);
+        if (is_memory_destination &&
+            (first->mnemonic != ZYDIS_MNEMONIC_CMP) && (first->mnemonic != ZYDIS_MNEMONIC_TEST))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    // 0 = fuses with everything, 1 = reads `CF`, 2 = reads `OF`/`SF`/`PF`
+    ZyanU8 condition_class;
+    switch (second->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_JZ:
+    case ZYDIS_MNEMONIC_JNZ:
+    case ZYDIS_MNEMONIC_JL:
+    case ZYDIS_MNEMONIC_JNL:
+    case ZYDIS_MNEMONIC_JLE:
+    case ZYDIS_MNEMONIC_JNLE:
+        condition_class = 0;
+        break;
+    case ZYDIS_MNEMONIC_JB:
+    case ZYDIS_MNEMONIC_JNB:
+    case ZYDIS_MNEMONIC_JBE:
+    case ZYDIS_MNEMONIC_JNBE:
+        condition_class = 1;
+        break;
+    case ZYDIS_MNEMONIC_JO:
+    case ZYDIS_MNEMONIC_JNO:
+    case ZYDIS_MNEMONIC_JS:
+    case ZYDIS_MNEMONIC_JNS:
+    case ZYDIS_MNEMONIC_JP:
+    case ZYDIS_MNEMONIC_JNP:
+        condition_class = 2;
+        break;
+    default:
+        return ZYAN_FALSE;
+    }
+
+    if (uarch == ZYDIS_MICROARCH_ZEN4)
+    {
+        // AMD Software Optimization Guide: only `CMP` and `TEST` fuse, with all conditions
+        return (first->mnemonic == ZYDIS_MNEMONIC_CMP) || (first->mnemonic == ZYDIS_MNEMONIC_TEST);
+    }
+
+    switch (first->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_TEST:
+    case ZYDIS_MNEMONIC_AND:
+        return ZYAN_TRUE;
+    case ZYDIS_MNEMONIC_CMP:
+    case ZYDIS_MNEMONIC_ADD:
+    case ZYDIS_MNEMONIC_SUB:
+        return condition_class <= 1;
+    case ZYDIS_MNEMONIC_INC:
+    case ZYDIS_MNEMONIC_DEC:
+        return condition_class == 0;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,203 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/References.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Calculates the absolute address of a `RIP`/`EIP`-relative memory operand.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   runtime_address The runtime address of the instruction.
+ * @param   address         Receives the absolute address.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction has a `RIP`/`EIP`-relative memory operand or
+ *          `ZYAN_FALSE`, if not.
+ *
+ * Mirrors the `MEM` case of `ZydisCalcAbsoluteAddress`.
+ */
+static ZyanBool ZydisGetMemoryReference(const ZydisDecodedInstruction* instruction,
+    ZyanU64 runtime_address, ZyanU64* address)
+{
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(address);
+
+    // `modrm.mod == 0` and `modrm.rm == 5` selects `disp32` without base register in 16/32-bit
+    // mode and `RIP`/`EIP`-relative addressing in 64-bit mode. Instructions that force the
+    // register form (e.g. `MOV CR0, RAX`) don't consume a displacement
+    if ((instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) ||
+        !(instruction->attributes & ZYDIS_ATTRIB_HAS_MODRM) ||
+        (instruction->raw.modrm.mod != 0) || (instruction->raw.modrm.rm != 5) ||
+        (instruction->raw.disp.size != 32))
+    {
+        return ZYAN_FALSE;
+    }
+
+    if (instruction->address_width == 32)
+    {
+        *address = ((ZyanU32)runtime_address + instruction->length +
+            (ZyanU32)instruction->raw.disp.value);
+    } else
+    {
+        *address = (ZyanU64)(runtime_address + instruction->length + instruction->raw.disp.value);
+    }
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * Calculates the absolute target address of a relative immediate.
+ *
+ * @param   instruction     A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   index           The index of the raw immediate.
+ * @param   runtime_address The runtime address of the instruction.
+ * @param   address         Receives the absolute address.
+ *
+ * @return  `ZYAN_TRUE`, if the immediate is a relative address or `ZYAN_FALSE`, if not.
+ *
+ * Mirrors the relative `IMM` case of `ZydisCalcAbsoluteAddress`.
+ */
+// Signed integer overflow is expected behavior in this function, for wrapping around the
+// instruction pointer on jumps right at the end of the address space.
+ZYAN_NO_SANITIZE("signed-integer-overflow")
+static ZyanBool ZydisGetBranchReference(const ZydisDecodedInstruction* instruction, ZyanU8 index,
+    ZyanU64 runtime_address, ZyanU64* address)
+{
+    ZYAN_ASSERT(instruction);
+    ZYAN_ASSERT(index < ZYAN_ARRAY_LENGTH(instruction->raw.imm));
+    ZYAN_ASSERT(address);
+
+    if (!instruction->raw.imm[index].size || !instruction->raw.imm[index].is_address ||
+        !instruction->raw.imm[index].is_signed || !instruction->raw.imm[index].is_relative)
+    {
+        return ZYAN_FALSE;
+    }
+
+    *address = (ZyanU64)((ZyanI64)runtime_address + instruction->length +
+        instruction->raw.imm[index].value.s);
+    switch (instruction->machine_mode)
+    {
+    case ZYDIS_MACHINE_MODE_LONG_COMPAT_16:
+    case ZYDIS_MACHINE_MODE_LEGACY_16:
+    case ZYDIS_MACHINE_MODE_REAL_16:
+    case ZYDIS_MACHINE_MODE_LONG_COMPAT_32:
+    case ZYDIS_MACHINE_MODE_LEGACY_32:
+        // `XBEGIN` does not truncate the computed address (see `ZydisCalcAbsoluteAddress`)
+        if ((instruction->operand_width == 16) &&
+            (instruction->mnemonic != ZYDIS_MNEMONIC_XBEGIN))
+        {
+            *address &= 0xFFFF;
+        }
+        return ZYAN_TRUE;
+    case ZYDIS_MACHINE_MODE_LONG_64:
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisScanReferences(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZyanU64 runtime_address, ZyanUSize* offset, ZydisReference* references,
+    ZyanUSize* count)
+{
+    if (!decoder || !buffer || !offset || !count || (*count && !references) ||
+        (*offset > length))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* data = (const ZyanU8*)buffer;
+    const ZyanUSize capacity = *count;
+    ZyanUSize position = *offset;
+    ZyanUSize size = 0;
+
+    ZydisDecodedInstruction instruction;
+    while (position < length)
+    {
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, ZYAN_NULL, data + position,
+            length - position, &instruction)))
+        {
+            ++position;
+            continue;
+        }
+
+        if (instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
+        {
+            const ZyanU64 address = runtime_address + position;
+
+            ZydisReference found[3];
+            ZyanU8 found_count = 0;
+            if (ZydisGetMemoryReference(&instruction, address, &found[found_count].address))
+            {
+                found[found_count].kind = ZYDIS_REFERENCE_KIND_MEMORY;
+                found[found_count].field_offset = instruction.raw.disp.offset;
+                found[found_count].field_size = instruction.raw.disp.size;
+                ++found_count;
+            }
+            for (ZyanU8 i = 0; i < ZYAN_ARRAY_LENGTH(instruction.raw.imm); ++i)
+            {
+                if (ZydisGetBranchReference(&instruction, i, address,
+                    &found[found_count].address))
+                {
+                    found[found_count].kind = (instruction.mnemonic == ZYDIS_MNEMONIC_CALL) ?
+                        ZYDIS_REFERENCE_KIND_CALL : ZYDIS_REFERENCE_KIND_BRANCH;
+                    found[found_count].field_offset = instruction.raw.imm[i].offset;
+                    found[found_count].field_size = instruction.raw.imm[i].size;
+                    ++found_count;
+                }
+            }
+
+            // Never split the references of a single instruction across multiple calls
+            if (found_count > capacity - size)
+            {
+                break;
+            }
+            for (ZyanU8 i = 0; i < found_count; ++i)
+            {
+                found[i].offset = position;
+                found[i].length = instruction.length;
+                references[size++] = found[i];
+            }
+        }
+
+        position += instruction.length;
+    }
+
+    *offset = position;
+    *count = size;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
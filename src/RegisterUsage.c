@@ -0,0 +1,336 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/RegisterUsage.h>
+#include <Zydis/Internal/RegisterSet.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Adds the register with the given index to the given register set.
+ *
+ * @param   set     A pointer to the `ZydisRegisterSet` struct.
+ * @param   index   The bit index.
+ */
+static void ZydisRegisterSetAddIndex(ZydisRegisterSet* set, ZyanI16 index)
+{
+    if (index >= 0)
+    {
+        set->bits[index >> 6] |= 1ULL << (index & 63);
+    }
+}
+
+/**
+ * Checks if a write to the given register operand preserves parts of the previous value of the
+ * enclosing register.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   reg         The written register.
+ *
+ * @return  `ZYAN_TRUE`, if the write is partial or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisIsPartialWrite(const ZydisDecodedInstruction* instruction,
+    ZydisRegister reg)
+{
+    switch (ZydisRegisterGetClass(reg))
+    {
+    case ZYDIS_REGCLASS_GPR8:
+    case ZYDIS_REGCLASS_GPR16:
+        return ZYAN_TRUE;
+    case ZYDIS_REGCLASS_GPR32:
+        // 32-bit writes are zero-extended in 64-bit mode
+        return ZYAN_FALSE;
+    case ZYDIS_REGCLASS_XMM:
+    case ZYDIS_REGCLASS_YMM:
+    case ZYDIS_REGCLASS_ZMM:
+        // Legacy `SSE` instructions preserve the upper bits, `VEX`/`EVEX` encoded ones zero them
+        if ((instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_LEGACY) ||
+            (instruction->encoding == ZYDIS_INSTRUCTION_ENCODING_REX2))
+        {
+            return ZYAN_TRUE;
+        }
+        return (instruction->avx.mask.mode == ZYDIS_MASK_MODE_MERGING);
+    case ZYDIS_REGCLASS_FLAGS:
+        // Instructions rarely replace all flags, so flag writes are always treated as partial
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/**
+ * Adds the given flags to the given register set.
+ *
+ * @param   set     A pointer to the `ZydisRegisterSet` struct.
+ * @param   base    The bit index of the first flag.
+ * @param   flags   The flags mask.
+ */
+static void ZydisRegisterSetAddFlags(ZydisRegisterSet* set, ZyanU8 base,
+    ZydisAccessedFlagsMask flags)
+{
+    const ZyanU64 mask = (ZyanU64)flags << (base & 63);
+    set->bits[base >> 6] |= mask;
+}
+
+/**
+ * Adds the accessed CPU and FPU flags of the given instruction to the given usage.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   usage       A pointer to the `ZydisRegisterUsage` struct.
+ */
+static void ZydisAddFlagUsage(const ZydisDecodedInstruction* instruction,
+    ZydisRegisterUsage* usage)
+{
+    const ZyanI16 flags_index = ZydisRegisterGetSetIndex(ZYDIS_REGISTER_RFLAGS);
+    const ZyanBool reads_flags = (usage->read.bits[flags_index >> 6] >> (flags_index & 63)) & 1;
+    const ZyanBool writes_flags =
+        (usage->cond_write.bits[flags_index >> 6] >> (flags_index & 63)) & 1;
+
+    // `ZYDIS_CPUFLAG_*` masks use the `EFLAGS` bit positions, which leaves room for all flags
+    ZYAN_STATIC_ASSERT(ZYDIS_REGISTER_SET_CPUFLAGS % 64 + 22 <= 64);
+    ZYAN_STATIC_ASSERT(ZYDIS_REGISTER_SET_FPUFLAGS % 64 + 4 <= 64);
+    const ZydisAccessedFlagsMask all_cpu_flags = (1ul << 22) - 1;
+
+    const ZydisAccessedFlags* const cpu_flags = instruction->cpu_flags;
+    if (cpu_flags)
+    {
+        const ZydisAccessedFlagsMask written = cpu_flags->modified | cpu_flags->set_0 |
+            cpu_flags->set_1 | cpu_flags->undefined;
+        ZydisRegisterSetAddFlags(&usage->read, ZYDIS_REGISTER_SET_CPUFLAGS,
+            (reads_flags && !cpu_flags->tested) ? all_cpu_flags : cpu_flags->tested);
+        ZydisRegisterSetAddFlags(&usage->write, ZYDIS_REGISTER_SET_CPUFLAGS, written);
+        if (writes_flags && !written)
+        {
+            // E.g. `POPF`, the affected flags are unknown
+            ZydisRegisterSetAddFlags(&usage->cond_write, ZYDIS_REGISTER_SET_CPUFLAGS,
+                all_cpu_flags);
+        }
+    }
+
+    const ZydisAccessedFlags* const fpu_flags = instruction->fpu_flags;
+    if (fpu_flags)
+    {
+        ZydisRegisterSetAddFlags(&usage->read, ZYDIS_REGISTER_SET_FPUFLAGS, fpu_flags->tested);
+        ZydisRegisterSetAddFlags(&usage->write, ZYDIS_REGISTER_SET_FPUFLAGS,
+            fpu_flags->modified | fpu_flags->set_0 | fpu_flags->set_1 | fpu_flags->undefined);
+    }
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanI16 ZydisRegisterGetSetIndex(ZydisRegister reg)
+{
+    const ZydisRegisterClass reg_class = ZydisRegisterGetClass(reg);
+    const ZyanI8 id = ZydisRegisterGetId(reg);
+    switch (reg_class)
+    {
+    case ZYDIS_REGCLASS_GPR8:
+        // `AH`, `CH`, `DH` and `BH` share the id space with the other 8-bit registers
+        return ZydisRegisterGetId(ZydisRegisterGetLargestEnclosing(ZYDIS_MACHINE_MODE_LONG_64,
+            reg));
+    case ZYDIS_REGCLASS_GPR16:
+    case ZYDIS_REGCLASS_GPR32:
+    case ZYDIS_REGCLASS_GPR64:
+        return id;
+    case ZYDIS_REGCLASS_XMM:
+    case ZYDIS_REGCLASS_YMM:
+    case ZYDIS_REGCLASS_ZMM:
+        return 32 + id;
+    case ZYDIS_REGCLASS_FLAGS:
+        return 64;
+    case ZYDIS_REGCLASS_IP:
+        return 65;
+    case ZYDIS_REGCLASS_MASK:
+        return 66 + id;
+    case ZYDIS_REGCLASS_SEGMENT:
+        return 74 + id;
+    case ZYDIS_REGCLASS_X87:
+        return 128 + id;
+    case ZYDIS_REGCLASS_MMX:
+        return 136 + id;
+    case ZYDIS_REGCLASS_TMM:
+        return 144 + id;
+    case ZYDIS_REGCLASS_TABLE:
+        return 152 + id;
+    case ZYDIS_REGCLASS_TEST:
+        return 156 + id;
+    case ZYDIS_REGCLASS_CONTROL:
+        return 164 + id;
+    case ZYDIS_REGCLASS_DEBUG:
+        return 180 + id;
+    case ZYDIS_REGCLASS_BOUND:
+        return 196 + id;
+    case ZYDIS_REGCLASS_INVALID:
+        break;
+    default:
+        return -1;
+    }
+
+    switch (reg)
+    {
+    case ZYDIS_REGISTER_X87CONTROL:
+        return 200;
+    case ZYDIS_REGISTER_X87STATUS:
+        return 201;
+    case ZYDIS_REGISTER_X87TAG:
+        return 202;
+    case ZYDIS_REGISTER_BNDCFG:
+        return 203;
+    case ZYDIS_REGISTER_BNDSTATUS:
+        return 204;
+    case ZYDIS_REGISTER_MXCSR:
+        return 205;
+    case ZYDIS_REGISTER_PKRU:
+        return 206;
+    case ZYDIS_REGISTER_XCR0:
+        return 207;
+    case ZYDIS_REGISTER_UIF:
+        return 208;
+    case ZYDIS_REGISTER_IA32_KERNEL_GS_BASE:
+        return 209;
+    default:
+        return -1;
+    }
+}
+
+ZyanStatus ZydisRegisterSetAdd(ZydisRegisterSet* set, ZydisRegister reg)
+{
+    if (!set)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanI16 index = ZydisRegisterGetSetIndex(reg);
+    if (index < 0)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    ZydisRegisterSetAddIndex(set, index);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanBool ZydisRegisterSetContains(const ZydisRegisterSet* set, ZydisRegister reg)
+{
+    const ZyanI16 index = ZydisRegisterGetSetIndex(reg);
+    if (!set || (index < 0))
+    {
+        return ZYAN_FALSE;
+    }
+
+    return (set->bits[index >> 6] >> (index & 63)) & 1;
+}
+
+ZyanStatus ZydisRegisterSetUnion(ZydisRegisterSet* result, const ZydisRegisterSet* a,
+    const ZydisRegisterSet* b)
+{
+    if (!result || !a || !b)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisRegisterSetOr(result, a, b);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisRegisterSetDifference(ZydisRegisterSet* result, const ZydisRegisterSet* a,
+    const ZydisRegisterSet* b)
+{
+    if (!result || !a || !b)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZydisRegisterSetAndNot(result, a, b);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZydisGetRegisterUsage(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU8 operand_count, ZydisRegisterUsage* usage)
+{
+    if (!instruction || (!operands && operand_count) || !usage)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_MEMSET(usage, 0, sizeof(*usage));
+
+    for (ZyanU8 i = 0; i < operand_count; ++i)
+    {
+        const ZydisDecodedOperand* const operand = &operands[i];
+        switch (operand->type)
+        {
+        case ZYDIS_OPERAND_TYPE_REGISTER:
+        {
+            const ZyanI16 index = ZydisRegisterGetSetIndex(operand->reg.value);
+            if (operand->actions & ZYDIS_OPERAND_ACTION_MASK_READ)
+            {
+                ZydisRegisterSetAddIndex(&usage->read, index);
+            }
+            if (operand->actions & ZYDIS_OPERAND_ACTION_CONDWRITE)
+            {
+                ZydisRegisterSetAddIndex(&usage->cond_write, index);
+            } else if (operand->actions & ZYDIS_OPERAND_ACTION_WRITE)
+            {
+                ZydisRegisterSetAddIndex(ZydisIsPartialWrite(instruction, operand->reg.value)
+                    ? &usage->cond_write
+                    : &usage->write, index);
+            }
+            break;
+        }
+        case ZYDIS_OPERAND_TYPE_MEMORY:
+            ZydisRegisterSetAddIndex(&usage->read, ZydisRegisterGetSetIndex(operand->mem.base));
+            ZydisRegisterSetAddIndex(&usage->read, ZydisRegisterGetSetIndex(operand->mem.index));
+            if ((operand->mem.type != ZYDIS_MEMOP_TYPE_AGEN) &&
+                ((instruction->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) ||
+                 (operand->mem.segment == ZYDIS_REGISTER_FS) ||
+                 (operand->mem.segment == ZYDIS_REGISTER_GS)))
+            {
+                ZydisRegisterSetAddIndex(&usage->read,
+                    ZydisRegisterGetSetIndex(operand->mem.segment));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    ZydisAddFlagUsage(instruction, usage);
+
+    // A register both fully and partially written (e.g. by hidden operands) is fully written
+    ZydisRegisterSetAndNot(&usage->cond_write, &usage->cond_write, &usage->write);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
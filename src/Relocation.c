@@ -0,0 +1,266 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/Relocation.h>
+#include <Zydis/Utils.h>
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Checks if the given instruction only exists with a `rel8` branch offset.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction can't be promoted to a larger encoding or
+ *          `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisRelocateIsShortOnly(const ZydisDecodedInstruction* instruction)
+{
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_JCXZ:
+    case ZYDIS_MNEMONIC_JECXZ:
+    case ZYDIS_MNEMONIC_JRCXZ:
+    case ZYDIS_MNEMONIC_LOOP:
+    case ZYDIS_MNEMONIC_LOOPE:
+    case ZYDIS_MNEMONIC_LOOPNE:
+        return ZYAN_TRUE;
+    default:
+        return ZYAN_FALSE;
+    }
+}
+
+/**
+ * Calculates the absolute target of the relative operand of the given instruction and redirects
+ * it to the relocated code, if it points into the source code block.
+ *
+ * @param   instruction         A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands            A pointer to the visible operands of the instruction.
+ * @param   runtime_address     The original runtime address of the instruction.
+ * @param   source_address      The runtime address of the source code block.
+ * @param   source_length       The length of the source code block.
+ * @param   destination_address The runtime address of the relocated code.
+ * @param   map                 A pointer to the relocation map.
+ * @param   count               The number of entries in the relocation map.
+ * @param   target              Receives the new absolute target address.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZydisRelocateTarget(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZyanU64 runtime_address, ZyanU64 source_address,
+    ZyanUSize source_length, ZyanU64 destination_address, const ZydisRelocationMapEntry* map,
+    ZyanUSize count, ZyanU64* target)
+{
+    const ZydisDecodedOperand* operand = ZYAN_NULL;
+    for (ZyanU8 i = 0; i < instruction->operand_count_visible; ++i)
+    {
+        if (((operands[i].type == ZYDIS_OPERAND_TYPE_IMMEDIATE) &&
+             (operands[i].imm.is_relative)) ||
+            ((operands[i].type == ZYDIS_OPERAND_TYPE_MEMORY) &&
+             ((operands[i].mem.base == ZYDIS_REGISTER_EIP) ||
+              (operands[i].mem.base == ZYDIS_REGISTER_RIP))))
+        {
+            operand = &operands[i];
+            break;
+        }
+    }
+    if (!operand)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_CHECK(ZydisCalcAbsoluteAddress(instruction, operand, runtime_address, target));
+    if ((*target < source_address) || (*target - source_address >= source_length))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanU64 offset = *target - source_address;
+    ZyanUSize lo = 0;
+    ZyanUSize hi = count;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        if (map[mid].source_offset < offset)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+    if ((lo < count) && (map[lo].source_offset == offset))
+    {
+        *target = destination_address + map[lo].destination_offset;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    // Memory references into the middle of an instruction keep pointing to the original code,
+    // but there is no meaningful way to redirect such a branch
+    return (operand->type == ZYDIS_OPERAND_TYPE_MEMORY)
+        ? ZYAN_STATUS_SUCCESS
+        : ZYAN_STATUS_INVALID_OPERATION;
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisRelocateCode(const ZydisDecoder* decoder, const void* source,
+    ZyanUSize source_length, ZyanU64 source_address, ZyanU64 destination_address, void* buffer,
+    ZyanUSize* length, ZydisRelocationMapEntry* map, ZyanUSize* map_length,
+    ZydisRelocationInstruction* instructions, ZyanUSize* instruction_count)
+{
+    if (!decoder || !source || !buffer || !length || !map_length || (*map_length && !map) ||
+        !instruction_count || (*instruction_count && !instructions) ||
+        (source_length > ZYAN_UINT32_MAX))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyanU8* input = (const ZyanU8*)source;
+    ZyanU8* output = (ZyanU8*)buffer;
+
+    // Collect the instruction boundaries first, so that branches can be redirected to
+    // instructions that have not been relocated yet. Instructions with relative operands are kept
+    // for re-encoding, everything else is copied from the source code block
+    ZyanUSize count = 0;
+    ZyanUSize relative_count = 0;
+    ZydisDecoderContext context;
+    ZydisDecodedInstruction instruction;
+    for (ZyanUSize offset = 0; offset < source_length; offset += instruction.length)
+    {
+        ZYAN_CHECK(ZydisDecoderDecodeInstruction(decoder, &context, input + offset,
+            source_length - offset, &instruction));
+        if (count < *map_length)
+        {
+            map[count].source_offset = (ZyanU32)offset;
+            map[count].destination_offset = (ZyanU32)offset;
+        }
+        if (instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
+        {
+            if (relative_count < *instruction_count)
+            {
+                ZydisRelocationInstruction* entry = &instructions[relative_count];
+                entry->index = (ZyanU32)count;
+                entry->context = context;
+                entry->instruction = instruction;
+                ZYAN_CHECK(ZydisDecoderDecodeOperands(decoder, &entry->context,
+                    &entry->instruction, entry->operands, instruction.operand_count_visible));
+            }
+            ++relative_count;
+        }
+        ++count;
+    }
+    const ZyanUSize capacity = *map_length;
+    const ZyanUSize relative_capacity = *instruction_count;
+    *map_length = count;
+    *instruction_count = relative_count;
+    if ((count > capacity) || (relative_count > relative_capacity))
+    {
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+
+    // Every pass emits the complete output. Instructions only ever grow their slot, so the layout
+    // is guaranteed to be stable after a finite number of passes. The last pass did not move any
+    // instruction, which means that all emitted targets are final
+    ZyanUSize total = source_length;
+    ZyanBool grown;
+    do
+    {
+        grown = ZYAN_FALSE;
+        ZyanUSize shift = 0;
+        ZyanUSize relative_index = 0;
+        for (ZyanUSize i = 0; i < count; ++i)
+        {
+            const ZyanUSize source_offset = map[i].source_offset;
+            const ZyanUSize slot_end = (i + 1 < count) ? map[i + 1].destination_offset : total;
+            const ZyanUSize slot_size = slot_end - map[i].destination_offset;
+            const ZyanUSize offset = map[i].destination_offset + shift;
+            if (offset > ZYAN_UINT32_MAX)
+            {
+                return ZYAN_STATUS_OUT_OF_RANGE;
+            }
+            map[i].destination_offset = (ZyanU32)offset;
+
+            const ZyanU8* data = input + source_offset;
+            ZyanUSize data_length =
+                ((i + 1 < count) ? map[i + 1].source_offset : source_length) - source_offset;
+            ZyanU8 encoded[ZYDIS_MAX_INSTRUCTION_LENGTH];
+            if ((relative_index < relative_count) && (instructions[relative_index].index == i))
+            {
+                const ZydisRelocationInstruction* entry = &instructions[relative_index++];
+
+                ZydisEncoderPatch patch;
+                ZYAN_MEMSET(&patch, 0, sizeof(patch));
+                patch.flags = ZYDIS_ENCODER_PATCH_RELATIVE_TARGET;
+                patch.runtime_address = destination_address + offset;
+                ZYAN_CHECK(ZydisRelocateTarget(&entry->instruction, entry->operands,
+                    source_address + source_offset, source_address, source_length,
+                    destination_address, map, count, &patch.target));
+
+                // `LOOP`, `JRCXZ`, etc. can't be promoted once the target is out of `rel8` range
+                if (ZydisRelocateIsShortOnly(&entry->instruction))
+                {
+                    const ZyanI64 rel = (ZyanI64)(patch.target -
+                        (patch.runtime_address + entry->instruction.length));
+                    if ((rel < ZYAN_INT8_MIN) || (rel > ZYAN_INT8_MAX))
+                    {
+                        return ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION;
+                    }
+                }
+
+                data_length = sizeof(encoded);
+                ZYAN_CHECK(ZydisEncoderReEncodeInstruction(&entry->instruction, &entry->context,
+                    &patch, encoded, &data_length));
+                data = encoded;
+            }
+
+            ZyanUSize size = slot_size;
+            if (data_length > slot_size)
+            {
+                shift += data_length - slot_size;
+                size = data_length;
+                grown = ZYAN_TRUE;
+            }
+            if (offset + size > *length)
+            {
+                return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+            }
+            ZYAN_MEMCPY(output + offset, data, data_length);
+            ZYAN_CHECK(ZydisEncoderNopFill(output + offset + data_length, size - data_length));
+        }
+        total += shift;
+    } while (grown);
+
+    *length = total;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
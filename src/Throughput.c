@@ -0,0 +1,408 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/LibC.h>
+#include <Zydis/RegisterUsage.h>
+#include <Zydis/Throughput.h>
+
+/* ============================================================================================== */
+/* Internal constants                                                                             */
+/* ============================================================================================== */
+
+/**
+ * The number of simulated loop iterations. The steady-state values are derived from the second
+ * half of the iterations.
+ */
+#define ZYDIS_THROUGHPUT_ITERATIONS 8
+
+/**
+ * The number of fused-domain uops the front-end issues per cycle, indexed by
+ * `ZydisMicroarchitecture`.
+ */
+static const ZyanU8 ISSUE_WIDTH[ZYDIS_MICROARCH_MAX_VALUE + 1] =
+{
+    /* SKYLAKE */ 4,
+    /* ICELAKE */ 5,
+    /* ZEN4    */ 6
+};
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/**
+ * Checks if the given instruction is a zero idiom that does not depend on its inputs.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands    A pointer to the operands array.
+ *
+ * @return  `ZYAN_TRUE`, if the instruction is a zero idiom or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZydisThroughputIsZeroIdiom(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands)
+{
+    switch (instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_XOR:
+    case ZYDIS_MNEMONIC_SUB:
+    case ZYDIS_MNEMONIC_PXOR:
+    case ZYDIS_MNEMONIC_VPXOR:
+    case ZYDIS_MNEMONIC_VPXORD:
+    case ZYDIS_MNEMONIC_VPXORQ:
+    case ZYDIS_MNEMONIC_XORPS:
+    case ZYDIS_MNEMONIC_VXORPS:
+    case ZYDIS_MNEMONIC_XORPD:
+    case ZYDIS_MNEMONIC_VXORPD:
+    case ZYDIS_MNEMONIC_PSUBB:
+    case ZYDIS_MNEMONIC_PSUBD:
+    case ZYDIS_MNEMONIC_PSUBQ:
+    case ZYDIS_MNEMONIC_PSUBW:
+    case ZYDIS_MNEMONIC_VPSUBB:
+    case ZYDIS_MNEMONIC_VPSUBD:
+    case ZYDIS_MNEMONIC_VPSUBQ:
+    case ZYDIS_MNEMONIC_VPSUBW:
+        break;
+    default:
+        return ZYAN_FALSE;
+    }
+
+    // The source operands are always the last two visible operands
+    const ZyanU8 count = instruction->operand_count_visible;
+    if ((count < 2) || ((instruction->avx.mask.reg != ZYDIS_REGISTER_NONE) &&
+        (instruction->avx.mask.reg != ZYDIS_REGISTER_K0)))
+    {
+        return ZYAN_FALSE;
+    }
+    const ZydisDecodedOperand* const a = &operands[count - 2];
+    const ZydisDecodedOperand* const b = &operands[count - 1];
+
+    return (a->type == ZYDIS_OPERAND_TYPE_REGISTER) && (b->type == ZYDIS_OPERAND_TYPE_REGISTER) &&
+        (a->reg.value == b->reg.value);
+}
+
+/**
+ * Returns the time at which all registers in the given set are ready.
+ *
+ * @param   ready   A pointer to the ready-time array.
+ * @param   set     A pointer to the `ZydisRegisterSet` struct.
+ *
+ * @return  The maximum ready-time of all registers in the set.
+ */
+static ZyanU32 ZydisThroughputGetReadyTime(const ZyanU32* ready, const ZydisRegisterSet* set)
+{
+    ZyanU32 result = 0;
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        ZyanU64 word = set->bits[i];
+        for (ZyanUSize j = i * 64; word; ++j, word >>= 1)
+        {
+            if ((word & 1) && (ready[j] > result))
+            {
+                result = ready[j];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Sets the ready-time of all registers in the given set.
+ *
+ * @param   ready   A pointer to the ready-time array.
+ * @param   set     A pointer to the `ZydisRegisterSet` struct.
+ * @param   time    The new ready-time.
+ */
+static void ZydisThroughputSetReadyTime(ZyanU32* ready, const ZydisRegisterSet* set, ZyanU32 time)
+{
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+    {
+        ZyanU64 word = set->bits[i];
+        for (ZyanUSize j = i * 64; word; ++j, word >>= 1)
+        {
+            if (word & 1)
+            {
+                ready[j] = time;
+            }
+        }
+    }
+}
+
+/**
+ * Removes register writes that do not carry a dependency from the given register usage.
+ *
+ * @param   instruction A pointer to the `ZydisDecodedInstruction` struct.
+ * @param   operands    A pointer to the operands array.
+ * @param   usage       A pointer to the `ZydisRegisterUsage` struct.
+ *
+ * Every flag-writing instruction partially writes the flags register as a whole, which would
+ * chain all of them together. Flag dependencies are tracked through the individual flags instead.
+ * Legacy `SSE` instructions preserve the upper bits of the enclosing vector register, but register
+ * renaming does not make them depend on the previous value, so these writes are treated as full
+ * writes.
+ */
+static void ZydisThroughputAdjustUsage(const ZydisDecodedInstruction* instruction,
+    const ZydisDecodedOperand* operands, ZydisRegisterUsage* usage)
+{
+    const ZyanI16 flags_index = ZydisRegisterGetSetIndex(ZYDIS_REGISTER_RFLAGS);
+    const ZyanU64 flags_mask = ~((ZyanU64)1 << (flags_index % 64));
+    usage->read.bits[flags_index / 64] &= flags_mask;
+    usage->write.bits[flags_index / 64] &= flags_mask;
+    usage->cond_write.bits[flags_index / 64] &= flags_mask;
+
+    if ((instruction->encoding != ZYDIS_INSTRUCTION_ENCODING_LEGACY) &&
+        (instruction->encoding != ZYDIS_INSTRUCTION_ENCODING_REX2))
+    {
+        return;
+    }
+    for (ZyanU8 i = 0; i < instruction->operand_count; ++i)
+    {
+        const ZydisDecodedOperand* const operand = &operands[i];
+        if ((operand->type != ZYDIS_OPERAND_TYPE_REGISTER) ||
+            (ZydisRegisterGetClass(operand->reg.value) != ZYDIS_REGCLASS_XMM) ||
+            !(operand->actions & ZYDIS_OPERAND_ACTION_WRITE) ||
+            (operand->actions & ZYDIS_OPERAND_ACTION_CONDWRITE))
+        {
+            continue;
+        }
+        const ZyanI16 index = ZydisRegisterGetSetIndex(operand->reg.value);
+        const ZyanU64 bit = (ZyanU64)1 << (index % 64);
+        usage->cond_write.bits[index / 64] &= ~bit;
+        usage->write.bits[index / 64] |= bit;
+    }
+}
+
+/**
+ * Dispatches uops to the least loaded of the given ports.
+ *
+ * @param   port_load   A pointer to the port-load array.
+ * @param   ports       The eligible ports.
+ * @param   count       The number of uops.
+ */
+static void ZydisThroughputDispatch(ZyanU32* port_load, ZyanU16 ports, ZyanU32 count)
+{
+    if (!ports)
+    {
+        return;
+    }
+
+    for (ZyanU32 i = 0; i < count; ++i)
+    {
+        ZyanU8 best = ZYDIS_PERF_MAX_PORTS;
+        for (ZyanU8 port = 0; port < ZYDIS_PERF_MAX_PORTS; ++port)
+        {
+            if ((ports & (1 << port)) &&
+                ((best == ZYDIS_PERF_MAX_PORTS) || (port_load[port] < port_load[best])))
+            {
+                best = port;
+            }
+        }
+        ++port_load[best];
+    }
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+ZyanStatus ZydisEstimateThroughput(const ZydisDecoder* decoder, const void* buffer,
+    ZyanUSize length, ZydisMicroarchitecture uarch, ZydisThroughputEstimate* estimate)
+{
+    if (!decoder || (!buffer && length) || ((ZyanUSize)uarch > ZYDIS_MICROARCH_MAX_VALUE) ||
+        !estimate)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_MEMSET(estimate, 0, sizeof(*estimate));
+
+    const ZyanU8* const data = (const ZyanU8*)buffer;
+    const ZyanI16 rsp_index = ZydisRegisterGetSetIndex(ZYDIS_REGISTER_RSP);
+
+    ZyanU32 ready[ZYDIS_REGISTER_SET_BITS];
+    ZyanU32 ready_half[ZYDIS_REGISTER_SET_BITS];
+    ZyanU32 port_load[ZYDIS_PERF_MAX_PORTS];
+    ZYAN_MEMSET(ready, 0, sizeof(ready));
+    ZYAN_MEMSET(ready_half, 0, sizeof(ready_half));
+    ZYAN_MEMSET(port_load, 0, sizeof(port_load));
+
+    ZyanBool ends_with_branch = ZYAN_FALSE;
+    for (ZyanU8 iteration = 0; iteration < ZYDIS_THROUGHPUT_ITERATIONS; ++iteration)
+    {
+        ZydisDecodedInstruction instructions[2];
+        ZyanU8 current = 0;
+        ZyanBool has_previous = ZYAN_FALSE;
+
+        for (ZyanUSize offset = 0; offset < length; current ^= 1)
+        {
+            ZydisDecodedInstruction* const instruction = &instructions[current];
+            ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+            ZYAN_CHECK(ZydisDecoderDecodeFull(decoder, data + offset, length - offset,
+                instruction, operands));
+            offset += instruction->length;
+
+            ZydisInstructionPerfInfo info;
+            ZYAN_CHECK(ZydisGetInstructionPerfInfo(instruction, uarch, &info));
+
+            // A macro-fused branch is issued and executed as part of the preceding instruction
+            const ZyanBool is_fused = has_previous &&
+                ZydisIsMacroFusedPair(&instructions[current ^ 1], instruction, uarch);
+            has_previous = ZYAN_TRUE;
+
+            if (iteration == 0)
+            {
+                ++estimate->instruction_count;
+                if (is_fused)
+                {
+                    ++estimate->fused_pair_count;
+                } else
+                {
+                    estimate->uop_count += info.uops;
+                }
+                ends_with_branch = (offset >= length) &&
+                    ((instruction->meta.category == ZYDIS_CATEGORY_COND_BR) ||
+                     (instruction->meta.category == ZYDIS_CATEGORY_UNCOND_BR));
+            }
+
+            ZyanU32 load_count = 0;
+            ZyanU32 store_count = 0;
+            for (ZyanU8 i = 0; i < instruction->operand_count; ++i)
+            {
+                if ((operands[i].type != ZYDIS_OPERAND_TYPE_MEMORY) ||
+                    (operands[i].mem.type == ZYDIS_MEMOP_TYPE_AGEN) ||
+                    (operands[i].mem.type == ZYDIS_MEMOP_TYPE_MIB))
+                {
+                    continue;
+                }
+                if (operands[i].actions & ZYDIS_OPERAND_ACTION_MASK_READ)
+                {
+                    ++load_count;
+                }
+                if (operands[i].actions & ZYDIS_OPERAND_ACTION_MASK_WRITE)
+                {
+                    ++store_count;
+                }
+            }
+            if (!load_count && info.is_stack_load)
+            {
+                load_count = 1;
+            }
+            if (!store_count && info.is_stack_store)
+            {
+                store_count = 1;
+            }
+
+            const ZyanBool is_zero_idiom = ZydisThroughputIsZeroIdiom(instruction, operands);
+
+            // Ports
+            if (!is_fused && !is_zero_idiom)
+            {
+                ZydisThroughputDispatch(port_load, info.ports, info.port_uops);
+            }
+            ZydisThroughputDispatch(port_load, info.load_ports, load_count);
+            ZydisThroughputDispatch(port_load, info.store_ports, store_count);
+
+            // Dependencies
+            ZydisRegisterUsage usage;
+            ZYAN_CHECK(ZydisGetRegisterUsage(instruction, operands, instruction->operand_count,
+                &usage));
+            ZydisThroughputAdjustUsage(instruction, operands, &usage);
+
+            ZydisRegisterSet outputs;
+            for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_WORDS; ++i)
+            {
+                outputs.bits[i] = usage.write.bits[i] | usage.cond_write.bits[i];
+                usage.read.bits[i] |= usage.cond_write.bits[i];
+            }
+            if ((info.is_stack_load || info.is_stack_store) && (rsp_index >= 0))
+            {
+                // The stack engine tracks implicit stack pointer updates in the front-end
+                const ZyanU64 rsp_mask = ~((ZyanU64)1 << (rsp_index % 64));
+                usage.read.bits[rsp_index / 64] &= rsp_mask;
+                outputs.bits[rsp_index / 64] &= rsp_mask;
+            }
+
+            ZyanU32 time = 0;
+            if (!is_zero_idiom)
+            {
+                time = ZydisThroughputGetReadyTime(ready, &usage.read) + info.latency;
+                if (load_count)
+                {
+                    time += info.load_latency;
+                }
+            }
+            ZydisThroughputSetReadyTime(ready, &outputs, time);
+        }
+
+        if (iteration == ZYDIS_THROUGHPUT_ITERATIONS / 2 - 1)
+        {
+            ZYAN_MEMCPY(ready_half, ready, sizeof(ready));
+        }
+    }
+
+    // Front-end bound
+    const ZyanU8 width = ISSUE_WIDTH[uarch];
+    estimate->frontend_cycles =
+        (estimate->uop_count * ZYDIS_THROUGHPUT_SCALE + width - 1) / width;
+    if (ends_with_branch && (estimate->frontend_cycles < ZYDIS_THROUGHPUT_SCALE))
+    {
+        // At most one taken branch per cycle
+        estimate->frontend_cycles = ZYDIS_THROUGHPUT_SCALE;
+    }
+
+    // Port bound
+    for (ZyanU8 port = 0; port < ZYDIS_PERF_MAX_PORTS; ++port)
+    {
+        estimate->port_pressure[port] =
+            port_load[port] * ZYDIS_THROUGHPUT_SCALE / ZYDIS_THROUGHPUT_ITERATIONS;
+        estimate->port_cycles = ZYAN_MAX(estimate->port_cycles, estimate->port_pressure[port]);
+    }
+
+    // Dependency bound: growth of the loop-carried chains during the second half
+    ZyanU32 growth = 0;
+    for (ZyanUSize i = 0; i < ZYDIS_REGISTER_SET_BITS; ++i)
+    {
+        growth = ZYAN_MAX(growth, ready[i] - ready_half[i]);
+    }
+    estimate->dependency_cycles =
+        growth * ZYDIS_THROUGHPUT_SCALE / (ZYDIS_THROUGHPUT_ITERATIONS / 2);
+
+    estimate->cycles = estimate->frontend_cycles;
+    estimate->bottleneck = ZYDIS_THROUGHPUT_BOTTLENECK_FRONTEND;
+    if (estimate->port_cycles > estimate->cycles)
+    {
+        estimate->cycles = estimate->port_cycles;
+        estimate->bottleneck = ZYDIS_THROUGHPUT_BOTTLENECK_PORTS;
+    }
+    if (estimate->dependency_cycles > estimate->cycles)
+    {
+        estimate->cycles = estimate->dependency_cycles;
+        estimate->bottleneck = ZYDIS_THROUGHPUT_BOTTLENECK_DEPENDENCIES;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
@@ -136,8 +136,6 @@ ZyanStatus ZydisCalcAbsoluteAddressEx(const ZydisDecodedInstruction* instruction
     const ZydisDecodedOperand* operand, ZyanU64 runtime_address,
     const ZydisRegisterContext* register_context, ZyanU64* result_address)
 {
-    // TODO: Add support for Gather/Scatter instructions
-
     if (!instruction || !operand || !register_context || !result_address)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
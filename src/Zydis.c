@@ -78,6 +78,13 @@ ZyanStatus ZydisIsFeatureEnabled(ZydisFeature feature)
         return ZYAN_STATUS_FALSE;
 #endif
 
+    case ZYDIS_FEATURE_LEGACY_MODES:
+#ifndef ZYDIS_DISABLE_LEGACY_MODES
+        return ZYAN_STATUS_TRUE;
+#else
+        return ZYAN_STATUS_FALSE;
+#endif
+
     default:
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
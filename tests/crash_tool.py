@@ -141,6 +141,8 @@ def convert_enc_crash_to_json(crash, expected_result=0, return_dict=False):
     mvex_sae = bool(reader.read_uint8())
     mvex_eviction_hint = bool(reader.read_uint8())
     reader.read_bytes(2)
+    search_mode = get_sanitized_enum(reader, ZydisEncoderSearchMode)
+    reader.read_bytes(4)
     test_case = {
         'expected_result': expected_result,
         'machine_mode': machine_mode.name,
@@ -169,6 +171,8 @@ def convert_enc_crash_to_json(crash, expected_result=0, return_dict=False):
             'eviction_hint': mvex_eviction_hint,
         },
     }
+    if search_mode != ZydisEncoderSearchMode.ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH:
+        test_case['search_mode'] = search_mode.name
     if return_dict:
         return test_case
     return to_json(test_case)
@@ -259,6 +263,9 @@ def convert_enc_json_to_crash(test_case_json, from_dict=False):
     writer.write_uint8(int(test_case['mvex']['sae']))
     writer.write_uint8(int(test_case['mvex']['eviction_hint']))
     writer.write_padding(2)
+    writer.write_uint32(ZydisEncoderSearchMode[test_case.get('search_mode',
+                                                             'ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH')])
+    writer.write_padding(4)
     return writer.get_data()
 
 
@@ -5,16 +5,20 @@ from subprocess import Popen, PIPE
 
 def run_test(binary, payload=None):
     proc = Popen(binary, stdin=PIPE, stdout=PIPE, stderr=PIPE)
-    proc.communicate(input=payload)
-    return proc.returncode
+    stdout, _ = proc.communicate(input=payload)
+    return proc.returncode, stdout
 
 
-def run_test_collection(test_db_file, binary, converter):
+def run_test_collection(test_db_file, binary, converter, lengths=None):
     with open(test_db_file, 'r') as f:
         cases = json.loads(f.read())
     tests_passed = True
     for i, case in enumerate(cases):
-        rc = run_test(binary, converter(case, True))
+        rc, stdout = run_test(binary, converter(case, True))
+        if lengths is not None:
+            match = re.search(rb'^Encoded length: (\d+) (\d+)$', stdout, re.MULTILINE)
+            if match:
+                lengths.append((int(match.group(1)), int(match.group(2))))
         expected_rc = case.get('expected_result', 0)
         test_result = rc == expected_rc
         tests_passed &= test_result
@@ -41,10 +45,15 @@ if __name__ == "__main__":
     all_passed = run_test_collection('re_enc_test_cases.json', args.zydis_fuzz_re_enc_path, convert_re_enc_json_to_crash)
     print()
     print('Running encoding tests:')
-    all_passed &= run_test_collection('enc_test_cases.json', args.zydis_fuzz_enc_path, convert_enc_json_to_crash)
+    lengths = []
+    all_passed &= run_test_collection('enc_test_cases.json', args.zydis_fuzz_enc_path, convert_enc_json_to_crash, lengths)
+    first_match_total = sum(first_match for first_match, _ in lengths)
+    shortest_total = sum(shortest for _, shortest in lengths)
+    print('Size-optimal search: %d instructions, %d -> %d bytes (saved %d bytes)' % (
+        len(lengths), first_match_total, shortest_total, first_match_total - shortest_total))
     print()
     print('Running encoding tests (absolute address mode):')
-    result = run_test(args.zydis_test_tool_path) == 0
+    result = run_test(args.zydis_test_tool_path)[0] == 0
     all_passed &= result
     print('Success' if result else 'FAILED')
     print()
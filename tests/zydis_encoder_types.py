@@ -204,6 +204,13 @@ ZydisSwizzleMode = IntEnum('ZydisSwizzleMode', [
 ], start=0)
 
 
+ZydisEncoderSearchMode = IntEnum('ZydisEncoderSearchMode', [
+    'ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH',
+    'ZYDIS_ENCODER_SEARCH_MODE_SHORTEST',
+    'ZYDIS_ENCODER_SEARCH_MODE_FEWEST_PREFIXES',
+], start=0)
+
+
 ZydisOperandType = IntEnum('ZydisOperandType', [
     'ZYDIS_OPERAND_TYPE_UNUSED',
     'ZYDIS_OPERAND_TYPE_REGISTER',
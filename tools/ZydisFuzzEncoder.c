@@ -203,6 +203,8 @@ int ZydisFuzzTarget(ZydisStreamRead read_fn, void *stream_ctx)
         ZYDIS_CONVERSION_MODE_MAX_VALUE);
     ZYDIS_SANITIZE_ENUM(request.mvex.rounding, ZydisRoundingMode, ZYDIS_ROUNDING_MODE_MAX_VALUE);
     ZYDIS_SANITIZE_ENUM(request.mvex.swizzle, ZydisSwizzleMode, ZYDIS_SWIZZLE_MODE_MAX_VALUE);
+    ZYDIS_SANITIZE_ENUM(request.search_mode, ZydisEncoderSearchMode,
+        ZYDIS_ENCODER_SEARCH_MODE_MAX_VALUE);
     for (ZyanU8 i = 0; i < request.operand_count; ++i)
     {
         ZydisEncoderOperand *op = &request.operands[i];
@@ -332,6 +334,43 @@ int ZydisFuzzTarget(ZydisStreamRead read_fn, void *stream_ctx)
     ZydisReEncodeInstruction(&decoder, &insn1, operands1, insn1.operand_count, 
         encoded_instruction);
 
+    // Size-optimal search must never produce a longer encoding than the default search
+    if (request.search_mode == ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH)
+    {
+        ZydisEncoderRequest shortest_request = request;
+        shortest_request.search_mode = ZYDIS_ENCODER_SEARCH_MODE_SHORTEST;
+        ZyanU8 shortest_instruction[ZYDIS_MAX_INSTRUCTION_LENGTH];
+        ZyanUSize shortest_length = sizeof(shortest_instruction);
+        status = ZydisEncoderEncodeInstruction(&shortest_request, shortest_instruction,
+            &shortest_length);
+        if (!ZYAN_SUCCESS(status))
+        {
+            fputs("Failed to encode size-optimal form\n", ZYAN_STDERR);
+            abort();
+        }
+        if (shortest_length > encoded_length)
+        {
+            fputs("Size-optimal form is longer than the default form\n", ZYAN_STDERR);
+            abort();
+        }
+
+        ZydisDecodedInstruction insn2;
+        ZydisDecodedOperand operands2[ZYDIS_MAX_OPERAND_COUNT];
+        status = ZydisDecoderDecodeFull(&decoder, shortest_instruction, shortest_length, &insn2,
+            operands2);
+        if (!ZYAN_SUCCESS(status))
+        {
+            fputs("Failed to decode size-optimal form\n", ZYAN_STDERR);
+            abort();
+        }
+        ZydisCompareRequestToInstruction(&request, &insn2, operands2);
+
+#if !defined(ZYDIS_FUZZ_AFL_FAST) && !defined(ZYDIS_LIBFUZZER)
+        // Parsed by `regression_encoder.py`
+        printf("Encoded length: %u %u\n", (unsigned)encoded_length, (unsigned)shortest_length);
+#endif
+    }
+
     return EXIT_SUCCESS;
 }
 
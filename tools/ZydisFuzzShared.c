@@ -389,6 +389,102 @@ void ZydisValidateInstructionIdentity(const ZydisDecodedInstruction* insn1,
     }
 }
 
+static ZydisOperandMatch ZydisGetOperandMatch(const ZydisDecodedOperand* operand)
+{
+    switch (operand->type)
+    {
+    case ZYDIS_OPERAND_TYPE_REGISTER:
+        return ZYDIS_OPERAND_MATCH_REGISTER;
+    case ZYDIS_OPERAND_TYPE_MEMORY:
+        return ZYDIS_OPERAND_MATCH_MEMORY;
+    case ZYDIS_OPERAND_TYPE_POINTER:
+        return ZYDIS_OPERAND_MATCH_POINTER;
+    case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+        return operand->imm.is_relative ? ZYDIS_OPERAND_MATCH_RELATIVE :
+            ZYDIS_OPERAND_MATCH_IMMEDIATE;
+    default:
+        fputs("Invalid operand type\n", ZYAN_STDERR);
+        abort();
+    }
+}
+
+void ZydisValidateSingleOperandDecoding(const ZydisDecoder* decoder, const ZyanU8* buffer,
+    ZyanUSize length, const ZydisDecodedInstruction* insn, const ZydisDecodedOperand* operands)
+{
+    ZydisDecoderContext context;
+    ZydisDecodedInstruction instruction;
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(decoder, &context, buffer, length,
+        &instruction)) || (instruction.operand_count != insn->operand_count))
+    {
+        fputs("Failed to decode instruction for single operand decoding\n", ZYAN_STDERR);
+        abort();
+    }
+
+    ZydisDecodedOperand operand;
+    for (ZyanU8 i = 0; i < insn->operand_count; ++i)
+    {
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeOperand(decoder, &context, &instruction, i,
+            &operand)) || ZYAN_MEMCMP(&operand, &operands[i], sizeof(operand)))
+        {
+            fprintf(ZYAN_STDERR, "Mismatch for single decoded operand %u\n", i);
+            abort();
+        }
+    }
+    if (ZydisDecoderDecodeOperand(decoder, &context, &instruction, insn->operand_count,
+        &operand) != ZYAN_STATUS_INVALID_ARGUMENT)
+    {
+        fputs("Out of range operand index was accepted\n", ZYAN_STDERR);
+        abort();
+    }
+
+    static const ZydisOperandMatch matches[] =
+    {
+        ZYDIS_OPERAND_MATCH_REGISTER,
+        ZYDIS_OPERAND_MATCH_MEMORY,
+        ZYDIS_OPERAND_MATCH_POINTER,
+        ZYDIS_OPERAND_MATCH_IMMEDIATE,
+        ZYDIS_OPERAND_MATCH_RELATIVE,
+        ZYDIS_OPERAND_MATCH_IMMEDIATE | ZYDIS_OPERAND_MATCH_RELATIVE,
+        ZYDIS_OPERAND_MATCH_ANY,
+    };
+    for (ZyanU8 i = 0; i < ZYAN_ARRAY_LENGTH(matches) * 2; ++i)
+    {
+        const ZydisOperandMatch match =
+            (ZydisOperandMatch)(matches[i / 2] | ((i & 1) ? ZYDIS_OPERAND_MATCH_EXPLICIT : 0));
+
+        // Expected result: the first matching element of `ZydisDecoderDecodeOperands`
+        ZyanU8 expected = insn->operand_count;
+        for (ZyanU8 j = 0; j < insn->operand_count; ++j)
+        {
+            if ((ZydisGetOperandMatch(&operands[j]) & match) &&
+                (!(match & ZYDIS_OPERAND_MATCH_EXPLICIT) ||
+                 (operands[j].visibility == ZYDIS_OPERAND_VISIBILITY_EXPLICIT)))
+            {
+                expected = j;
+                break;
+            }
+        }
+
+        const ZyanStatus status =
+            ZydisDecoderFindOperand(decoder, &context, &instruction, match, &operand);
+        if (expected == insn->operand_count)
+        {
+            if (status != ZYAN_STATUS_NOT_FOUND)
+            {
+                fprintf(ZYAN_STDERR, "Unexpected operand found for match %02X\n", match);
+                abort();
+            }
+            continue;
+        }
+        if (!ZYAN_SUCCESS(status) || ZYAN_MEMCMP(&operand, &operands[expected], sizeof(operand)))
+        {
+            fprintf(ZYAN_STDERR, "Mismatch for found operand %u (match %02X)\n", expected,
+                match);
+            abort();
+        }
+    }
+}
+
 #if !defined(ZYDIS_DISABLE_ENCODER)
 
 static void ZydisReEncodeInstructionAbsolute(ZydisEncoderRequest* req,
@@ -512,6 +608,8 @@ void ZydisReEncodeInstruction(const ZydisDecoder *decoder, const ZydisDecodedIns
     ZydisPrintInstruction(&insn2, operands2, insn2.operand_count_visible, encoded_instruction);
     ZydisValidateEnumRanges(&insn2, operands2, insn2.operand_count_visible);
     ZydisValidateInstructionIdentity(insn1, operands1, &insn2, operands2);
+    ZydisValidateSingleOperandDecoding(decoder, encoded_instruction, encoded_length, &insn2,
+        operands2);
 
     if (insn2.length > insn1->length)
     {
@@ -82,6 +82,8 @@ void ZydisValidateEnumRanges(const ZydisDecodedInstruction* insn,
 void ZydisValidateInstructionIdentity(const ZydisDecodedInstruction* insn1, 
     const ZydisDecodedOperand* operands1, const ZydisDecodedInstruction* insn2, 
     const ZydisDecodedOperand* operands2);
+void ZydisValidateSingleOperandDecoding(const ZydisDecoder* decoder, const ZyanU8* buffer,
+    ZyanUSize length, const ZydisDecodedInstruction* insn, const ZydisDecodedOperand* operands);
 void ZydisReEncodeInstruction(const ZydisDecoder* decoder, const ZydisDecodedInstruction* insn1,
     const ZydisDecodedOperand* operands1, ZyanU8 operand_count, const ZyanU8 *insn1_bytes);
 
@@ -352,6 +352,7 @@ static void PrintSizeOptimizedForm(const ZydisDecoder* decoder,
         PrintStatusError(status, "Failed to craft encoder request");
         exit(status);
     }
+    request.search_mode = ZYDIS_ENCODER_SEARCH_MODE_SHORTEST;
 
     ZyanU8 data[ZYDIS_MAX_INSTRUCTION_LENGTH];
     ZyanUSize len = sizeof(data);
@@ -0,0 +1,475 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * Reads a binary file and prints the ISA sets, ISA extensions and encodings used by the
+ * contained instructions.
+ */
+
+#include "ZydisToolsShared.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Zycore/API/Terminal.h>
+#include <Zycore/LibC.h>
+#include <Zydis/Zydis.h>
+
+#ifdef ZYAN_WINDOWS
+#   include <fcntl.h>
+#   include <io.h>
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+/* ============================================================================================== */
+/* Configuration                                                                                  */
+/* ============================================================================================== */
+
+#define MAX_THREADS         64
+#define MAX_FORBIDDEN       16
+#define MIN_CHUNK_SIZE      (1024 * 1024)
+
+#define COLOR_HEADER        ZYAN_VT100SGR_FG_BRIGHT_WHITE
+#define COLOR_FORBIDDEN     ZYAN_VT100SGR_FG_BRIGHT_RED
+
+/* ============================================================================================== */
+/* Types                                                                                          */
+/* ============================================================================================== */
+
+/**
+ * Defines the `ScanThreadContext` struct.
+ */
+typedef struct ScanThreadContext_
+{
+    const ZydisDecoder* decoder;
+    const ZyanU8* buffer;
+    ZyanUSize length;
+    ZyanU64 runtime_address;
+    ZydisIsaScanChunk* chunk;
+    ZyanUSize start;
+    ZyanUSize end;
+} ScanThreadContext;
+
+/* ============================================================================================== */
+/* Helper functions                                                                               */
+/* ============================================================================================== */
+
+/**
+ * Returns the number of online processors.
+ *
+ * @return  The number of online processors.
+ */
+static ZyanUSize GetProcessorCount(void)
+{
+#ifdef ZYAN_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (ZyanUSize)count : 1;
+#endif
+}
+
+/**
+ * Reads the complete file into memory.
+ *
+ * @param   file    The file.
+ * @param   length  Receives the length of the data.
+ *
+ * @return  A pointer to the data or `ZYAN_NULL`, if an error occurred.
+ */
+static ZyanU8* ReadInput(FILE* file, ZyanUSize* length)
+{
+    ZyanUSize capacity = 1024 * 1024;
+    ZyanU8* buffer = malloc(capacity);
+    *length = 0;
+    while (buffer)
+    {
+        *length += fread(buffer + *length, 1, capacity - *length, file);
+        if (*length < capacity)
+        {
+            if (ferror(file))
+            {
+                break;
+            }
+            return buffer;
+        }
+
+        capacity *= 2;
+        ZyanU8* const grown = realloc(buffer, capacity);
+        if (!grown)
+        {
+            break;
+        }
+        buffer = grown;
+    }
+
+    free(buffer);
+    return ZYAN_NULL;
+}
+
+/**
+ * Checks if the given name starts with any of the forbidden prefixes.
+ *
+ * @param   name            The name.
+ * @param   forbidden       The forbidden prefixes.
+ * @param   forbidden_count The number of forbidden prefixes.
+ *
+ * @return  `ZYAN_TRUE`, if the name is forbidden or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool IsForbidden(const char* name, char** forbidden, ZyanUSize forbidden_count)
+{
+    for (ZyanUSize i = 0; i < forbidden_count; ++i)
+    {
+        if (!ZYAN_STRNCMP(name, forbidden[i], ZYAN_STRLEN(forbidden[i])))
+        {
+            return ZYAN_TRUE;
+        }
+    }
+    return ZYAN_FALSE;
+}
+
+/* ============================================================================================== */
+/* Scan functions                                                                                 */
+/* ============================================================================================== */
+
+#ifdef ZYAN_WINDOWS
+static DWORD WINAPI ScanThread(LPVOID parameter)
+#else
+static void* ScanThread(void* parameter)
+#endif
+{
+    const ScanThreadContext* const context = (const ScanThreadContext*)parameter;
+    ZydisIsaScanLinearChunk(context->decoder, context->buffer, context->length,
+        context->runtime_address, context->start, context->end, context->chunk);
+#ifdef ZYAN_WINDOWS
+    return 0;
+#else
+    return ZYAN_NULL;
+#endif
+}
+
+/**
+ * Scans the given code using multiple threads.
+ *
+ * @param   decoder         A pointer to the `ZydisDecoder` instance.
+ * @param   buffer          A pointer to the code.
+ * @param   length          The length of the code.
+ * @param   runtime_address The runtime address of the first byte of the code.
+ * @param   thread_count    The number of threads.
+ * @param   report          A pointer to the `ZydisIsaScanReport` struct receiving the result.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus Scan(const ZydisDecoder* decoder, const ZyanU8* buffer, ZyanUSize length,
+    ZyanU64 runtime_address, ZyanUSize thread_count, ZydisIsaScanReport* report)
+{
+    thread_count = ZYAN_MIN(thread_count, (length + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE);
+    if (thread_count <= 1)
+    {
+        ZYAN_CHECK(ZydisIsaScanReportInit(report));
+        return ZydisIsaScanLinear(decoder, buffer, length, runtime_address, report);
+    }
+
+    ZydisIsaScanChunk* const chunks = malloc(thread_count * sizeof(ZydisIsaScanChunk));
+    if (!chunks)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    ScanThreadContext contexts[MAX_THREADS];
+#ifdef ZYAN_WINDOWS
+    HANDLE threads[MAX_THREADS];
+#else
+    pthread_t threads[MAX_THREADS];
+#endif
+    const ZyanUSize chunk_size = length / thread_count;
+    for (ZyanUSize i = 0; i < thread_count; ++i)
+    {
+        contexts[i].decoder = decoder;
+        contexts[i].buffer = buffer;
+        contexts[i].length = length;
+        contexts[i].runtime_address = runtime_address;
+        contexts[i].chunk = &chunks[i];
+        contexts[i].start = i * chunk_size;
+        contexts[i].end = (i == thread_count - 1) ? length : (i + 1) * chunk_size;
+#ifdef ZYAN_WINDOWS
+        threads[i] = CreateThread(ZYAN_NULL, 0, &ScanThread, &contexts[i], 0, ZYAN_NULL);
+        if (!threads[i])
+#else
+        if (pthread_create(&threads[i], ZYAN_NULL, &ScanThread, &contexts[i]))
+#endif
+        {
+            // Scan the remaining chunks on the current thread
+            ScanThread(&contexts[i]);
+#ifdef ZYAN_WINDOWS
+            threads[i] = ZYAN_NULL;
+#else
+            threads[i] = pthread_self();
+#endif
+        }
+    }
+    for (ZyanUSize i = 0; i < thread_count; ++i)
+    {
+#ifdef ZYAN_WINDOWS
+        if (threads[i])
+        {
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        }
+#else
+        if (!pthread_equal(threads[i], pthread_self()))
+        {
+            pthread_join(threads[i], ZYAN_NULL);
+        }
+#endif
+    }
+
+    const ZyanStatus status = ZydisIsaScanMergeChunks(decoder, buffer, length, runtime_address,
+        chunks, thread_count, report);
+    free(chunks);
+
+    return status;
+}
+
+/* ============================================================================================== */
+/* Print functions                                                                                */
+/* ============================================================================================== */
+
+/**
+ * Prints a histogram.
+ *
+ * @param   title           The title of the histogram.
+ * @param   entries         A pointer to the histogram entries.
+ * @param   count           The number of histogram entries.
+ * @param   get_name        A function returning the name of an entry.
+ * @param   forbidden       The forbidden prefixes.
+ * @param   forbidden_count The number of forbidden prefixes.
+ *
+ * @return  `ZYAN_TRUE`, if a forbidden entry was found or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool PrintHistogram(const char* title, const ZydisIsaScanEntry* entries,
+    ZyanUSize count, const char* (*get_name)(ZyanUSize), char** forbidden,
+    ZyanUSize forbidden_count)
+{
+    ZyanBool found_forbidden = ZYAN_FALSE;
+
+    ZYAN_ASSERT(ZYAN_STRLEN(title) <= 8);
+    ZYAN_PRINTF("%s== [ %8s ] ==============================================================%s\n",
+        CVT100_OUT(COLOR_HEADER), title, CVT100_OUT(ZYAN_VT100SGR_RESET));
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        if (!entries[i].count)
+        {
+            continue;
+        }
+
+        const char* const name = get_name(i);
+        const ZyanBool is_forbidden = IsForbidden(name, forbidden, forbidden_count);
+        found_forbidden |= is_forbidden;
+        ZYAN_PRINTF("%s%-24s %16" PRIu64 "  first at 0x%016" PRIX64 "%s\n",
+            is_forbidden ? CVT100_OUT(COLOR_FORBIDDEN) : "", name, entries[i].count,
+            entries[i].first_address,
+            is_forbidden ? CVT100_OUT(ZYAN_VT100SGR_RESET) : "");
+    }
+    ZYAN_PRINTF("\n");
+
+    return found_forbidden;
+}
+
+static const char* GetISASetName(ZyanUSize value)
+{
+    return ZydisISASetGetString((ZydisISASet)value);
+}
+
+static const char* GetISAExtName(ZyanUSize value)
+{
+    return ZydisISAExtGetString((ZydisISAExt)value);
+}
+
+static const char* GetEncodingName(ZyanUSize value)
+{
+    static const char* instr_encodings[] =
+    {
+        "DEFAULT",
+        "3DNOW",
+        "XOP",
+        "VEX",
+        "EVEX",
+        "MVEX",
+        "REX2"
+    };
+    ZYAN_STATIC_ASSERT(
+        ZYAN_ARRAY_LENGTH(instr_encodings) == ZYDIS_INSTRUCTION_ENCODING_MAX_VALUE + 1);
+
+    return instr_encodings[value];
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+void PrintUsage(int argc, char* argv[])
+{
+    ZYAN_FPRINTF(ZYAN_STDERR, "%sUsage: %s -[real|16|32|64] [-threads <count>] "
+        "[-forbid <prefix>]... [input file]%s\n",
+        CVT100_ERR(COLOR_ERROR), (argc > 0 ? argv[0] : "ZydisIsaScan"),
+        CVT100_ERR(ZYAN_VT100SGR_RESET));
+}
+
+int main(int argc, char** argv)
+{
+    InitVT100();
+
+    if (ZydisGetVersion() != ZYDIS_VERSION)
+    {
+        ZYAN_FPRINTF(ZYAN_STDERR, "%sInvalid zydis version%s\n",
+            CVT100_ERR(COLOR_ERROR), CVT100_ERR(ZYAN_VT100SGR_RESET));
+        return EXIT_FAILURE;
+    }
+
+    if (argc < 2)
+    {
+        PrintUsage(argc, argv);
+        return EXIT_FAILURE;
+    }
+
+    ZydisDecoder decoder;
+    if (!ZYAN_STRCMP(argv[1], "-real"))
+    {
+        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_REAL_16, ZYDIS_STACK_WIDTH_16);
+    }
+    else if (!ZYAN_STRCMP(argv[1], "-16"))
+    {
+        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_16, ZYDIS_STACK_WIDTH_16);
+    }
+    else if (!ZYAN_STRCMP(argv[1], "-32"))
+    {
+        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+    }
+    else if (!ZYAN_STRCMP(argv[1], "-64"))
+    {
+        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+    }
+    else
+    {
+        PrintUsage(argc, argv);
+        return EXIT_FAILURE;
+    }
+    // Only the instruction meta information is required
+    ZydisDecoderEnableMode(&decoder, ZYDIS_DECODER_MODE_MINIMAL, ZYAN_TRUE);
+
+    ZyanUSize thread_count = ZYAN_MIN(GetProcessorCount(), MAX_THREADS);
+    char* forbidden[MAX_FORBIDDEN];
+    ZyanUSize forbidden_count = 0;
+    const char* path = ZYAN_NULL;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!ZYAN_STRCMP(argv[i], "-threads") && (i + 1 < argc))
+        {
+            thread_count = (ZyanUSize)strtoul(argv[++i], ZYAN_NULL, 10);
+            if (!thread_count || (thread_count > MAX_THREADS))
+            {
+                PrintUsage(argc, argv);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!ZYAN_STRCMP(argv[i], "-forbid") && (i + 1 < argc) &&
+            (forbidden_count < MAX_FORBIDDEN))
+        {
+            forbidden[forbidden_count++] = argv[++i];
+        }
+        else if (!path && (argv[i][0] != '-'))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            PrintUsage(argc, argv);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE* file = path ? fopen(path, "rb") : ZYAN_STDIN;
+    if (!file)
+    {
+        ZYAN_FPRINTF(ZYAN_STDERR, "%sCan not open file '%s': %s%s\n",
+            CVT100_ERR(COLOR_ERROR), path, strerror(ZYAN_ERRNO),
+            CVT100_ERR(ZYAN_VT100SGR_RESET));
+        return EXIT_FAILURE;
+    }
+#ifdef ZYAN_WINDOWS
+    // The `stdin` pipe uses text-mode on Windows platforms by default. We need it to be opened in
+    // binary mode
+    if (file == ZYAN_STDIN)
+    {
+        (void)_setmode(_fileno(ZYAN_STDIN), _O_BINARY);
+    }
+#endif
+
+    ZyanUSize length;
+    ZyanU8* const buffer = ReadInput(file, &length);
+    if (file != ZYAN_STDIN)
+    {
+        fclose(file);
+    }
+    if (!buffer)
+    {
+        ZYAN_FPRINTF(ZYAN_STDERR, "%sFailed to read input%s\n",
+            CVT100_ERR(COLOR_ERROR), CVT100_ERR(ZYAN_VT100SGR_RESET));
+        return EXIT_FAILURE;
+    }
+
+    static ZydisIsaScanReport report;
+    const ZyanStatus status = Scan(&decoder, buffer, length, 0, thread_count, &report);
+    free(buffer);
+    if (!ZYAN_SUCCESS(status))
+    {
+        PrintStatusError(status, "Failed to scan input");
+        return EXIT_FAILURE;
+    }
+
+    ZYAN_PRINTF("Instructions: %" PRIu64 "\nInvalid bytes: %" PRIu64 "\n\n",
+        report.instruction_count, report.invalid_count);
+
+    ZyanBool found_forbidden = ZYAN_FALSE;
+    found_forbidden |= PrintHistogram("ENCODING", report.encoding,
+        ZYAN_ARRAY_LENGTH(report.encoding), &GetEncodingName, forbidden, forbidden_count);
+    found_forbidden |= PrintHistogram("ISA-EXT", report.isa_ext,
+        ZYAN_ARRAY_LENGTH(report.isa_ext), &GetISAExtName, forbidden, forbidden_count);
+    found_forbidden |= PrintHistogram("ISA-SET", report.isa_set,
+        ZYAN_ARRAY_LENGTH(report.isa_set), &GetISASetName, forbidden, forbidden_count);
+
+    return found_forbidden ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ============================================================================================== */
@@ -0,0 +1,1417 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+/**
+ * @file
+ *
+ * Test set for the analysis functions (`ZydisDeadFlagsQuery`, `ZydisIsMacroFusedPair`, ...).
+ */
+
+#include <inttypes.h>
+#include <Zycore/LibC.h>
+#include <Zydis/Zydis.h>
+
+/* ============================================================================================== */
+/* Enums and Types                                                                                */
+/* ============================================================================================== */
+
+typedef struct DeadFlagsTest_
+{
+    const char* name;
+    ZyanU8 bytes[16];
+    ZyanUSize length;
+    ZydisAccessedFlagsMask dead;
+    ZydisAccessedFlagsMask live;
+} DeadFlagsTest;
+
+typedef struct MacroFusionTest_
+{
+    const char* name;
+    ZyanU8 bytes[16];
+    ZyanUSize length;
+    ZyanBool fused;
+} MacroFusionTest;
+
+typedef struct ReferencesTest_
+{
+    const char* name;
+    ZydisMachineMode machine_mode;
+    ZydisStackWidth stack_width;
+    ZyanU64 runtime_address;
+    ZyanU8 bytes[48];
+    ZyanUSize length;
+    ZyanU64 addresses[8];
+    ZyanUSize address_count;
+} ReferencesTest;
+
+typedef struct JumpTableTest_
+{
+    const char* name;
+    ZydisMachineMode machine_mode;
+    ZydisStackWidth stack_width;
+    ZyanU64 runtime_address;
+    ZyanU8 bytes[32];
+    ZyanUSize length;
+    ZyanUSize jump_offset;
+    ZyanStatus status;
+    ZydisJumpTable table;
+    ZyanU64 entries[8];
+    ZyanU64 targets[8];
+} JumpTableTest;
+
+typedef struct MemoryAccessTest_
+{
+    const char* name;
+    ZydisMachineMode machine_mode;
+    ZydisStackWidth stack_width;
+    ZyanU8 bytes[16];
+    ZyanUSize length;
+    ZyanU8 access_count;
+    ZydisMemoryAccessFlags flags[2];
+    ZyanU8 address_count;
+    ZydisMemoryAddress addresses[4];
+} MemoryAccessTest;
+
+typedef struct OperandLookupTest_
+{
+    const char* name;
+    ZydisMachineMode machine_mode;
+    ZydisStackWidth stack_width;
+    ZyanU8 bytes[16];
+    ZyanUSize length;
+    ZydisOperandMatch match;
+    ZyanStatus status;
+    ZyanU8 id;
+} OperandLookupTest;
+
+/* ============================================================================================== */
+/* Tests                                                                                          */
+/* ============================================================================================== */
+
+static ZyanBool RunDeadFlagsTests(void)
+{
+    static const DeadFlagsTest tests[] =
+    {
+        {
+            "add eax, eax; ret",
+            { 0x01, 0xC0, 0xC3 }, 3,
+            ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF | ZYDIS_CPUFLAG_OF, 0
+        },
+        {
+            "shl eax, 1; ret",
+            { 0xD1, 0xE0, 0xC3 }, 3,
+            ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF, 0
+        },
+        {
+            "shl eax, cl; jz",
+            { 0xD3, 0xE0, 0x74, 0x00 }, 4,
+            0, ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF | ZYDIS_CPUFLAG_SF
+        },
+        {
+            "shl eax, cl; ret",
+            { 0xD3, 0xE0, 0xC3 }, 3,
+            0, ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF | ZYDIS_CPUFLAG_OF
+        },
+        {
+            "shl eax, 0; ret",
+            { 0xC1, 0xE0, 0x00, 0xC3 }, 4,
+            0, ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF
+        },
+        {
+            "rcl byte ptr [rax], cl; ret",
+            { 0xD2, 0x10, 0xC3 }, 3,
+            0, ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_OF
+        },
+        {
+            "shld eax, ebx, cl; ret",
+            { 0x0F, 0xA5, 0xD8, 0xC3 }, 4,
+            0, ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_ZF
+        },
+        {
+            "shl eax, cl; sub eax, ebx; jz",
+            { 0xD3, 0xE0, 0x29, 0xD8, 0x74, 0x00 }, 6,
+            ZYDIS_CPUFLAG_CF | ZYDIS_CPUFLAG_OF, ZYDIS_CPUFLAG_ZF
+        },
+    };
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const DeadFlagsTest* test = &tests[i];
+
+        // Use a fresh analyzer, so every case is computed without cached results
+        static ZydisDeadFlagsAnalyzer analyzer;
+        ZydisAccessedFlagsMask dead = 0;
+        if (ZYAN_FAILED(ZydisDeadFlagsAnalyzerInit(&analyzer, &decoder, 16)) ||
+            ZYAN_FAILED(ZydisDeadFlagsQuery(&analyzer, test->bytes, test->length, 0x1000,
+                &dead)))
+        {
+            ZYAN_PRINTF("FAILED: %s (query failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+        if (((dead & test->dead) != test->dead) || (dead & test->live))
+        {
+            ZYAN_PRINTF("FAILED: %s (dead: %08X, expected dead: %08X, expected live: %08X)\n",
+                test->name, dead, test->dead, test->live);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All dead flags tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunMacroFusionTests(void)
+{
+    static const MacroFusionTest tests[] =
+    {
+        { "cmp eax, ebx; jz", { 0x39, 0xD8, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "cmp dword ptr [rax], ebx; jz", { 0x39, 0x18, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "cmp dword ptr [rax], 0x01; jz", { 0x83, 0x38, 0x01, 0x74, 0x00 }, 5, ZYAN_FALSE },
+        { "test dword ptr [rax], ebx; js", { 0x85, 0x18, 0x78, 0x00 }, 4, ZYAN_TRUE },
+        { "add eax, ebx; jz", { 0x01, 0xD8, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "add dword ptr [rax], ebx; jz", { 0x01, 0x18, 0x74, 0x00 }, 4, ZYAN_FALSE },
+        { "add ebx, dword ptr [rax]; jz", { 0x03, 0x18, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "and ebx, dword ptr [rax]; jz", { 0x23, 0x18, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "and dword ptr [rax], ebx; jz", { 0x21, 0x18, 0x74, 0x00 }, 4, ZYAN_FALSE },
+        {
+            "sub ebx, dword ptr [rip+0x10]; jb",
+            { 0x2B, 0x1D, 0x10, 0x00, 0x00, 0x00, 0x72, 0x00 }, 8, ZYAN_FALSE
+        },
+        { "inc eax; jz", { 0xFF, 0xC0, 0x74, 0x00 }, 4, ZYAN_TRUE },
+        { "dec dword ptr [rax]; jz", { 0xFF, 0x08, 0x74, 0x00 }, 4, ZYAN_FALSE },
+    };
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const MacroFusionTest* test = &tests[i];
+
+        ZydisDecodedInstruction first;
+        ZydisDecodedInstruction second;
+        if (ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, ZYAN_NULL, test->bytes,
+            test->length, &first)) ||
+            ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, ZYAN_NULL,
+            test->bytes + first.length, test->length - first.length, &second)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+        if (ZydisIsMacroFusedPair(&first, &second, ZYDIS_MICROARCH_SKYLAKE) != test->fused)
+        {
+            ZYAN_PRINTF("FAILED: %s (expected %s)\n", test->name,
+                test->fused ? "fused" : "not fused");
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All macro-fusion tests passed\n");
+    }
+    return all_passed;
+}
+
+/**
+ * Collects the expected references of the given test by decoding all operands and resolving
+ * them with `ZydisCalcAbsoluteAddress`.
+ */
+static ZyanBool CollectExpectedReferences(const ZydisDecoder* decoder, const ReferencesTest* test,
+    ZydisReference* references, ZyanUSize* count)
+{
+    const ZyanUSize capacity = *count;
+    *count = 0;
+
+    ZydisDecodedInstruction instruction;
+    ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+    for (ZyanUSize offset = 0; offset < test->length; offset += instruction.length)
+    {
+        if (ZYAN_FAILED(ZydisDecoderDecodeFull(decoder, test->bytes + offset,
+            test->length - offset, &instruction, operands)))
+        {
+            return ZYAN_FALSE;
+        }
+        for (ZyanU8 i = 0; i < instruction.operand_count_visible; ++i)
+        {
+            const ZydisDecodedOperand* operand = &operands[i];
+            ZydisReference reference;
+            if ((operand->type == ZYDIS_OPERAND_TYPE_MEMORY) &&
+                ((operand->mem.base == ZYDIS_REGISTER_RIP) ||
+                 (operand->mem.base == ZYDIS_REGISTER_EIP)))
+            {
+                reference.kind = ZYDIS_REFERENCE_KIND_MEMORY;
+                reference.field_offset = instruction.raw.disp.offset;
+                reference.field_size = instruction.raw.disp.size;
+            } else if ((operand->type == ZYDIS_OPERAND_TYPE_IMMEDIATE) &&
+                operand->imm.is_relative)
+            {
+                reference.kind = (instruction.mnemonic == ZYDIS_MNEMONIC_CALL) ?
+                    ZYDIS_REFERENCE_KIND_CALL : ZYDIS_REFERENCE_KIND_BRANCH;
+                reference.field_offset = instruction.raw.imm[0].offset;
+                reference.field_size = instruction.raw.imm[0].size;
+            } else
+            {
+                continue;
+            }
+            if ((*count == capacity) ||
+                ZYAN_FAILED(ZydisCalcAbsoluteAddress(&instruction, operand,
+                test->runtime_address + offset, &reference.address)))
+            {
+                return ZYAN_FALSE;
+            }
+            reference.offset = offset;
+            reference.length = instruction.length;
+            references[(*count)++] = reference;
+        }
+    }
+    return ZYAN_TRUE;
+}
+
+static ZyanBool RunReferencesTests(void)
+{
+    static const ReferencesTest tests[] =
+    {
+        {
+            "64-bit",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x140001000,
+            {
+                0x48, 0x8B, 0x05, 0x00, 0x01, 0x00, 0x00, // mov rax, [rip+0x100]
+                0x67, 0x8D, 0x0D, 0x20, 0x00, 0x00, 0x00, // lea ecx, [eip+0x20]
+                0xE8, 0x10, 0x00, 0x00, 0x00,             // call +0x10
+                0x74, 0xF0,                               // jz -0x10
+                0xC7, 0xF8, 0x00, 0x01, 0x00, 0x00,       // xbegin +0x100
+                0x8B, 0x40, 0x10,                         // mov eax, [rax+0x10]
+                0xFF, 0x25, 0x08, 0x00, 0x00, 0x00,       // jmp [rip+0x08]
+                0xE2, 0xFE,                               // loop -0x02
+            }, 38,
+            {
+                0x140001107,
+                0x4000102E, // `EIP`-relative addresses are truncated to 32 bits
+                0x140001023,
+                0x140001005,
+                0x14000111B,
+                0x14000102C,
+                0x140001024,
+            }, 7
+        },
+        {
+            "64-bit, EIP wrap-around",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x1FFFFFFF0,
+            {
+                0x67, 0x8D, 0x05, 0x20, 0x00, 0x00, 0x00, // lea eax, [eip+0x20]
+            }, 7,
+            { 0x17 }, 1
+        },
+        {
+            "32-bit",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32, 0x401000,
+            {
+                0xE8, 0x20, 0x00, 0x00, 0x00,             // call +0x20
+                0x0F, 0x85, 0x00, 0x01, 0x00, 0x00,       // jnz +0x100
+                0x8B, 0x05, 0x34, 0x12, 0x00, 0x00,       // mov eax, [0x1234] (absolute)
+                0x66, 0x0F, 0x84, 0x00, 0x10,             // jz +0x1000 (16-bit operand size)
+                0x66, 0xC7, 0xF8, 0x00, 0x10,             // xbegin +0x1000 (16-bit operand size)
+                0xEB, 0xFE,                               // jmp -0x02
+            }, 29,
+            {
+                0x401025,
+                0x40110B,
+                0x2016,   // Truncated to 16 bits
+                0x40201B, // `XBEGIN` is never truncated
+                0x40101B,
+            }, 5
+        },
+        {
+            "16-bit",
+            ZYDIS_MACHINE_MODE_REAL_16, ZYDIS_STACK_WIDTH_16, 0xFFF0,
+            {
+                0x74, 0x20,                               // jz +0x20
+                0xE8, 0x00, 0x01,                         // call +0x100
+                0xC7, 0xF8, 0x00, 0x01,                   // xbegin +0x100
+                0xE2, 0xFE,                               // loop -0x02
+                0x66, 0xE9, 0x00, 0x00, 0x01, 0x00,       // jmp +0x10000 (32-bit operand size)
+            }, 17,
+            {
+                0x0012,
+                0x00F5,
+                0x100F9,
+                0xFFF9,
+                0x20001,
+            }, 5
+        },
+    };
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const ReferencesTest* test = &tests[i];
+
+        if ((test->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+            (ZydisIsFeatureEnabled(ZYDIS_FEATURE_LEGACY_MODES) != ZYAN_STATUS_TRUE))
+        {
+            continue;
+        }
+
+        ZydisDecoder decoder;
+        if (ZYAN_FAILED(ZydisDecoderInit(&decoder, test->machine_mode, test->stack_width)))
+        {
+            ZYAN_PRINTF("Failed to initialize decoder\n");
+            return ZYAN_FALSE;
+        }
+
+        ZydisReference expected[8];
+        ZyanUSize expected_count = ZYAN_ARRAY_LENGTH(expected);
+        if (!CollectExpectedReferences(&decoder, test, expected, &expected_count) ||
+            (expected_count != test->address_count))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        // Scan everything at once, then again with room for a single reference per call
+        static const ZyanUSize capacities[] = { 8, 1 };
+        for (ZyanUSize j = 0; j < ZYAN_ARRAY_LENGTH(capacities); ++j)
+        {
+            ZydisReference references[8];
+            ZyanUSize total = 0;
+            ZyanUSize offset = 0;
+            ZyanBool passed = ZYAN_TRUE;
+            while (passed && (offset < test->length))
+            {
+                ZyanUSize count = capacities[j];
+                passed = ZYAN_SUCCESS(ZydisScanReferences(&decoder, test->bytes, test->length,
+                    test->runtime_address, &offset, references + total, &count)) &&
+                    (total + count <= test->address_count) && (count > 0);
+                total += count;
+            }
+            passed &= (total == test->address_count);
+            for (ZyanUSize k = 0; passed && (k < total); ++k)
+            {
+                passed = (references[k].offset == expected[k].offset) &&
+                         (references[k].length == expected[k].length) &&
+                         (references[k].kind == expected[k].kind) &&
+                         (references[k].field_offset == expected[k].field_offset) &&
+                         (references[k].field_size == expected[k].field_size) &&
+                         (references[k].address == expected[k].address) &&
+                         (references[k].address == test->addresses[k]);
+                if (!passed)
+                {
+                    ZYAN_PRINTF("FAILED: %s (reference %u: %016" PRIX64 ", expected %016"
+                        PRIX64 ")\n", test->name, (ZyanU32)k, references[k].address,
+                        test->addresses[k]);
+                }
+            }
+            if (!passed)
+            {
+                ZYAN_PRINTF("FAILED: %s (capacity %u)\n", test->name, (ZyanU32)capacities[j]);
+                all_passed = ZYAN_FALSE;
+                break;
+            }
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All references tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunJumpTableTests(void)
+{
+    static const JumpTableTest tests[] =
+    {
+        {
+            "GCC, absolute",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xFF, 0x03,                         // cmp edi, 3
+                0x77, 0x09,                               // ja default
+                0x89, 0xFF,                               // mov edi, edi
+                0xFF, 0x24, 0xFD, 0x00, 0x20, 0x40, 0x00, // jmp [rdi*8+0x402000]
+                0xC3,                                     // ret
+            }, 15, 0x07,
+            ZYAN_STATUS_SUCCESS, { 0x402000, 0, 4, 8, ZYAN_FALSE, 64 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 }
+        },
+        {
+            "GCC/Clang, position-independent",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xFF, 0x05,                         // cmp edi, 5
+                0x73, 0x10,                               // jae default
+                0x48, 0x8D, 0x15, 0xF4, 0x0F, 0x00, 0x00, // lea rdx, [rip+0xFF4]
+                0x48, 0x63, 0x04, 0xBA,                   // movsxd rax, [rdx+rdi*4]
+                0x48, 0x01, 0xD0,                         // add rax, rdx
+                0xFF, 0xE0,                               // jmp rax
+                0xC3,                                     // ret
+            }, 22, 0x13,
+            ZYAN_STATUS_SUCCESS, { 0x402000, 0x402000, 5, 4, ZYAN_TRUE, 64 },
+            { 0xFFFFF100, 0xFFFFF110, 0xFFFFF120, 0xFFFFF130, 0xFFFFF140 },
+            { 0x401100, 0x401110, 0x401120, 0x401130, 0x401140 }
+        },
+        {
+            "MSVC, image base relative",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x140001000,
+            {
+                0x83, 0xF9, 0x02,                         // cmp ecx, 2
+                0x77, 0x16,                               // ja default
+                0x48, 0x63, 0xC1,                         // movsxd rax, ecx
+                0x48, 0x8D, 0x15, 0xF1, 0xEF, 0xFF, 0xFF, // lea rdx, [__ImageBase]
+                0x8B, 0x8C, 0x82, 0x00, 0x20, 0x00, 0x00, // mov ecx, [rdx+rax*4+0x2000]
+                0x48, 0x01, 0xD1,                         // add rcx, rdx
+                0xFF, 0xE1,                               // jmp rcx
+                0xC3,                                     // ret
+            }, 28, 0x19,
+            ZYAN_STATUS_SUCCESS, { 0x140002000, 0x140000000, 3, 4, ZYAN_FALSE, 64 },
+            { 0x1100, 0x1110, 0x1120 },
+            { 0x140001100, 0x140001110, 0x140001120 }
+        },
+        {
+            "AND mask",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xE0, 0x03,                         // and eax, 3
+                0xFF, 0x24, 0xC5, 0x00, 0x20, 0x40, 0x00, // jmp [rax*8+0x402000]
+            }, 10, 0x03,
+            ZYAN_STATUS_SUCCESS, { 0x402000, 0, 4, 8, ZYAN_FALSE, 64 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 }
+        },
+        {
+            "Bounds check on a copy of the index",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x89, 0xF0,                               // mov eax, esi
+                0x83, 0xFE, 0x03,                         // cmp esi, 3
+                0x77, 0x07,                               // ja default
+                0xFF, 0x24, 0xC5, 0x00, 0x20, 0x40, 0x00, // jmp [rax*8+0x402000]
+                0xC3,                                     // ret
+            }, 15, 0x07,
+            ZYAN_STATUS_SUCCESS, { 0x402000, 0, 4, 8, ZYAN_FALSE, 64 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 },
+            { 0x401100, 0x401110, 0x401120, 0x401130 }
+        },
+        {
+            "MSVC, 32-bit absolute",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32, 0x401000,
+            {
+                0x83, 0xF8, 0x05,                         // cmp eax, 5
+                0x77, 0x07,                               // ja default
+                0xFF, 0x24, 0x85, 0x00, 0x20, 0x40, 0x00, // jmp [eax*4+0x402000]
+                0xC3,                                     // ret
+            }, 13, 0x05,
+            ZYAN_STATUS_SUCCESS, { 0x402000, 0, 6, 4, ZYAN_FALSE, 32 },
+            { 0x401100, 0x401110, 0x401120, 0x401130, 0x401140, 0x401150 },
+            { 0x401100, 0x401110, 0x401120, 0x401130, 0x401140, 0x401150 }
+        },
+        {
+            "Jump target modified by CDQE",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xF9, 0x03,                         // cmp ecx, 3
+                0x77, 0x0C,                               // ja default
+                0x48, 0x8B, 0x04, 0xCD, 0x00, 0x20, 0x40, // mov rax, [rcx*8+0x402000]
+                0x00,
+                0x48, 0x98,                               // cdqe
+                0xFF, 0xE0,                               // jmp rax
+                0xC3,                                     // ret
+            }, 18, 0x0F,
+            ZYAN_STATUS_NOT_FOUND, { 0 }, { 0 }, { 0 }
+        },
+        {
+            "Index clobbered by MUL",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xFA, 0x03,                         // cmp edx, 3
+                0x77, 0x09,                               // ja default
+                0xF7, 0xE1,                               // mul ecx
+                0xFF, 0x24, 0xD5, 0x00, 0x20, 0x40, 0x00, // jmp [rdx*8+0x402000]
+                0xC3,                                     // ret
+            }, 15, 0x07,
+            ZYAN_STATUS_NOT_FOUND, { 0 }, { 0 }, { 0 }
+        },
+        {
+            "Index clobbered by MOV",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0x83, 0xF9, 0x03,                         // cmp ecx, 3
+                0x77, 0x0B,                               // ja default
+                0x8B, 0x4C, 0x24, 0x08,                   // mov ecx, [rsp+8]
+                0xFF, 0x24, 0xCD, 0x00, 0x20, 0x40, 0x00, // jmp [rcx*8+0x402000]
+                0xC3,                                     // ret
+            }, 16, 0x09,
+            ZYAN_STATUS_NOT_FOUND, { 0 }, { 0 }, { 0 }
+        },
+        {
+            "No bounds check",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64, 0x401000,
+            {
+                0xFF, 0x24, 0xC5, 0x00, 0x20, 0x40, 0x00, // jmp [rax*8+0x402000]
+            }, 7, 0x00,
+            ZYAN_STATUS_NOT_FOUND, { 0 }, { 0 }, { 0 }
+        },
+    };
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const JumpTableTest* test = &tests[i];
+
+        if ((test->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+            (ZydisIsFeatureEnabled(ZYDIS_FEATURE_LEGACY_MODES) != ZYAN_STATUS_TRUE))
+        {
+            continue;
+        }
+
+        ZydisDecoder decoder;
+        if (ZYAN_FAILED(ZydisDecoderInit(&decoder, test->machine_mode, test->stack_width)))
+        {
+            ZYAN_PRINTF("Failed to initialize decoder\n");
+            return ZYAN_FALSE;
+        }
+
+        // Lay out the table entries in memory (little-endian, like the library assumes)
+        const ZydisJumpTable* expected = &test->table;
+        ZyanU8 data[ZYAN_ARRAY_LENGTH(test->entries) * 8];
+        for (ZyanU32 j = 0; j < expected->entry_count; ++j)
+        {
+            ZYAN_MEMCPY(data + j * expected->entry_size, &test->entries[j],
+                expected->entry_size);
+        }
+        const ZydisMemoryView memory =
+        {
+            expected->table_address, data, expected->entry_count * expected->entry_size
+        };
+
+        ZydisJumpTable table;
+        const ZyanStatus status = ZydisRecoverJumpTable(&decoder, test->bytes, test->length,
+            test->runtime_address, test->runtime_address + test->jump_offset, &memory, &table);
+        if (status != test->status)
+        {
+            ZYAN_PRINTF("FAILED: %s (status %08X, expected %08X)\n", test->name, status,
+                test->status);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            continue;
+        }
+        if ((table.table_address != expected->table_address) ||
+            (table.base_address != expected->base_address) ||
+            (table.entry_count != expected->entry_count) ||
+            (table.entry_size != expected->entry_size) ||
+            (table.is_signed != expected->is_signed) ||
+            (table.address_width != expected->address_width))
+        {
+            ZYAN_PRINTF("FAILED: %s (table %016" PRIX64 ", base %016" PRIX64 ", %u entries of "
+                "%u bytes)\n", test->name, table.table_address, table.base_address,
+                table.entry_count, table.entry_size);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        ZyanU64 targets[ZYAN_ARRAY_LENGTH(test->targets)];
+        ZyanUSize count = ZYAN_ARRAY_LENGTH(targets);
+        if (ZYAN_FAILED(ZydisGetJumpTableTargets(&table, &memory, targets, &count)) ||
+            (count != table.entry_count) ||
+            ZYAN_MEMCMP(targets, test->targets, count * sizeof(targets[0])))
+        {
+            ZYAN_PRINTF("FAILED: %s (wrong targets)\n", test->name);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All jump table tests passed\n");
+    }
+    return all_passed;
+}
+
+/**
+ * Writes a little-endian value to the given vector register of an address context buffer.
+ *
+ * @param   vectors The vector register buffer.
+ * @param   id      The id of the vector register.
+ * @param   offset  The byte offset inside the register.
+ * @param   value   The value.
+ * @param   size    The size of the value in bytes.
+ */
+static void SetVectorElement(ZyanU8* vectors, ZyanU8 id, ZyanUSize offset, ZyanU64 value,
+    ZyanU8 size)
+{
+    for (ZyanU8 i = 0; i < size; ++i)
+    {
+        vectors[id * ZYDIS_ADDRESS_CONTEXT_VECTOR_SIZE + offset + i] = (ZyanU8)(value >> (i * 8));
+    }
+}
+
+static ZyanBool RunMemoryAccessTests(void)
+{
+    static const MemoryAccessTest tests[] =
+    {
+        {
+            // 4 dword indices, the sign bits of the `YMM2` qwords select lanes 0, 1 and 3
+            "vgatherdpd ymm0, [rax+xmm1*8], ymm2",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0xC4, 0xE2, 0xED, 0x92, 0x04, 0xC8 }, 6,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL |
+                 ZYDIS_MEMORY_ACCESS_FLAG_VSIB },
+            3, { { 0x10008, 64, 0, 0 }, { 0xFFF8, 64, 0, 1 }, { 0x10018, 64, 0, 3 } }
+        },
+        {
+            // 4 qword indices (not 8 dwords), the sign bits of the `XMM4` dwords select lanes 0
+            // and 2
+            "vgatherqps xmm0, [rax+ymm3*4], xmm4",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0xC4, 0xE2, 0x5D, 0x93, 0x04, 0x98 }, 6,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL |
+                 ZYDIS_MEMORY_ACCESS_FLAG_VSIB },
+            2, { { 0x10400, 32, 0, 0 }, { 0xFFF0, 32, 0, 2 } }
+        },
+        {
+            // 16 dword indices, `K1` selects lanes 0 and 15 (the sign bits of `ZMM6` are clear)
+            "vpscatterdd [rax+zmm5*4]{k1}, zmm6",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x62, 0xF2, 0x7D, 0x49, 0xA0, 0x34, 0xA8 }, 7,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_WRITE | ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL |
+                 ZYDIS_MEMORY_ACCESS_FLAG_VSIB },
+            2, { { 0x10000, 32, 0, 0 }, { 0x10078, 32, 0, 15 } }
+        },
+        {
+            "vaddps zmm0, zmm1, [rax+8]{1to16}",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x62, 0xF1, 0x74, 0x58, 0x58, 0x40, 0x02 }, 7,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_BROADCAST },
+            1, { { 0x10008, 32, 0, 0 } }
+        },
+        {
+            "vmovups zmm0{k1}, [rax]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x62, 0xF1, 0x7C, 0x49, 0x10, 0x00 }, 6,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_CONDITIONAL },
+            1, { { 0x10000, 512, 0, 0 } }
+        },
+        {
+            "push rbx",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x53 }, 1,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_WRITE | ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT |
+                 ZYDIS_MEMORY_ACCESS_FLAG_STACK },
+            1, { { 0x7FE8, 64, 0, 0 } }
+        },
+        {
+            "call rbx",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0xFF, 0xD3 }, 2,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_WRITE | ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT |
+                 ZYDIS_MEMORY_ACCESS_FLAG_STACK },
+            1, { { 0x7FE8, 64, 0, 0 } }
+        },
+        {
+            "pop rax",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x58 }, 1,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT |
+                 ZYDIS_MEMORY_ACCESS_FLAG_STACK },
+            1, { { 0x7FF0, 64, 0, 0 } }
+        },
+        {
+            "mov rax, fs:[rbx+8]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x64, 0x48, 0x8B, 0x43, 0x08 }, 5,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ },
+            1, { { 0x7FFF0108, 64, 0, 0 } }
+        },
+        {
+            "mov rax, gs:[0x30]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x65, 0x48, 0x8B, 0x04, 0x25, 0x30, 0x00, 0x00, 0x00 }, 9,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ },
+            1, { { 0x12340030, 64, 0, 0 } }
+        },
+        {
+            // The `DS` base is ignored in 64-bit mode
+            "mov eax, ds:[rbx]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x3E, 0x8B, 0x03 }, 3,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ },
+            1, { { 0x100, 32, 0, 0 } }
+        },
+        {
+            "mov eax, [rip+0x10]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x8B, 0x05, 0x10, 0x00, 0x00, 0x00 }, 6,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_RELATIVE },
+            1, { { 0x401016, 32, 0, 0 } }
+        },
+        {
+            "rep movsb",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0xF3, 0xA4 }, 2,
+            2, { ZYDIS_MEMORY_ACCESS_FLAG_WRITE | ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT |
+                 ZYDIS_MEMORY_ACCESS_FLAG_STRING | ZYDIS_MEMORY_ACCESS_FLAG_REPEATED,
+                 ZYDIS_MEMORY_ACCESS_FLAG_READ | ZYDIS_MEMORY_ACCESS_FLAG_IMPLICIT |
+                 ZYDIS_MEMORY_ACCESS_FLAG_STRING | ZYDIS_MEMORY_ACCESS_FLAG_REPEATED },
+            2, { { 0x3000, 8, 0, 0 }, { 0x2000, 8, 1, 0 } }
+        },
+        {
+            "lea rax, [rbx+8]",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x48, 0x8D, 0x43, 0x08 }, 4,
+            0, { 0 }, 0, { { 0 } }
+        },
+        {
+            "mov eax, fs:[ebx] (32-bit)",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32,
+            { 0x64, 0x8B, 0x03 }, 3,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ },
+            1, { { 0x7FFF0100, 32, 0, 0 } }
+        },
+        {
+            // The `DS` base applies outside of 64-bit mode and the linear address wraps
+            "mov eax, ds:[ebx-4] (32-bit)",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32,
+            { 0x3E, 0x8B, 0x43, 0xFC }, 4,
+            1, { ZYDIS_MEMORY_ACCESS_FLAG_READ },
+            1, { { 0x7C, 32, 0, 0 } }
+        },
+    };
+
+    static ZydisRegisterContext registers;
+    registers.values[ZYDIS_REGISTER_RAX] = 0x10000;
+    registers.values[ZYDIS_REGISTER_RBX] = 0x100;
+    registers.values[ZYDIS_REGISTER_EBX] = 0x100;
+    registers.values[ZYDIS_REGISTER_RSP] = 0x7FF0;
+    registers.values[ZYDIS_REGISTER_RSI] = 0x2000;
+    registers.values[ZYDIS_REGISTER_RDI] = 0x3000;
+    registers.values[ZYDIS_REGISTER_K1]  = 0x8001;
+
+    static ZyanU8 vectors[32 * ZYDIS_ADDRESS_CONTEXT_VECTOR_SIZE];
+    static const ZyanI32 xmm1[] = { 1, -1, 2, 3 };
+    static const ZyanU64 ymm2[] =
+    {
+        0x8000000000000000, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 0x8000000000000000
+    };
+    static const ZyanI64 ymm3[] = { 0x100, 0x200, -4, 0x400 };
+    static const ZyanU32 xmm4[] = { 0x80000000, 0x00000000, 0xFFFFFFFF, 0x7FFFFFFF };
+    for (ZyanU8 i = 0; i < 4; ++i)
+    {
+        SetVectorElement(vectors, 1, i * 4, (ZyanU64)(ZyanU32)xmm1[i], 4);
+        SetVectorElement(vectors, 2, i * 8, ymm2[i], 8);
+        SetVectorElement(vectors, 3, i * 8, (ZyanU64)ymm3[i], 8);
+        SetVectorElement(vectors, 4, i * 4, xmm4[i], 4);
+    }
+    for (ZyanU8 i = 0; i < 16; ++i)
+    {
+        SetVectorElement(vectors, 5, i * 4, i * 2, 4);
+    }
+
+    ZydisAddressContext context;
+    ZYAN_MEMSET(&context, 0, sizeof(context));
+    context.registers = &registers;
+    context.segment_bases[ZYDIS_REGISTER_DS - ZYDIS_REGISTER_ES] = 0xFFFFFF80;
+    context.segment_bases[ZYDIS_REGISTER_FS - ZYDIS_REGISTER_ES] = 0x7FFF0000;
+    context.segment_bases[ZYDIS_REGISTER_GS - ZYDIS_REGISTER_ES] = 0x12340000;
+    context.vectors = vectors;
+
+    const ZyanU64 runtime_address = 0x401000;
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const MemoryAccessTest* test = &tests[i];
+
+        if ((test->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+            (ZydisIsFeatureEnabled(ZYDIS_FEATURE_LEGACY_MODES) != ZYAN_STATUS_TRUE))
+        {
+            continue;
+        }
+        if ((test->bytes[0] == 0x62) &&
+            (ZydisIsFeatureEnabled(ZYDIS_FEATURE_AVX512) != ZYAN_STATUS_TRUE))
+        {
+            continue;
+        }
+
+        ZydisDecoder decoder;
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (ZYAN_FAILED(ZydisDecoderInit(&decoder, test->machine_mode, test->stack_width)) ||
+            ZYAN_FAILED(ZydisDecoderDecodeFull(&decoder, test->bytes, test->length,
+                &instruction, operands)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        ZydisMemoryAccesses accesses;
+        ZydisMemoryAddresses addresses;
+        const ZyanStatus status = ZydisCalcMemoryAddresses(&instruction, operands,
+            instruction.operand_count, runtime_address, &context, &accesses, &addresses);
+        if (ZYAN_FAILED(status))
+        {
+            ZYAN_PRINTF("FAILED: %s (status %08X)\n", test->name, status);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        ZyanBool passed = (accesses.count == test->access_count) &&
+            (addresses.count == test->address_count);
+        for (ZyanU8 j = 0; passed && (j < accesses.count); ++j)
+        {
+            passed = (accesses.accesses[j].flags == test->flags[j]);
+        }
+        for (ZyanU8 j = 0; passed && (j < addresses.count); ++j)
+        {
+            const ZydisMemoryAddress* actual = &addresses.addresses[j];
+            const ZydisMemoryAddress* expected = &test->addresses[j];
+            passed = (actual->address == expected->address) &&
+                (actual->size == expected->size) &&
+                (actual->access_index == expected->access_index) &&
+                (actual->element_index == expected->element_index);
+        }
+        if (!passed)
+        {
+            ZYAN_PRINTF("FAILED: %s (%u accesses, %u addresses)\n", test->name,
+                accesses.count, addresses.count);
+            for (ZyanU8 j = 0; j < accesses.count; ++j)
+            {
+                ZYAN_PRINTF("  access %u: flags %08X\n", j, accesses.accesses[j].flags);
+            }
+            for (ZyanU8 j = 0; j < addresses.count; ++j)
+            {
+                ZYAN_PRINTF("  address %u: %016" PRIX64 " (%u bits, access %u, element %u)\n",
+                    j, addresses.addresses[j].address, addresses.addresses[j].size,
+                    addresses.addresses[j].access_index, addresses.addresses[j].element_index);
+            }
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All memory access tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunControlFlowTests(void)
+{
+    // A diamond joining into a loop whose back edge targets the middle of the block explored
+    // linearly from the join point
+    static const ZyanU8 code[] =
+    {
+        0xB8, 0x00, 0x00, 0x00, 0x00, // 401000: mov eax, 0
+        0x85, 0xFF,                   // 401005: test edi, edi
+        0x74, 0x04,                   // 401007: jz 0x40100D
+        0x89, 0xF1,                   // 401009: mov ecx, esi
+        0xEB, 0x02,                   // 40100B: jmp 0x40100F
+        0x89, 0xD1,                   // 40100D: mov ecx, edx
+        0x01, 0xC8,                   // 40100F: add eax, ecx
+        0xFF, 0xCF,                   // 401011: dec edi
+        0x75, 0xFC,                   // 401013: jnz 0x401011
+        0xC3,                         // 401015: ret
+    };
+    static const ZydisCfgBlock expected_blocks[] =
+    {
+        { 0x401000, 9, 3, 0, 2 },
+        { 0x401009, 4, 2, 2, 1 },
+        { 0x40100D, 2, 1, 3, 1 },
+        { 0x40100F, 2, 1, 4, 1 },
+        { 0x401011, 4, 2, 5, 2 },
+        { 0x401015, 1, 1, 7, 1 },
+    };
+    static const ZydisCfgEdge expected_edges[] =
+    {
+        { 0x40100D, 2, ZYDIS_CFG_EDGE_TYPE_JUMP,        ZYAN_FALSE, ZYAN_TRUE  },
+        { 0x401009, 1, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, ZYAN_FALSE, ZYAN_TRUE  },
+        { 0x40100F, 3, ZYDIS_CFG_EDGE_TYPE_JUMP,        ZYAN_FALSE, ZYAN_FALSE },
+        { 0x40100F, 3, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, ZYAN_FALSE, ZYAN_FALSE },
+        { 0x401011, 4, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, ZYAN_FALSE, ZYAN_FALSE },
+        { 0x401011, 4, ZYDIS_CFG_EDGE_TYPE_JUMP,        ZYAN_FALSE, ZYAN_TRUE  },
+        { 0x401015, 5, ZYDIS_CFG_EDGE_TYPE_FALLTHROUGH, ZYAN_FALSE, ZYAN_TRUE  },
+        { 0, ZYDIS_CFG_BLOCK_NONE, ZYDIS_CFG_EDGE_TYPE_RETURN, ZYAN_FALSE, ZYAN_FALSE },
+    };
+    // Live-in general purpose registers of each block, with `RAX` live at the return
+    static const ZydisRegister gprs[] =
+    {
+        ZYDIS_REGISTER_RAX, ZYDIS_REGISTER_RCX, ZYDIS_REGISTER_RDX, ZYDIS_REGISTER_RSI,
+        ZYDIS_REGISTER_RDI
+    };
+    static const ZyanU8 expected_live_in[] =
+    {
+        0x1C, // rdx, rsi, rdi
+        0x19, // rax, rsi, rdi
+        0x15, // rax, rdx, rdi
+        0x13, // rax, rcx, rdi
+        0x11, // rax, rdi
+        0x01, // rax
+    };
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanU8 workspace[2 * ((sizeof(code) + 7) / 8)];
+    ZydisCfg cfg;
+    if (ZydisCfgGetWorkspaceSize(sizeof(code)) != sizeof(workspace) ||
+        ZYAN_FAILED(ZydisCfgInit(&cfg, &decoder, code, sizeof(code), 0x401000, ZYAN_FALSE,
+            workspace, sizeof(workspace))) ||
+        ZYAN_FAILED(ZydisCfgAddEntryPoint(&cfg, 0x401000)) ||
+        ZYAN_FAILED(ZydisCfgExplore(&cfg)))
+    {
+        ZYAN_PRINTF("FAILED: Exploration\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+
+    // Too small edge buffer
+    ZydisCfgBlock blocks[8];
+    ZydisCfgEdge edges[8];
+    ZyanUSize block_count = ZYAN_ARRAY_LENGTH(blocks);
+    ZyanUSize edge_count = 4;
+    ZyanStatus status = ZydisCfgBuild(&cfg, blocks, &block_count, edges, &edge_count);
+    if ((status != ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE) ||
+        (block_count != ZYAN_ARRAY_LENGTH(expected_blocks)) ||
+        (edge_count != ZYAN_ARRAY_LENGTH(expected_edges)))
+    {
+        ZYAN_PRINTF("FAILED: Edge buffer overflow (status %08X, %u blocks, %u edges)\n", status,
+            (ZyanU32)block_count, (ZyanU32)edge_count);
+        all_passed = ZYAN_FALSE;
+    }
+
+    block_count = ZYAN_ARRAY_LENGTH(blocks);
+    edge_count = ZYAN_ARRAY_LENGTH(edges);
+    status = ZydisCfgBuild(&cfg, blocks, &block_count, edges, &edge_count);
+    if (ZYAN_FAILED(status) ||
+        (block_count != ZYAN_ARRAY_LENGTH(expected_blocks)) ||
+        (edge_count != ZYAN_ARRAY_LENGTH(expected_edges)))
+    {
+        ZYAN_PRINTF("FAILED: Build (status %08X, %u blocks, %u edges)\n", status,
+            (ZyanU32)block_count, (ZyanU32)edge_count);
+        return ZYAN_FALSE;
+    }
+    for (ZyanUSize i = 0; i < block_count; ++i)
+    {
+        const ZydisCfgBlock* actual = &blocks[i];
+        const ZydisCfgBlock* expected = &expected_blocks[i];
+        if ((actual->address != expected->address) || (actual->length != expected->length) ||
+            (actual->instruction_count != expected->instruction_count) ||
+            (actual->first_edge != expected->first_edge) ||
+            (actual->edge_count != expected->edge_count))
+        {
+            ZYAN_PRINTF("FAILED: Block %u (%016" PRIX64 ", %u bytes, %u instructions)\n",
+                (ZyanU32)i, actual->address, actual->length, actual->instruction_count);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+    for (ZyanUSize i = 0; i < edge_count; ++i)
+    {
+        const ZydisCfgEdge* actual = &edges[i];
+        const ZydisCfgEdge* expected = &expected_edges[i];
+        if ((actual->type != expected->type) || (actual->target != expected->target) ||
+            (actual->is_indirect != expected->is_indirect) ||
+            (actual->is_conditional != expected->is_conditional) ||
+            ((actual->type != ZYDIS_CFG_EDGE_TYPE_RETURN) &&
+             (actual->target_address != expected->target_address)))
+        {
+            ZYAN_PRINTF("FAILED: Edge %u (type %d, target %u)\n", (ZyanU32)i, actual->type,
+                actual->target);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    static const struct
+    {
+        ZyanU64 address;
+        ZyanStatus status;
+        ZyanUSize index;
+    } lookups[] =
+    {
+        { 0x400FFF, ZYAN_STATUS_NOT_FOUND, 0 },
+        { 0x401000, ZYAN_STATUS_SUCCESS,   0 },
+        { 0x401008, ZYAN_STATUS_SUCCESS,   0 },
+        { 0x40100E, ZYAN_STATUS_SUCCESS,   2 },
+        { 0x401013, ZYAN_STATUS_SUCCESS,   4 },
+        { 0x401015, ZYAN_STATUS_SUCCESS,   5 },
+        { 0x401016, ZYAN_STATUS_NOT_FOUND, 0 },
+    };
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(lookups); ++i)
+    {
+        ZyanUSize index = 0;
+        status = ZydisCfgFindBlock(blocks, block_count, lookups[i].address, &index);
+        if ((status != lookups[i].status) || (ZYAN_SUCCESS(status) && (index != lookups[i].index)))
+        {
+            ZYAN_PRINTF("FAILED: ZydisCfgFindBlock(%016" PRIX64 ") (status %08X, index %u)\n",
+                lookups[i].address, status, (ZyanU32)index);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    ZydisLivenessOptions options;
+    ZYAN_MEMSET(&options, 0, sizeof(options));
+    ZydisRegisterSetAdd(&options.exit_live, ZYDIS_REGISTER_RAX);
+    ZydisLivenessBlock liveness[ZYAN_ARRAY_LENGTH(blocks)];
+    status = ZydisComputeCfgLiveness(&cfg, blocks, block_count, edges, edge_count, &options,
+        liveness);
+    if (ZYAN_FAILED(status))
+    {
+        ZYAN_PRINTF("FAILED: ZydisComputeCfgLiveness (status %08X)\n", status);
+        return ZYAN_FALSE;
+    }
+    for (ZyanUSize i = 0; i < block_count; ++i)
+    {
+        ZyanU8 live_in = 0;
+        for (ZyanU8 j = 0; j < ZYAN_ARRAY_LENGTH(gprs); ++j)
+        {
+            if (ZydisRegisterSetContains(&liveness[i].live_in, gprs[j]))
+            {
+                live_in |= (ZyanU8)(1 << j);
+            }
+        }
+        if (live_in != expected_live_in[i])
+        {
+            ZYAN_PRINTF("FAILED: Live-in registers of block %u (%02X, expected %02X)\n",
+                (ZyanU32)i, live_in, expected_live_in[i]);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All control flow tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunCfgWorklistTests(void)
+{
+    // More branch targets than fit into the worklist: `N` times `jz target_i`, followed by a
+    // `ret` and the `N` single `ret` targets
+    enum { N = ZYDIS_CFG_WORKLIST_SIZE + 44, TARGETS = N * 6 + 1 };
+    static ZyanU8 code[TARGETS + N];
+    static ZyanU8 workspace[2 * ((sizeof(code) + 7) / 8)];
+    static ZydisCfgBlock blocks[2 * N + 1];
+    static ZydisCfgEdge edges[3 * N + 1];
+    const ZyanU64 runtime_address = 0x401000;
+
+    for (ZyanU32 i = 0; i < N; ++i)
+    {
+        const ZyanU32 rel = (TARGETS + i) - (i * 6 + 6);
+        ZyanU8* const jz = &code[i * 6];
+        jz[0] = 0x0F;
+        jz[1] = 0x84;
+        jz[2] = (ZyanU8)(rel >>  0);
+        jz[3] = (ZyanU8)(rel >>  8);
+        jz[4] = (ZyanU8)(rel >> 16);
+        jz[5] = (ZyanU8)(rel >> 24);
+        code[TARGETS + i] = 0xC3;
+    }
+    code[TARGETS - 1] = 0xC3;
+
+    ZydisDecoder decoder;
+    ZydisCfg cfg;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)) ||
+        ZYAN_FAILED(ZydisCfgInit(&cfg, &decoder, code, sizeof(code), runtime_address,
+            ZYAN_FALSE, workspace, sizeof(workspace))) ||
+        ZYAN_FAILED(ZydisCfgAddEntryPoint(&cfg, runtime_address)) ||
+        ZYAN_FAILED(ZydisCfgExplore(&cfg)))
+    {
+        ZYAN_PRINTF("FAILED: Exploration\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanUSize block_count = ZYAN_ARRAY_LENGTH(blocks);
+    ZyanUSize edge_count = ZYAN_ARRAY_LENGTH(edges);
+    const ZyanStatus status = ZydisCfgBuild(&cfg, blocks, &block_count, edges, &edge_count);
+    if (ZYAN_FAILED(status) || (block_count != 2 * N + 1) || (edge_count != 3 * N + 1))
+    {
+        ZYAN_PRINTF("FAILED: Build (status %08X, %u blocks, %u edges)\n", status,
+            (ZyanU32)block_count, (ZyanU32)edge_count);
+        return ZYAN_FALSE;
+    }
+
+    // Every target has to be explored, including the ones dropped from the full worklist
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanU32 i = 0; i < N; ++i)
+    {
+        const ZyanU64 target = runtime_address + TARGETS + i;
+        const ZydisCfgEdge* jump = &edges[blocks[i].first_edge];
+        ZyanUSize index;
+        if (ZYAN_FAILED(ZydisCfgFindBlock(blocks, block_count, target, &index)) ||
+            (blocks[index].address != target) || (jump->target != index) ||
+            (edges[blocks[index].first_edge].type != ZYDIS_CFG_EDGE_TYPE_RETURN))
+        {
+            ZYAN_PRINTF("FAILED: Target %u (%016" PRIX64 ")\n", i, target);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All worklist tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunOperandLookupTests(void)
+{
+    static const OperandLookupTest tests[] =
+    {
+        {
+            "add rax, [rbx+8] (register)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x48, 0x03, 0x43, 0x08 }, 4,
+            ZYDIS_OPERAND_MATCH_REGISTER, ZYAN_STATUS_SUCCESS, 0
+        },
+        {
+            "add rax, [rbx+8] (memory)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x48, 0x03, 0x43, 0x08 }, 4,
+            ZYDIS_OPERAND_MATCH_MEMORY, ZYAN_STATUS_SUCCESS, 1
+        },
+        {
+            "add rax, [rbx+8] (immediate)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x48, 0x03, 0x43, 0x08 }, 4,
+            ZYDIS_OPERAND_MATCH_IMMEDIATE | ZYDIS_OPERAND_MATCH_RELATIVE |
+            ZYDIS_OPERAND_MATCH_POINTER, ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "lea rax, [rbx+8] (memory)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x48, 0x8D, 0x43, 0x08 }, 4,
+            ZYDIS_OPERAND_MATCH_MEMORY, ZYAN_STATUS_SUCCESS, 1
+        },
+        {
+            "imul eax, ecx, 0x10 (immediate)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x6B, 0xC1, 0x10 }, 3,
+            ZYDIS_OPERAND_MATCH_IMMEDIATE, ZYAN_STATUS_SUCCESS, 2
+        },
+        {
+            "imul eax, ecx, 0x10 (relative)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x6B, 0xC1, 0x10 }, 3,
+            ZYDIS_OPERAND_MATCH_RELATIVE, ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "enter 0x10, 1 (immediate)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0xC8, 0x10, 0x00, 0x01 }, 4,
+            ZYDIS_OPERAND_MATCH_IMMEDIATE, ZYAN_STATUS_SUCCESS, 0
+        },
+        {
+            "jz +0x14 (relative)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x74, 0x14 }, 2,
+            ZYDIS_OPERAND_MATCH_RELATIVE, ZYAN_STATUS_SUCCESS, 0
+        },
+        {
+            "jz +0x14 (immediate)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x74, 0x14 }, 2,
+            ZYDIS_OPERAND_MATCH_IMMEDIATE, ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "jz +0x14 (hidden register)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x74, 0x14 }, 2,
+            ZYDIS_OPERAND_MATCH_REGISTER, ZYAN_STATUS_SUCCESS, 1
+        },
+        {
+            "jz +0x14 (explicit register)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x74, 0x14 }, 2,
+            ZYDIS_OPERAND_MATCH_REGISTER | ZYDIS_OPERAND_MATCH_EXPLICIT,
+            ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "push rax (hidden memory)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x50 }, 1,
+            ZYDIS_OPERAND_MATCH_MEMORY, ZYAN_STATUS_SUCCESS, 2
+        },
+        {
+            "push rax (explicit memory)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x50 }, 1,
+            ZYDIS_OPERAND_MATCH_MEMORY | ZYDIS_OPERAND_MATCH_EXPLICIT,
+            ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "nop (any)",
+            ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64,
+            { 0x90 }, 1,
+            ZYDIS_OPERAND_MATCH_ANY, ZYAN_STATUS_NOT_FOUND, 0
+        },
+        {
+            "call far 0x6D4E:0xE4DDEAAD (pointer)",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32,
+            { 0x9A, 0xAD, 0xEA, 0xDD, 0xE4, 0x4E, 0x6D }, 7,
+            ZYDIS_OPERAND_MATCH_POINTER, ZYAN_STATUS_SUCCESS, 0
+        },
+        {
+            "call far 0x6D4E:0xE4DDEAAD (memory)",
+            ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32,
+            { 0x9A, 0xAD, 0xEA, 0xDD, 0xE4, 0x4E, 0x6D }, 7,
+            ZYDIS_OPERAND_MATCH_MEMORY, ZYAN_STATUS_SUCCESS, 3
+        },
+    };
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const OperandLookupTest* test = &tests[i];
+
+        if ((test->machine_mode != ZYDIS_MACHINE_MODE_LONG_64) &&
+            (ZydisIsFeatureEnabled(ZYDIS_FEATURE_LEGACY_MODES) != ZYAN_STATUS_TRUE))
+        {
+            continue;
+        }
+
+        ZydisDecoder decoder;
+        ZydisDecoderContext context;
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (ZYAN_FAILED(ZydisDecoderInit(&decoder, test->machine_mode, test->stack_width)) ||
+            ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, &context, test->bytes,
+                test->length, &instruction)) ||
+            ZYAN_FAILED(ZydisDecoderDecodeOperands(&decoder, &context, &instruction, operands,
+                ZYDIS_MAX_OPERAND_COUNT)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        // Every single operand has to be identical to the one decoded along with all others
+        ZydisDecodedOperand operand;
+        ZYAN_MEMSET(&operand, 0, sizeof(operand));
+        ZyanBool passed = ZYAN_TRUE;
+        for (ZyanU8 j = 0; j < instruction.operand_count; ++j)
+        {
+            if (ZYAN_FAILED(ZydisDecoderDecodeOperand(&decoder, &context, &instruction, j,
+                &operand)) || ZYAN_MEMCMP(&operand, &operands[j], sizeof(operand)))
+            {
+                passed = ZYAN_FALSE;
+            }
+        }
+        if (ZydisDecoderDecodeOperand(&decoder, &context, &instruction,
+            instruction.operand_count, &operand) != ZYAN_STATUS_INVALID_ARGUMENT)
+        {
+            passed = ZYAN_FALSE;
+        }
+        if (!passed)
+        {
+            ZYAN_PRINTF("FAILED: %s (ZydisDecoderDecodeOperand)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        const ZyanStatus status = ZydisDecoderFindOperand(&decoder, &context, &instruction,
+            test->match, &operand);
+        if ((status != test->status) || (ZYAN_SUCCESS(status) &&
+            ((operand.id != test->id) ||
+             ZYAN_MEMCMP(&operand, &operands[test->id], sizeof(operand)))))
+        {
+            ZYAN_PRINTF("FAILED: %s (status %08X, operand %u)\n", test->name, status,
+                operand.id);
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All operand lookup tests passed\n");
+    }
+    return all_passed;
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+int main(void)
+{
+    ZyanBool all_passed = ZYAN_TRUE;
+    ZYAN_PRINTF("Dead flags tests:\n");
+    all_passed &= RunDeadFlagsTests();
+    ZYAN_PRINTF("\nMacro-fusion tests:\n");
+    all_passed &= RunMacroFusionTests();
+    ZYAN_PRINTF("\nReferences tests:\n");
+    all_passed &= RunReferencesTests();
+    ZYAN_PRINTF("\nJump table tests:\n");
+    all_passed &= RunJumpTableTests();
+    ZYAN_PRINTF("\nMemory access tests:\n");
+    all_passed &= RunMemoryAccessTests();
+    ZYAN_PRINTF("\nControl flow tests:\n");
+    all_passed &= RunControlFlowTests();
+    all_passed &= RunCfgWorklistTests();
+    ZYAN_PRINTF("\nOperand lookup tests:\n");
+    all_passed &= RunOperandLookupTests();
+    ZYAN_PRINTF("\n");
+    if (!all_passed)
+    {
+        ZYAN_PRINTF("SOME TESTS FAILED\n");
+        return 1;
+    }
+
+    ZYAN_PRINTF("ALL TESTS PASSED\n");
+    return 0;
+}
+
+/* ============================================================================================== */
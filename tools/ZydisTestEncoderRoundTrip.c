@@ -0,0 +1,706 @@
+/***************************************************************************************************
+
+  Zyan Disassembler Library (Zydis)
+
+  Original Author : Zyantific
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ *
+ * Round-trip test set for `ZydisEncoderReEncodeInstruction`, `ZydisRelocateCode` and related
+ * functions.
+ */
+
+#include <Zycore/LibC.h>
+#include <Zydis/Zydis.h>
+
+/* ============================================================================================== */
+/* Enums and Types                                                                                */
+/* ============================================================================================== */
+
+typedef struct InstructionBytes_
+{
+    const char* name;
+    ZyanU8 bytes[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    ZyanUSize length;
+} InstructionBytes;
+
+typedef struct PatchTest_
+{
+    const char* name;
+    ZyanU8 bytes[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    ZyanUSize length;
+    ZydisEncoderPatch patch;
+    ZyanStatus status;
+    ZyanU8 expected[ZYDIS_MAX_INSTRUCTION_LENGTH];
+    ZyanUSize expected_length;
+} PatchTest;
+
+/* ============================================================================================== */
+/* Helper functions                                                                               */
+/* ============================================================================================== */
+
+static void PrintBytes(const ZyanU8* bytes, ZyanUSize count)
+{
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        ZYAN_PRINTF("%02X ", bytes[i]);
+    }
+}
+
+static ZyanBool CompareOperands(const ZydisDecodedOperand* a, const ZydisDecodedOperand* b,
+    ZyanU8 count)
+{
+    for (ZyanU8 i = 0; i < count; ++i)
+    {
+        if (a[i].type != b[i].type)
+        {
+            return ZYAN_FALSE;
+        }
+        switch (a[i].type)
+        {
+        case ZYDIS_OPERAND_TYPE_REGISTER:
+            if (a[i].reg.value != b[i].reg.value)
+            {
+                return ZYAN_FALSE;
+            }
+            break;
+        case ZYDIS_OPERAND_TYPE_MEMORY:
+            if ((a[i].size != b[i].size) ||
+                (a[i].mem.segment != b[i].mem.segment) ||
+                (a[i].mem.base != b[i].mem.base) ||
+                (a[i].mem.index != b[i].mem.index) ||
+                (a[i].mem.scale != b[i].mem.scale) ||
+                (a[i].mem.disp.value != b[i].mem.disp.value))
+            {
+                return ZYAN_FALSE;
+            }
+            break;
+        case ZYDIS_OPERAND_TYPE_POINTER:
+            if ((a[i].ptr.segment != b[i].ptr.segment) || (a[i].ptr.offset != b[i].ptr.offset))
+            {
+                return ZYAN_FALSE;
+            }
+            break;
+        case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+            if (a[i].imm.value.u != b[i].imm.value.u)
+            {
+                return ZYAN_FALSE;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return ZYAN_TRUE;
+}
+
+static ZyanBool CompareOperandsAbsolute(const ZydisDecodedInstruction* a_instruction,
+    const ZydisDecodedOperand* a, const ZydisDecodedInstruction* b_instruction,
+    const ZydisDecodedOperand* b, ZyanU8 count, ZyanU64 runtime_address)
+{
+    for (ZyanU8 i = 0; i < count; ++i)
+    {
+        if ((a[i].type != ZYDIS_OPERAND_TYPE_MEMORY) ||
+            ((a[i].mem.base != ZYDIS_REGISTER_RIP) && (a[i].mem.base != ZYDIS_REGISTER_EIP)))
+        {
+            if (!CompareOperands(&a[i], &b[i], 1))
+            {
+                return ZYAN_FALSE;
+            }
+            continue;
+        }
+
+        // The displacement of `RIP`-relative operands depends on the instruction length
+        ZydisDecodedOperand a_operand = a[i];
+        ZydisDecodedOperand b_operand = b[i];
+        a_operand.mem.disp.value = 0;
+        b_operand.mem.disp.value = 0;
+        ZyanU64 a_address;
+        ZyanU64 b_address;
+        if (!CompareOperands(&a_operand, &b_operand, 1) ||
+            ZYAN_FAILED(ZydisCalcAbsoluteAddress(a_instruction, &a[i], runtime_address,
+            &a_address)) ||
+            ZYAN_FAILED(ZydisCalcAbsoluteAddress(b_instruction, &b[i], runtime_address,
+            &b_address)) ||
+            (a_address != b_address))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+    return ZYAN_TRUE;
+}
+
+/* ============================================================================================== */
+/* Tests                                                                                          */
+/* ============================================================================================== */
+
+static const InstructionBytes TEST_INSTRUCTIONS[] =
+{
+    { "mov rax, qword ptr [rsp+0x08]", { 0x48, 0x8B, 0x44, 0x24, 0x08 }, 5 },
+    { "mov eax, dword ptr [rbx+0x08]", { 0x8B, 0x43, 0x08 }, 3 },
+    { "add eax, ebx", { 0x01, 0xD8 }, 2 },
+    { "lea esi, dword ptr [0x25022525]", { 0x67, 0x8D, 0x34, 0x25, 0x25, 0x25, 0x02, 0x25 }, 8 },
+    {
+        "lock cmpxchg qword ptr [rip+0x1000], rcx",
+        { 0xF0, 0x48, 0x0F, 0xB1, 0x0D, 0x00, 0x10, 0x00, 0x00 }, 9
+    },
+    { "add dword ptr fs:[rax], 0x12345678", { 0x64, 0x81, 0x00, 0x78, 0x56, 0x34, 0x12 }, 7 },
+    { "jmp qword ptr [r12+rax*8]", { 0x41, 0xFF, 0x24, 0xC4 }, 4 },
+    { "rep movsq", { 0xF3, 0x48, 0xA5 }, 3 },
+    { "jz rel8", { 0x74, 0x10 }, 2 },
+    { "jz rel32", { 0x0F, 0x84, 0x00, 0x01, 0x00, 0x00 }, 6 },
+    { "call rel32", { 0xE8, 0x00, 0x00, 0x00, 0x00 }, 5 },
+    { "vzeroupper", { 0xC5, 0xF8, 0x77 }, 3 },
+    { "vaddps xmm0, xmm1, xmmword ptr [rax+0x10]", { 0xC5, 0xF0, 0x58, 0x40, 0x10 }, 5 },
+    {
+        "vaddps zmm0, zmm0, zmmword ptr [rcx+0x40]",
+        { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x41, 0x01 }, 7
+    },
+    { "lea esi, dword ptr [eip+0x10]", { 0x67, 0x8D, 0x35, 0x10, 0x00, 0x00, 0x00 }, 7 },
+};
+
+static ZyanBool RunReEncodeTests(void)
+{
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(TEST_INSTRUCTIONS); ++i)
+    {
+        const InstructionBytes* test = &TEST_INSTRUCTIONS[i];
+
+        ZydisDecoderContext context;
+        ZydisDecodedInstruction instruction;
+        if (ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, &context, test->bytes,
+            test->length, &instruction)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        // Both a missing patch and a patch without any flags must reproduce the original bytes
+        const ZydisEncoderPatch empty_patch = { 0 };
+        const ZydisEncoderPatch* patches[] = { ZYAN_NULL, &empty_patch };
+        for (ZyanUSize j = 0; j < ZYAN_ARRAY_LENGTH(patches); ++j)
+        {
+            ZyanU8 buffer[ZYDIS_MAX_INSTRUCTION_LENGTH];
+            ZyanUSize length = sizeof(buffer);
+            if (ZYAN_FAILED(ZydisEncoderReEncodeInstruction(&instruction, &context, patches[j],
+                buffer, &length)))
+            {
+                ZYAN_PRINTF("FAILED: %s (re-encoding failed)\n", test->name);
+                all_passed = ZYAN_FALSE;
+                continue;
+            }
+            if ((length != test->length) || ZYAN_MEMCMP(buffer, test->bytes, length))
+            {
+                ZYAN_PRINTF("FAILED: %s (", test->name);
+                PrintBytes(buffer, length);
+                ZYAN_PRINTF("differs from original bytes)\n");
+                all_passed = ZYAN_FALSE;
+            }
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All re-encoding tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunPatchTests(void)
+{
+    static const PatchTest tests[] =
+    {
+        {
+            "mov eax, [rbx+0x08] -> [rbx+0x7F] (in place)",
+            { 0x8B, 0x43, 0x08 }, 3,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x7F, 0, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x8B, 0x43, 0x7F }, 3
+        },
+        {
+            "mov eax, [rbx+0x08] -> [rbx+0x1000] (disp32)",
+            { 0x8B, 0x43, 0x08 }, 3,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x1000, 0, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x8B, 0x83, 0x00, 0x10, 0x00, 0x00 }, 6
+        },
+        {
+            "vaddps zmm0, zmm0, [rcx+0x40] -> [rcx+0x80] (disp8*N)",
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x41, 0x01 }, 7,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x80, 0, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x41, 0x02 }, 7
+        },
+        {
+            "vaddps zmm0, zmm0, [rcx+0x40] -> [rcx+0x44] (not a multiple of N)",
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x41, 0x01 }, 7,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x44, 0, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x81, 0x44, 0x00, 0x00, 0x00 }, 10
+        },
+        {
+            "vaddps zmm0, zmm0, [rcx+0x40] -> [rcx+0x2000] (disp8*N out of range)",
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x41, 0x01 }, 7,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x2000, 0, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x62, 0xF1, 0x7C, 0x48, 0x58, 0x81, 0x00, 0x20, 0x00, 0x00 }, 10
+        },
+        {
+            "add dword ptr fs:[rax], 0x12345678 -> 0x11223344 (in place)",
+            { 0x64, 0x81, 0x00, 0x78, 0x56, 0x34, 0x12 }, 7,
+            { ZYDIS_ENCODER_PATCH_IMMEDIATE, 0, 0, 0x11223344, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x64, 0x81, 0x00, 0x44, 0x33, 0x22, 0x11 }, 7
+        },
+        {
+            "add ebx, 0x10 -> -1 (in place)",
+            { 0x83, 0xC3, 0x10 }, 3,
+            { ZYDIS_ENCODER_PATCH_IMMEDIATE, 0, 0, -1, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x83, 0xC3, 0xFF }, 3
+        },
+        {
+            "add ebx, 0x10 -> 0x1000 (imm32)",
+            { 0x83, 0xC3, 0x10 }, 3,
+            { ZYDIS_ENCODER_PATCH_IMMEDIATE, 0, 0, 0x1000, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0x81, 0xC3, 0x00, 0x10, 0x00, 0x00 }, 6
+        },
+        {
+            "add ebx, 0x10 (no displacement)",
+            { 0x83, 0xC3, 0x10 }, 3,
+            { ZYDIS_ENCODER_PATCH_DISPLACEMENT, 0, 0x10, 0, 0 }, ZYAN_STATUS_INVALID_ARGUMENT,
+            { 0 }, 0
+        },
+        {
+            // The immediate only encodes `XMM3` in its upper half
+            "vblendvps xmm0, xmm1, xmm2, xmm3 (no immediate)",
+            { 0xC4, 0xE3, 0x71, 0x4A, 0xC2, 0x30 }, 6,
+            { ZYDIS_ENCODER_PATCH_IMMEDIATE, 0, 0, 0x01, 0 }, ZYAN_STATUS_INVALID_ARGUMENT,
+            { 0 }, 0
+        },
+        {
+            // The upper half of the immediate encoding `XMM3` has to be preserved
+            "vpermil2ps xmm0, xmm1, xmm2, xmm3, 1 -> 2",
+            { 0xC4, 0xE3, 0x71, 0x48, 0xC2, 0x31 }, 6,
+            { ZYDIS_ENCODER_PATCH_IMMEDIATE, 0, 0, 0x02, 0 }, ZYAN_STATUS_SUCCESS,
+            { 0xC4, 0xE3, 0x71, 0x48, 0xC2, 0x32 }, 6
+        },
+    };
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(tests); ++i)
+    {
+        const PatchTest* test = &tests[i];
+
+        ZydisDecoderContext context;
+        ZydisDecodedInstruction instruction;
+        if (ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, &context, test->bytes,
+            test->length, &instruction)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        ZyanU8 buffer[ZYDIS_MAX_INSTRUCTION_LENGTH];
+        ZyanUSize length = sizeof(buffer);
+        const ZyanStatus status = ZydisEncoderReEncodeInstruction(&instruction, &context,
+            &test->patch, buffer, &length);
+        if (status != test->status)
+        {
+            ZYAN_PRINTF("FAILED: %s (status %08X, expected %08X)\n", test->name, status,
+                test->status);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+        if (ZYAN_SUCCESS(status) &&
+            ((length != test->expected_length) || ZYAN_MEMCMP(buffer, test->expected, length)))
+        {
+            ZYAN_PRINTF("FAILED: %s (", test->name);
+            PrintBytes(buffer, length);
+            ZYAN_PRINTF("differs from expected bytes)\n");
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All patch tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunRelocationTests(void)
+{
+    // Source block at `0x1000`:
+    //   00: jz 0x0D                (internal target)
+    //   02: jnz 0x82               (external target, out of `rel8` range after relocation)
+    //   04: mov rax, [rip+0x100]   (external target)
+    //   0B: nop
+    //   0C: nop
+    //   0D: ret
+    static const ZyanU8 source[] =
+    {
+        0x74, 0x0B,
+        0x75, 0x7E,
+        0x48, 0x8B, 0x05, 0x00, 0x01, 0x00, 0x00,
+        0x90,
+        0x90,
+        0xC3,
+    };
+    static const ZyanU32 source_offsets[] = { 0x00, 0x02, 0x04, 0x0B, 0x0C, 0x0D };
+    static const ZydisMnemonic mnemonics[] =
+    {
+        ZYDIS_MNEMONIC_JZ,
+        ZYDIS_MNEMONIC_JNZ,
+        ZYDIS_MNEMONIC_MOV,
+        ZYDIS_MNEMONIC_NOP,
+        ZYDIS_MNEMONIC_NOP,
+        ZYDIS_MNEMONIC_RET,
+    };
+    const ZyanU64 source_address = 0x1000;
+    const ZyanU64 destination_address = 0x10000000;
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanU8 buffer[128];
+    ZyanUSize length = sizeof(buffer);
+    ZydisRelocationMapEntry map[8];
+    ZyanUSize map_length = ZYAN_ARRAY_LENGTH(map);
+    ZydisRelocationInstruction instructions[4];
+    ZyanUSize instruction_count = ZYAN_ARRAY_LENGTH(instructions);
+    if (ZYAN_FAILED(ZydisRelocateCode(&decoder, source, sizeof(source), source_address,
+        destination_address, buffer, &length, map, &map_length, instructions,
+        &instruction_count)))
+    {
+        ZYAN_PRINTF("FAILED: relocation failed\n");
+        return ZYAN_FALSE;
+    }
+    if ((map_length != ZYAN_ARRAY_LENGTH(source_offsets)) || (instruction_count != 3))
+    {
+        ZYAN_PRINTF("FAILED: unexpected map length %u (%u relative instructions)\n",
+            (ZyanU32)map_length, (ZyanU32)instruction_count);
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+
+    for (ZyanUSize i = 0; i < map_length; ++i)
+    {
+        if (map[i].source_offset != source_offsets[i])
+        {
+            ZYAN_PRINTF("FAILED: map entry %u has source offset %02X\n", (ZyanU32)i,
+                map[i].source_offset);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        const ZyanU64 runtime_address = destination_address + map[i].destination_offset;
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (ZYAN_FAILED(ZydisDecoderDecodeFull(&decoder, buffer + map[i].destination_offset,
+            length - map[i].destination_offset, &instruction, operands)) ||
+            (instruction.mnemonic != mnemonics[i]))
+        {
+            ZYAN_PRINTF("FAILED: unexpected instruction at offset %02X\n",
+                map[i].destination_offset);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        ZyanU64 expected_target;
+        switch (i)
+        {
+        case 0:
+            // Internal targets are redirected to the relocated copy
+            expected_target = destination_address + map[5].destination_offset;
+            break;
+        case 1:
+            if (instruction.raw.imm[0].size != 32)
+            {
+                ZYAN_PRINTF("FAILED: jnz has not been promoted to rel32\n");
+                all_passed = ZYAN_FALSE;
+            }
+            expected_target = source_address + 0x82;
+            break;
+        case 2:
+            expected_target = source_address + 0x0B + 0x100;
+            break;
+        default:
+            continue;
+        }
+
+        const ZyanU8 operand_index = (i == 2) ? 1 : 0;
+        ZyanU64 target;
+        if (ZYAN_FAILED(ZydisCalcAbsoluteAddress(&instruction, &operands[operand_index],
+            runtime_address, &target)) || (target != expected_target))
+        {
+            ZYAN_PRINTF("FAILED: %s references wrong target\n",
+                ZydisMnemonicGetString(instruction.mnemonic));
+            all_passed = ZYAN_FALSE;
+        }
+    }
+
+    // `LOOP` has no `rel32` form, so an external target can't be reached from far away
+    static const ZyanU8 loop_source[] = { 0xE2, 0x10 };
+    ZyanU8 loop_buffer[16];
+    ZyanUSize loop_length = sizeof(loop_buffer);
+    map_length = ZYAN_ARRAY_LENGTH(map);
+    instruction_count = ZYAN_ARRAY_LENGTH(instructions);
+    const ZyanStatus loop_status = ZydisRelocateCode(&decoder, loop_source, sizeof(loop_source),
+        source_address, destination_address, loop_buffer, &loop_length, map, &map_length,
+        instructions, &instruction_count);
+    if (loop_status != ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION)
+    {
+        ZYAN_PRINTF("FAILED: loop out of range returned status %08X\n", loop_status);
+        all_passed = ZYAN_FALSE;
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All relocation tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunSearchModeTests(void)
+{
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    ZyanUSize first_match_total = 0;
+    ZyanUSize shortest_total = 0;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(TEST_INSTRUCTIONS); ++i)
+    {
+        const InstructionBytes* test = &TEST_INSTRUCTIONS[i];
+
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        ZydisEncoderRequest request;
+        if (ZYAN_FAILED(ZydisDecoderDecodeFull(&decoder, test->bytes, test->length,
+            &instruction, operands)) ||
+            ZYAN_FAILED(ZydisEncoderDecodedInstructionToEncoderRequest(&instruction, operands,
+            instruction.operand_count_visible, &request)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        static const ZydisEncoderSearchMode search_modes[] =
+        {
+            ZYDIS_ENCODER_SEARCH_MODE_FIRST_MATCH,
+            ZYDIS_ENCODER_SEARCH_MODE_SHORTEST,
+        };
+        ZyanUSize lengths[ZYAN_ARRAY_LENGTH(search_modes)];
+        ZyanBool passed = ZYAN_TRUE;
+        for (ZyanUSize j = 0; j < ZYAN_ARRAY_LENGTH(search_modes); ++j)
+        {
+            ZyanU8 buffer[ZYDIS_MAX_INSTRUCTION_LENGTH];
+            lengths[j] = sizeof(buffer);
+            request.search_mode = search_modes[j];
+            ZydisDecodedInstruction check;
+            ZydisDecodedOperand check_operands[ZYDIS_MAX_OPERAND_COUNT];
+            if (ZYAN_FAILED(ZydisEncoderEncodeInstruction(&request, buffer, &lengths[j])) ||
+                ZYAN_FAILED(ZydisDecoderDecodeFull(&decoder, buffer, lengths[j], &check,
+                check_operands)) ||
+                (check.mnemonic != instruction.mnemonic) ||
+                !CompareOperands(operands, check_operands, instruction.operand_count_visible))
+            {
+                ZYAN_PRINTF("FAILED: %s (search mode %u does not round-trip)\n", test->name,
+                    (ZyanU32)search_modes[j]);
+                passed = ZYAN_FALSE;
+                break;
+            }
+        }
+        if (!passed)
+        {
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+        if (lengths[1] > lengths[0])
+        {
+            ZYAN_PRINTF("FAILED: %s (shortest: %u bytes, first match: %u bytes)\n", test->name,
+                (ZyanU32)lengths[1], (ZyanU32)lengths[0]);
+            all_passed = ZYAN_FALSE;
+        }
+        first_match_total += lengths[0];
+        shortest_total += lengths[1];
+    }
+
+    ZYAN_PRINTF("First match: %u bytes, shortest: %u bytes\n", (ZyanU32)first_match_total,
+        (ZyanU32)shortest_total);
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All search mode tests passed\n");
+    }
+    return all_passed;
+}
+
+static ZyanBool RunLengthenTests(void)
+{
+    // Indices into `TEST_INSTRUCTIONS` that must be lengthenable by the given amount
+    static const struct
+    {
+        ZyanUSize index;
+        ZyanU8 extra_length;
+    } required[] =
+    {
+        { 0, 3 }, // `disp8` -> `disp32`
+        { 1, 4 }, // `disp8` -> `disp32` + prefix
+        { 2, 1 }, // Redundant `CS` prefix
+        { 5, 2 }, // Repeated `FS` prefix
+        { 4, 1 }, // `CS` prefix, `RIP`-relative displacement shrinks
+        { 4, 3 },
+        { 14, 2 }, // `CS` prefixes, `EIP`-relative displacement shrinks
+    };
+    const ZyanU64 runtime_address = 0x7FFFFFF0;
+
+    ZydisDecoder decoder;
+    if (ZYAN_FAILED(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64,
+        ZYDIS_STACK_WIDTH_64)))
+    {
+        ZYAN_PRINTF("Failed to initialize decoder\n");
+        return ZYAN_FALSE;
+    }
+
+    ZyanBool all_passed = ZYAN_TRUE;
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(TEST_INSTRUCTIONS); ++i)
+    {
+        const InstructionBytes* test = &TEST_INSTRUCTIONS[i];
+
+        ZydisDecoderContext context;
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (ZYAN_FAILED(ZydisDecoderDecodeInstruction(&decoder, &context, test->bytes,
+            test->length, &instruction)) ||
+            ZYAN_FAILED(ZydisDecoderDecodeOperands(&decoder, &context, &instruction, operands,
+            instruction.operand_count)))
+        {
+            ZYAN_PRINTF("FAILED: %s (decoding failed)\n", test->name);
+            all_passed = ZYAN_FALSE;
+            continue;
+        }
+
+        for (ZyanU8 extra_length = 1; extra_length <= 5; ++extra_length)
+        {
+            ZyanBool is_required = ZYAN_FALSE;
+            for (ZyanUSize j = 0; j < ZYAN_ARRAY_LENGTH(required); ++j)
+            {
+                is_required |= (required[j].index == i) &&
+                    (required[j].extra_length == extra_length);
+            }
+
+            ZyanU8 buffer[ZYDIS_MAX_INSTRUCTION_LENGTH];
+            ZyanUSize length = sizeof(buffer);
+            const ZyanStatus status = ZydisEncoderLengthenInstruction(&instruction, &context,
+                extra_length, buffer, &length);
+            if (!ZYAN_SUCCESS(status))
+            {
+                if (is_required || (status != ZYDIS_STATUS_IMPOSSIBLE_INSTRUCTION))
+                {
+                    ZYAN_PRINTF("FAILED: %s (+%u bytes, status %08X)\n", test->name,
+                        extra_length, status);
+                    all_passed = ZYAN_FALSE;
+                }
+                continue;
+            }
+
+            ZydisDecodedInstruction check;
+            ZydisDecodedOperand check_operands[ZYDIS_MAX_OPERAND_COUNT];
+            if ((length != test->length + extra_length) ||
+                ZYAN_FAILED(ZydisDecoderDecodeFull(&decoder, buffer, length, &check,
+                check_operands)) ||
+                (check.length != length) ||
+                (check.mnemonic != instruction.mnemonic) ||
+                (check.operand_count != instruction.operand_count) ||
+                !CompareOperandsAbsolute(&instruction, operands, &check, check_operands,
+                instruction.operand_count, runtime_address))
+            {
+                ZYAN_PRINTF("FAILED: %s (+%u bytes, ", test->name, extra_length);
+                PrintBytes(buffer, length);
+                ZYAN_PRINTF("is not equivalent)\n");
+                all_passed = ZYAN_FALSE;
+            }
+        }
+    }
+
+    if (all_passed)
+    {
+        ZYAN_PRINTF("All lengthening tests passed\n");
+    }
+    return all_passed;
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+int main(void)
+{
+    ZyanBool all_passed = ZYAN_TRUE;
+    ZYAN_PRINTF("Re-encoding tests:\n");
+    all_passed &= RunReEncodeTests();
+    ZYAN_PRINTF("\nPatch tests:\n");
+    all_passed &= RunPatchTests();
+    ZYAN_PRINTF("\nRelocation tests:\n");
+    all_passed &= RunRelocationTests();
+    ZYAN_PRINTF("\nSearch mode tests:\n");
+    all_passed &= RunSearchModeTests();
+    ZYAN_PRINTF("\nLengthening tests:\n");
+    all_passed &= RunLengthenTests();
+    ZYAN_PRINTF("\n");
+    if (!all_passed)
+    {
+        ZYAN_PRINTF("SOME TESTS FAILED\n");
+        return 1;
+    }
+
+    ZYAN_PRINTF("ALL TESTS PASSED\n");
+    return 0;
+}
+
+/* ============================================================================================== */